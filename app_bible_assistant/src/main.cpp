@@ -12,12 +12,14 @@
 #include <util/date.hpp>
 #include <util/incbin.hpp>
 #include <util/log.hpp>
+#include <util/scoped_timer.hpp>
 #include <util/string.hpp>
 
 #include <workflow/workflow_bible_reference_ocr.hpp>
 
 #include <filesystem>
 #include <format>
+#include <string>
 
 INC_RESOURCE(icon, "res/icon.ico");
 const auto icon_view = bibstd::util::incbin::to_span<std::byte>(res_icon_data, res_icon_size);
@@ -27,7 +29,10 @@ const auto icon_view = bibstd::util::incbin::to_span<std::byte>(res_icon_data, r
 ///
 int main()
 {
+  auto startup_timer = bibstd::util::scoped_timer("startup");
+  auto logger_timer = bibstd::util::scoped_timer("startup logger");
   const auto logger = bibstd::util::logger();
+  logger_timer.stop();
   LOG_INFO("executable: {}", bibstd::system::filesystem::executable_location().string());
   LOG_INFO("version: {}", bible_assistant::version::version_string);
   LOG_INFO("commit_hash: {}", bible_assistant::version::commit_hash);
@@ -38,22 +43,45 @@ int main()
     bibstd::workflow::workflow_bible_reference_ocr(bibstd::workflow::workflow_bible_reference_ocr::language::de);
 
   // Init settings
+  auto settings_timer = bibstd::util::scoped_timer("startup settings");
   auto workflow_reference_finder_settings = std::make_shared<bibstd::workflow::workflow_bible_reference_ocr_settings>();
+  settings_timer.stop();
 
   // Start system hotkey manager.
   const auto hotkey_guard = bibstd::system::hotkey::init();
   const auto pool_guard = bibstd::app_framework::thread_pool::init();
 
+  // The OCR engine is initialized in the background, hotkeys pressed before wait for it in the thread pool.
+  const auto warm_up = workflow_reference_finder.warm_up(workflow_reference_finder_settings);
+
   const auto do_on_exit = [&]() { bibstd::app_framework::main_loop::exit(); };
 
   // Start system tray.
+  auto tray_timer = bibstd::util::scoped_timer("startup tray");
   const auto tray_guard = bibstd::system::tray::init(
     bibstd::system::tray::icon_buffer{icon_view},
     {
+      bibstd::system::tray::entry_type{bibstd::system::tray::label{"Loading OCR...", "status"}},
       bibstd::system::tray::entry_type{bibstd::system::tray::button{"Exit", do_on_exit}},
       // ...
     }
   );
+  tray_timer.stop();
+  bibstd::app_framework::thread_pool::queue_task(
+    [warm_up]
+    {
+      auto status = std::string("OCR ready");
+      try
+      {
+        warm_up.get();
+      }
+      catch(const std::exception&)
+      {
+        status = "OCR initialization failed";
+      }
+      bibstd::system::tray::set_label_text("status", std::move(status));
+    }
+  );
 
   // Register hotkeys
   bibstd::system::hotkey::register_callback(
@@ -62,6 +90,8 @@ int main()
     [&]() { workflow_reference_finder.find_references(workflow_reference_finder_settings); }
   );
 
+  startup_timer.stop();
+
   // Enter main loop.
   bibstd::app_framework::main_loop::run();
 
@@ -1,141 +1,654 @@
 #include "app_framework/thread_pool.hpp"
-#include "util/contains.hpp"
+#include "app_framework/work_stealing_deque.hpp"
 #include "util/exception.hpp"
 #include "util/log.hpp"
 
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
 #include <ranges>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace bibstd::app_framework
 {
 
+namespace detail
+{
+
 ///
+/// Queued task. The link is used by the injection list and the strand queues.
 ///
-auto thread_pool::strand_id() -> strand_id_type
+struct task_node final
 {
-  return strand_id_type::new_uid();
+  thread_pool::task_type task{};
+  std::atomic<task_node*> next{nullptr};
+};
+
+///
+/// Run and delete the task of a node. Exceptions are logged, they must not end the worker.
+///
+auto run_task_node(task_node* const node) -> void
+{
+  const auto owned_node = std::unique_ptr<task_node>(node);
+  try
+  {
+    if(owned_node->task)
+    {
+      owned_node->task();
+    }
+  }
+  catch(const std::exception& e)
+  {
+    LOG_ERROR("thread pool task error: {}", e.what());
+  }
+  catch(...)
+  {
+    LOG_ERROR("thread pool task error: {}", "unknown exception");
+  }
 }
 
 ///
+/// Announces a submitter for the lifetime of the object, without allocating like a scoped guard.
 ///
-auto thread_pool::init() -> util::scoped_guard
+class submitter_scope final
 {
-  const auto lock = std::lock_guard(mtx_);
-  initialized_ = true;
-  pool_.emplace_back(std::make_unique<pool_element>());
-  return util::scoped_guard(
-    []()
+public:
+  explicit submitter_scope(std::atomic_size_t& submitters)
+    : submitters_{submitters}
+  {
+    submitters_.fetch_add(1);
+  }
+  submitter_scope(const submitter_scope&) = delete;
+  auto operator=(const submitter_scope&) -> submitter_scope& = delete;
+  ~submitter_scope() { submitters_.fetch_sub(1); }
+
+private:
+  std::atomic_size_t& submitters_;
+};
+
+} // namespace detail
+
+///
+/// Thread pool scheduler. Exists between init and cleanup of the thread pool.
+///
+struct thread_pool::scheduler final
+{
+public: // Constants
+  ///
+  /// Workers are spawned while all workers are busy, since tasks may block until other tasks have finished.
+  ///
+  inline static const std::size_t max_worker_count = std::max<std::size_t>(4 * max_thread_count, 16);
+
+  ///
+  /// Maximum number of tasks a strand runs in a row, before it is scheduled again behind the other tasks.
+  ///
+  static constexpr std::size_t strand_batch_size = 32;
+  static constexpr std::size_t strand_shard_count = 64;
+
+public: // Typedefs
+  using task_node = detail::task_node;
+  using clock_type = std::chrono::steady_clock;
+
+  ///
+  /// Worker. The idle time is set by the worker when it runs out of tasks, other workers read it to request the
+  /// retirement of the last worker.
+  ///
+  struct worker final
+  {
+    static constexpr auto busy = std::numeric_limits<clock_type::rep>::max();
+
+    work_stealing_deque<task_node*> deque{};
+    std::jthread thread{};
+    std::size_t index{};
+    const scheduler* owner{nullptr};
+    std::atomic<clock_type::rep> idle_since{busy};
+    std::atomic_bool retire{false};
+  };
+
+  ///
+  /// Strand, i.e. an intrusive multi producer single consumer queue after Vyukov. The pending count hands over the
+  /// consumer role: the producer queueing the first pending task schedules the strand, and the strand stays scheduled
+  /// until its pending count drops to zero. The consumer pops under the pop mutex, so the scheduler can clear the queue
+  /// on shutdown while a task of the strand is running.
+  ///
+  struct strand final
+  {
+    task_node stub{};
+    std::atomic<task_node*> head{&stub};
+    task_node* tail{&stub};
+    std::atomic_size_t pending{0};
+    std::mutex pop_mtx{};
+    const strand_id_type id;
+
+    explicit strand(const strand_id_type strand_id)
+      : id{strand_id}
+    {
+    }
+    strand(const strand&) = delete;
+    auto operator=(const strand&) -> strand& = delete;
+    ~strand()
     {
+      for(auto node = tail; node != nullptr;)
       {
-        initialized_ = false;
-        // Make sure the lock is not used by anyone else anymore. The shutdown flag ensures,
-        // that the pool_ member is not modified or read from external threads anymore.
-        const auto lock = std::lock_guard(mtx_);
+        const auto next = node->next.load(std::memory_order_relaxed);
+        if(node != &stub)
+        {
+          delete node;
+        }
+        node = next;
       }
-      pool_.clear();
     }
-  );
-}
+
+    auto push(task_node* const node) -> void
+    {
+      node->next.store(nullptr, std::memory_order_relaxed);
+      const auto previous = head.exchange(node, std::memory_order_acq_rel);
+      previous->next.store(node, std::memory_order_release);
+    }
+
+    auto pop() -> task_node*
+    {
+      auto first = tail;
+      auto next = first->next.load(std::memory_order_acquire);
+      if(first == &stub)
+      {
+        if(next == nullptr)
+        {
+          return nullptr;
+        }
+        tail = next;
+        first = next;
+        next = next->next.load(std::memory_order_acquire);
+      }
+      if(next != nullptr)
+      {
+        tail = next;
+        return first;
+      }
+      if(first != head.load(std::memory_order_acquire))
+      {
+        return nullptr;
+      }
+      push(&stub);
+      next = first->next.load(std::memory_order_acquire);
+      if(next != nullptr)
+      {
+        tail = next;
+        return first;
+      }
+      return nullptr;
+    }
+
+    auto clear() -> void
+    {
+      while(const auto node = pop())
+      {
+        delete node;
+      }
+    }
+  };
+
+  struct strand_shard final
+  {
+    std::mutex mtx{};
+    std::unordered_map<strand_id_type, std::unique_ptr<strand>> strands{};
+  };
+
+public: // Structors
+  explicit scheduler(clock_type::duration worker_idle_timeout);
+  scheduler(const scheduler&) = delete;
+  auto operator=(const scheduler&) -> scheduler& = delete;
+  ~scheduler();
+
+public: // Accessors
+  auto worker_count() const -> std::size_t;
+
+public: // Operations
+  auto submit(task_type&& task) -> void;
+  auto submit(task_type&& task, strand_id_type id) -> void;
+
+private: // Implementation
+  auto schedule(task_node* node) -> void;
+  auto schedule_strand(strand& s) -> void;
+  auto run_strand(strand& s) -> void;
+  auto finish_strand_task(strand& s) -> bool;
+  auto find_strand_shard(strand_id_type id) -> strand_shard&;
+  auto find_task(worker& self) -> task_node*;
+  auto run_worker(worker& self) -> void;
+  auto spawn_worker() -> void;
+  auto request_retirement(clock_type::rep now) -> void;
+  auto retire_worker(worker& self) -> bool;
+  auto drop_queued_tasks() -> void;
+
+private: // Variables
+  inline static thread_local worker* current_worker_{nullptr};
+
+  const clock_type::rep worker_idle_timeout_;
+  std::vector<std::unique_ptr<worker>> workers_{};
+  std::atomic_size_t worker_count_{0};
+  std::mutex spawn_mtx_{};
+  alignas(64) std::atomic<task_node*> injected_{nullptr};
+  alignas(64) std::atomic_size_t queued_count_{0};
+  alignas(64) std::atomic_size_t busy_count_{0};
+  alignas(64) std::atomic_size_t idle_count_{0};
+  alignas(64) std::atomic<std::uint64_t> work_epoch_{0};
+  std::atomic_bool stop_{false};
+  std::array<strand_shard, strand_shard_count> strand_shards_{};
+};
 
 ///
+/// All workers are created up front, so thieves can read the deques of the started workers without a lock.
+thread_pool::scheduler::scheduler(const clock_type::duration worker_idle_timeout)
+  : worker_idle_timeout_{worker_idle_timeout.count()}
+{
+  workers_.reserve(max_worker_count);
+  for(std::size_t i = 0; i < max_worker_count; ++i)
+  {
+    workers_.emplace_back(std::make_unique<worker>());
+    workers_.back()->index = i;
+    workers_.back()->owner = this;
+  }
+  spawn_worker();
+}
+
 ///
-auto thread_pool::queue_task(task_type&& task) -> void
+/// Tasks that have not run yet are dropped before the join. A running task waiting for a queued task, e.g. through a guard
+/// or a promise captured by the queued task, is released by the drop and its worker can be joined. Retired workers have
+/// finished their loop and are joined with the worker list.
+thread_pool::scheduler::~scheduler()
 {
-  if(!initialized_)
   {
-    return;
+    // No worker is spawned after the stop, all started workers are joined.
+    const auto lock = std::lock_guard(spawn_mtx_);
+    stop_.store(true);
+  }
+  work_epoch_.fetch_add(1);
+  work_epoch_.notify_all();
+  drop_queued_tasks();
+  const auto count = worker_count_.load();
+  for(std::size_t i = 0; i < count; ++i)
+  {
+    LOG_INFO("thread pool stop thread: id={}", workers_[i]->thread.get_id());
+    workers_[i]->thread.join();
   }
-  const auto lock = std::lock_guard(mtx_);
-  static const auto internal_strand_id = strand_id();
-  queue_task_auto(task_data{std::move(task), task_id_type::new_uid(), internal_strand_id});
+  // Workers taking tasks during the first drop may have queued the rest of the taken tasks.
+  drop_queued_tasks();
 }
 
 ///
 ///
-auto thread_pool::queue_task(task_type&& task, const strand_id_type id) -> void
+auto thread_pool::scheduler::worker_count() const -> std::size_t
+{
+  return worker_count_.load();
+}
+
+///
+///
+auto thread_pool::scheduler::submit(task_type&& task) -> void
 {
-  if(!initialized_)
+  schedule(new task_node{std::move(task)});
+}
+
+///
+/// The task is queued under the shard lock, so the strand is not erased meanwhile. A strand with pending tasks is only
+/// erased by its runner, which is scheduled after the lock is released.
+auto thread_pool::scheduler::submit(task_type&& task, const strand_id_type id) -> void
+{
+  auto node = std::make_unique<task_node>(std::move(task));
+  auto& shard = find_strand_shard(id);
+  auto scheduled = static_cast<strand*>(nullptr);
   {
-    return;
+    const auto lock = std::lock_guard(shard.mtx);
+    auto& s = shard.strands[id];
+    if(!s)
+    {
+      s = std::make_unique<strand>(id);
+    }
+    s->push(node.release());
+    if(s->pending.fetch_add(1, std::memory_order_acq_rel) == 0)
+    {
+      scheduled = s.get();
+    }
   }
-  const auto lock = std::lock_guard(mtx_);
-  const auto dest_thread = std::ranges::find_if(
-    pool_, [&](const auto& e) { return util::contains(e->ids, [id](const auto& p) { return p.strand_id == id; }); }
-  );
-  const auto index = static_cast<std::size_t>(std::ranges::distance(std::ranges::cbegin(pool_), dest_thread));
-  if(index < pool_.size())
+  if(scheduled != nullptr)
   {
-    queue_task_index(task_data{std::move(task), task_id_type::new_uid(), id}, index);
+    schedule_strand(*scheduled);
+  }
+}
+
+///
+/// Tasks of a worker stay on its own deque, so related tasks run on the same worker unless an idle worker steals them.
+auto thread_pool::scheduler::schedule(task_node* const node) -> void
+{
+  queued_count_.fetch_add(1);
+  if(current_worker_ != nullptr && current_worker_->owner == this)
+  {
+    current_worker_->deque.push(node);
   }
   else
   {
-    queue_task_auto(task_data{std::move(task), task_id_type::new_uid(), id});
+    auto head = injected_.load(std::memory_order_relaxed);
+    do
+    {
+      node->next.store(head, std::memory_order_relaxed);
+    } while(!injected_.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+  }
+  if(busy_count_.load() >= worker_count_.load())
+  {
+    spawn_worker();
+  }
+  work_epoch_.fetch_add(1);
+  if(idle_count_.load() > 0)
+  {
+    work_epoch_.notify_one();
   }
 }
 
 ///
 ///
-auto thread_pool::queue_task_index(task_data&& data, const std::size_t index) -> void
+auto thread_pool::scheduler::schedule_strand(strand& s) -> void
 {
-  decltype(auto) element = pool_.at(index);
-  element->ids.emplace_back(id_pair{data.task_id, data.strand_id});
-  element->worker.queue_task(create_task_wrapper(std::move(data), element.get()));
-  remove_abandoned_workers();
+  schedule(new task_node{[this, &s] { run_strand(s); }});
 }
 
 ///
+/// A producer may have swapped the head without linking its node yet, the node is then complete in a moment. After the
+/// stop, the remaining tasks are left to the scheduler, which drops them.
+auto thread_pool::scheduler::run_strand(strand& s) -> void
+{
+  for(std::size_t i = 0; i < strand_batch_size; ++i)
+  {
+    auto node = [&]() -> task_node*
+    {
+      const auto lock = std::lock_guard(s.pop_mtx);
+      if(stop_.load())
+      {
+        return nullptr;
+      }
+      auto result = s.pop();
+      while(result == nullptr)
+      {
+        std::this_thread::yield();
+        result = s.pop();
+      }
+      return result;
+    }();
+    if(node == nullptr)
+    {
+      return;
+    }
+    detail::run_task_node(node);
+    if(finish_strand_task(s))
+    {
+      return;
+    }
+  }
+  schedule_strand(s);
+}
+
 ///
-auto thread_pool::queue_task_auto(task_data&& data) -> void
+/// Only the runner decrements the pending count and producers increment it under the shard lock, so the count drops to
+/// zero under the shard lock. The strand is erased then, a strand ID queueing again gets a new strand.
+auto thread_pool::scheduler::finish_strand_task(strand& s) -> bool
 {
-  const auto iter = std::ranges::find_if(pool_, [&](const auto& e) { return e->ids.empty(); });
-  auto index = static_cast<std::size_t>(std::ranges::distance(std::ranges::cbegin(pool_), iter));
-  if(iter == std::ranges::cend(pool_))
+  if(s.pending.load(std::memory_order_acquire) > 1)
+  {
+    s.pending.fetch_sub(1, std::memory_order_acq_rel);
+    return false;
+  }
+  const auto id = s.id;
+  auto& shard = find_strand_shard(id);
+  const auto lock = std::lock_guard(shard.mtx);
+  if(s.pending.fetch_sub(1, std::memory_order_acq_rel) > 1)
   {
-    pool_.emplace_back(std::make_unique<pool_element>());
-    index = pool_.size() - 1;
+    return false;
   }
-  decltype(auto) element = pool_.at(index);
-  element->ids.emplace_back(id_pair{data.task_id, data.strand_id});
-  element->worker.queue_task(create_task_wrapper(std::move(data), element.get()));
-  remove_abandoned_workers();
+  shard.strands.erase(id);
+  return true;
 }
 
 ///
 ///
-auto thread_pool::create_task_wrapper(task_data&& data, const util::non_owning_ptr<pool_element> element) -> task_type
+auto thread_pool::scheduler::find_strand_shard(const strand_id_type id) -> strand_shard&
+{
+  return strand_shards_[std::hash<strand_id_type>{}(id) % strand_shard_count];
+}
+
+///
+/// A taken injection list is pushed to the own deque with the oldest task on the bottom, which is run first. A steal lost
+/// to another thief is retried, so a worker does not go idle while a blocked worker still holds queued tasks.
+auto thread_pool::scheduler::find_task(worker& self) -> task_node*
 {
-  element->last_use = std::chrono::system_clock::now();
-  return [forwarded_data = std::move(data), element]() mutable
+  if(const auto node = self.deque.pop())
   {
-    // These locks can be called during uninitialized state and the pool will be modified. Since it is ensured that the worker
-    // calling this function will be destroyed before the pool element (including the ids), the destruction is well defined.
-    auto pre_lock = std::unique_lock(mtx_);
-    const auto found = util::contains(element->ids, [&](const auto& p) { return p.task_id == forwarded_data.task_id; });
-    pre_lock.unlock();
-    if(found && forwarded_data.task)
+    return *node;
+  }
+  if(auto node = injected_.exchange(nullptr, std::memory_order_acquire); node != nullptr)
+  {
+    for(auto next = node->next.load(std::memory_order_relaxed); next != nullptr;
+        next = node->next.load(std::memory_order_relaxed))
     {
-      forwarded_data.task();
+      self.deque.push(node);
+      node = next;
     }
-    const auto post_lock = std::lock_guard(mtx_);
-    std::erase_if(element->ids, [&](const auto& p) { return p.task_id == forwarded_data.task_id; });
-  };
+    return node;
+  }
+  const auto count = worker_count_.load(std::memory_order_acquire);
+  for(std::size_t i = 1; i < count; ++i)
+  {
+    auto& victim = *workers_[(self.index + i) % count];
+    while(!victim.deque.empty())
+    {
+      if(const auto node = victim.deque.steal())
+      {
+        return *node;
+      }
+    }
+  }
+  return nullptr;
+}
+
+///
+/// The work epoch is read before searching again, so a task scheduled after the search wakes the worker up. A worker
+/// running out of tasks checks the idle times of the workers, so idle workers are retired while the pool is used.
+auto thread_pool::scheduler::run_worker(worker& self) -> void
+{
+  current_worker_ = &self;
+  while(!stop_.load())
+  {
+    auto node = find_task(self);
+    if(node == nullptr)
+    {
+      const auto epoch = work_epoch_.load();
+      node = find_task(self);
+      if(node == nullptr)
+      {
+        if(stop_.load() || (self.retire.load() && retire_worker(self)))
+        {
+          break;
+        }
+        const auto now = clock_type::now().time_since_epoch().count();
+        if(self.idle_since.load(std::memory_order_relaxed) == worker::busy)
+        {
+          self.idle_since.store(now, std::memory_order_relaxed);
+        }
+        request_retirement(now);
+        idle_count_.fetch_add(1);
+        work_epoch_.wait(epoch);
+        idle_count_.fetch_sub(1);
+        continue;
+      }
+    }
+    self.idle_since.store(worker::busy, std::memory_order_relaxed);
+    queued_count_.fetch_sub(1);
+    if(busy_count_.fetch_add(1) + 1 >= worker_count_.load() && queued_count_.load() > 0)
+    {
+      spawn_worker();
+    }
+    detail::run_task_node(node);
+    busy_count_.fetch_sub(1);
+  }
+  current_worker_ = nullptr;
+}
+
+///
+/// Scheduling and taking tasks check for a spawn after updating their own counter, so one of them sees all workers busy.
+auto thread_pool::scheduler::spawn_worker() -> void
+{
+  const auto lock = std::lock_guard(spawn_mtx_);
+  const auto count = worker_count_.load();
+  if(count >= workers_.size() || busy_count_.load() < count || stop_.load())
+  {
+    return;
+  }
+  auto& w = *workers_[count];
+  w.idle_since.store(worker::busy);
+  w.retire.store(false);
+  // The count includes the worker before it starts, so its steals cover all other workers. The thread of a retired worker
+  // has left its loop, so it is joined right away.
+  worker_count_.store(count + 1, std::memory_order_release);
+  w.thread = std::jthread([this, &w] { run_worker(w); });
+  LOG_INFO("thread pool start thread: id={}, count={}", w.thread.get_id(), count + 1);
+}
+
+///
+/// A worker idle for the timeout is not needed, but the last worker is retired in its place, so the started workers stay
+/// the first ones of the worker list. The idle workers are woken up, so the last one finds its request.
+auto thread_pool::scheduler::request_retirement(const clock_type::rep now) -> void
+{
+  const auto count = worker_count_.load(std::memory_order_acquire);
+  if(count <= 1)
+  {
+    return;
+  }
+  const auto idle = [&](const auto& w) { return now - w->idle_since.load(std::memory_order_relaxed) >= worker_idle_timeout_; };
+  auto& last = *workers_[count - 1];
+  if(std::ranges::any_of(workers_ | std::views::take(count), idle) && !last.retire.exchange(true))
+  {
+    work_epoch_.fetch_add(1);
+    work_epoch_.notify_all();
+  }
+}
+
+///
+/// The request is dropped if the worker ran a task or another worker was spawned since it was requested. The worker count
+/// is lowered before the queued tasks are checked, so a task scheduled meanwhile either keeps the worker or sees the
+/// lowered count and spawns a worker if the others are busy.
+auto thread_pool::scheduler::retire_worker(worker& self) -> bool
+{
+  const auto lock = std::lock_guard(spawn_mtx_);
+  self.retire.store(false);
+  const auto count = worker_count_.load();
+  if(stop_.load() || self.index + 1 != count || self.idle_since.load(std::memory_order_relaxed) == worker::busy ||
+     !self.deque.empty())
+  {
+    return false;
+  }
+  worker_count_.store(count - 1);
+  if(queued_count_.load() > 0)
+  {
+    worker_count_.store(count);
+    return false;
+  }
+  LOG_INFO("thread pool retire thread: id={}, count={}", std::this_thread::get_id(), count - 1);
+  return true;
+}
+
+///
+/// Deleting the nodes destroys the captures of the tasks. The strands are cleared after the queues, so a strand runner
+/// taken from a queue meanwhile finds the stop and leaves its strand to this function.
+auto thread_pool::scheduler::drop_queued_tasks() -> void
+{
+  for(auto node = injected_.exchange(nullptr, std::memory_order_acquire); node != nullptr;)
+  {
+    delete std::exchange(node, node->next.load(std::memory_order_relaxed));
+  }
+  const auto count = worker_count_.load(std::memory_order_acquire);
+  for(std::size_t i = 0; i < count; ++i)
+  {
+    // The owner may still pop from its deque, a failed steal is retried until the deque is empty.
+    while(!workers_[i]->deque.empty())
+    {
+      if(const auto node = workers_[i]->deque.steal())
+      {
+        delete *node;
+      }
+    }
+  }
+  for(auto& shard : strand_shards_)
+  {
+    const auto shard_lock = std::lock_guard(shard.mtx);
+    for(auto& [_, s] : shard.strands)
+    {
+      const auto pop_lock = std::lock_guard(s->pop_mtx);
+      s->clear();
+    }
+  }
 }
 
+std::unique_ptr<thread_pool::scheduler> thread_pool::scheduler_{};
+
 ///
 ///
-auto thread_pool::remove_abandoned_workers() -> void
+auto thread_pool::strand_id() -> strand_id_type
 {
-  using ms = std::chrono::milliseconds;
-  const auto now = std::chrono::system_clock::now();
-  std::erase_if(
-    pool_,
-    [&](const auto& element)
+  return strand_id_type::new_uid();
+}
+
+///
+///
+auto thread_pool::worker_count() -> std::size_t
+{
+  const auto submitter = detail::submitter_scope(submitters_);
+  return initialized_ ? scheduler_->worker_count() : 0;
+}
+
+///
+///
+auto thread_pool::init(const std::chrono::milliseconds worker_idle_timeout) -> util::scoped_guard
+{
+  scheduler_ = std::make_unique<scheduler>(worker_idle_timeout);
+  initialized_ = true;
+  return util::scoped_guard(
+    []()
     {
-      const auto empty_ids = element->ids.empty();
-      const auto inactive_duration = now > element->last_use ? std::chrono::duration_cast<ms>(now - element->last_use) : ms{0};
-      return empty_ids && inactive_duration > std::chrono::minutes{1};
+      initialized_ = false;
+      // Wait until no one submits a task anymore. Submitters check the flag after announcing themselves.
+      while(submitters_.load() > 0)
+      {
+        std::this_thread::yield();
+      }
+      scheduler_.reset();
     }
   );
 }
 
+///
+///
+auto thread_pool::queue_task(task_type&& task) -> void
+{
+  const auto submitter = detail::submitter_scope(submitters_);
+  if(initialized_)
+  {
+    scheduler_->submit(std::move(task));
+  }
+}
+
+///
+///
+auto thread_pool::queue_task(task_type&& task, const strand_id_type id) -> void
+{
+  const auto submitter = detail::submitter_scope(submitters_);
+  if(initialized_)
+  {
+    scheduler_->submit(std::move(task), id);
+  }
+}
+
 } // namespace bibstd::app_framework
@@ -1,8 +1,6 @@
 #pragma once
 
-#include "app_framework/active_worker.hpp"
 #include "app_framework/task_queue.hpp"
-#include "util/non_owning_ptr.hpp"
 #include "util/scoped_guard.hpp"
 #include "util/uid.hpp"
 
@@ -10,18 +8,21 @@
 #include <chrono>
 #include <memory>
 #include <thread>
-#include <vector>
 
 namespace bibstd::app_framework
 {
 
 ///
-/// Static thread_pool class.
+/// Static thread_pool class. Tasks are scheduled on a growing set of workers, each owning a work stealing deque: a task
+/// queued from a worker is pushed to its own deque, tasks of other threads are injected into a shared lock-free list, and
+/// idle workers steal from the deques of busy workers. Strands are serial task queues that are not bound to a worker.
+/// Workers that are idle for the worker idle timeout are retired again, down to a single worker.
 ///
 class thread_pool final
 {
 public: // Constants
   inline static const auto max_thread_count = std::thread::hardware_concurrency();
+  static constexpr auto default_worker_idle_timeout = std::chrono::milliseconds{std::chrono::minutes{1}};
 
 public: // Typedefs
   using task_type = task_queue::task_type;
@@ -34,12 +35,20 @@ public: // Accessors
   ///
   static auto strand_id() -> strand_id_type;
 
+  ///
+  /// Get the number of started workers.
+  /// \return number of workers, 0 if the thread pool is not initialized
+  ///
+  static auto worker_count() -> std::size_t;
+
 public: // Init
   ///
-  /// Init thread pool.
+  /// Init thread pool. Destroying the guard waits for the running tasks, tasks that have not started yet are dropped
+  /// without running them, i.e. only their captures are destroyed.
+  /// \param worker_idle_timeout Time after which an idle worker is retired
   /// \return scoped guard to clean up the object on destruction
   ///
-  static auto init() -> util::scoped_guard;
+  static auto init(std::chrono::milliseconds worker_idle_timeout = default_worker_idle_timeout) -> util::scoped_guard;
 
 public: // Modifiers
   ///
@@ -58,43 +67,12 @@ public: // Modifiers
   static auto queue_task(task_type&& task, strand_id_type id) -> void;
 
 private: // Typedefs
-  using task_id_type = util::uid<struct task_id_tag>;
-
-  struct id_pair final
-  {
-    task_id_type task_id{};
-    strand_id_type strand_id{};
-  };
-
-  ///
-  /// Thread pool element holding IDs and timestamps for bookkeeping.
-  /// \warning On destruction of this struct the worker object has to be destroyed first,
-  /// since it might modify other members of this struct on destruction.
-  ///
-  struct pool_element final
-  {
-    std::vector<id_pair> ids{};
-    std::chrono::system_clock::time_point last_use{std::chrono::system_clock::now()};
-    active_worker worker{};
-  };
-
-  struct task_data final
-  {
-    task_type task{[] {}};
-    task_id_type task_id{};
-    strand_id_type strand_id{};
-  };
-
-private: // Implementation
-  static auto queue_task_index(task_data&& data, std::size_t index) -> void;
-  static auto queue_task_auto(task_data&& data) -> void;
-  static auto create_task_wrapper(task_data&& data, util::non_owning_ptr<pool_element> element) -> task_type;
-  static auto remove_abandoned_workers() -> void;
+  struct scheduler;
 
 private: // Variables
   inline static std::atomic_bool initialized_{false};
-  inline static std::mutex mtx_{};
-  inline static std::vector<std::unique_ptr<pool_element>> pool_{};
+  inline static std::atomic_size_t submitters_{0};
+  static std::unique_ptr<scheduler> scheduler_;
 };
 
 } // namespace bibstd::app_framework
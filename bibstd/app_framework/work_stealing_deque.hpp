@@ -0,0 +1,207 @@
+#pragma once
+
+#include "util/exception.hpp"
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace bibstd::app_framework
+{
+
+///
+/// Work stealing deque after Chase and Lev, with the memory orders of Lê et al., "Correct and Efficient Work-Stealing for
+/// Weak Memory Models". The owner thread pushes and pops items at the bottom without locking, any other thread steals
+/// items from the top. The buffer grows on demand, retired buffers are kept until destruction, since thieves might still
+/// read from them.
+/// \tparam T Item type, which must be trivially copyable, e.g. a pointer
+///
+template<typename T>
+  requires(std::is_trivially_copyable_v<T>)
+class work_stealing_deque final
+{
+public: // Constants
+  static constexpr std::size_t default_capacity = 64;
+
+public: // Structors
+  ///
+  /// Create work stealing deque. Throws std::invalid_argument if the capacity is not a power of two.
+  /// \param capacity Initial capacity
+  ///
+  explicit work_stealing_deque(std::size_t capacity = default_capacity);
+  work_stealing_deque(const work_stealing_deque&) = delete;
+  auto operator=(const work_stealing_deque&) -> work_stealing_deque& = delete;
+
+public: // Accessors
+  ///
+  /// Check if the deque is empty. The result is only a snapshot if other threads modify the deque.
+  /// \return true if empty, false otherwise
+  ///
+  auto empty() const -> bool;
+
+public: // Modifiers
+  ///
+  /// Push an item at the bottom. Must only be called by the owner thread.
+  /// \param item Item that shall be pushed
+  ///
+  auto push(T item) -> void;
+
+  ///
+  /// Pop the item at the bottom. Must only be called by the owner thread.
+  /// \return popped item, std::nullopt if the deque is empty
+  ///
+  auto pop() -> std::optional<T>;
+
+  ///
+  /// Steal the item at the top. Can be called by any thread.
+  /// \return stolen item, std::nullopt if the deque is empty or another thread took the item first
+  ///
+  auto steal() -> std::optional<T>;
+
+private: // Typedefs
+  struct buffer final
+  {
+    explicit buffer(const std::size_t buffer_capacity)
+      : capacity{buffer_capacity}
+      , items{std::make_unique<std::atomic<T>[]>(buffer_capacity)}
+    {
+    }
+    auto load(const std::int64_t index) const -> T
+    {
+      return items[static_cast<std::size_t>(index) & (capacity - 1)].load(std::memory_order_relaxed);
+    }
+    auto store(const std::int64_t index, const T item) -> void
+    {
+      items[static_cast<std::size_t>(index) & (capacity - 1)].store(item, std::memory_order_relaxed);
+    }
+
+    const std::size_t capacity;
+    const std::unique_ptr<std::atomic<T>[]> items;
+  };
+
+private: // Implementation
+  auto grow(const buffer& current, std::int64_t bottom, std::int64_t top) -> buffer*;
+
+private: // Variables
+  alignas(64) std::atomic<std::int64_t> top_{0};
+  alignas(64) std::atomic<std::int64_t> bottom_{0};
+  std::atomic<buffer*> buffer_{nullptr};
+  std::vector<std::unique_ptr<buffer>> buffers_{};
+};
+
+///
+///
+template<typename T>
+  requires(std::is_trivially_copyable_v<T>)
+work_stealing_deque<T>::work_stealing_deque(const std::size_t capacity)
+{
+  if(!std::has_single_bit(capacity))
+  {
+    THROW_EXCEPTION(std::invalid_argument("work stealing deque capacity must be a power of two"));
+  }
+  buffers_.push_back(std::make_unique<buffer>(capacity));
+  buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+}
+
+///
+///
+template<typename T>
+  requires(std::is_trivially_copyable_v<T>)
+auto work_stealing_deque<T>::empty() const -> bool
+{
+  return bottom_.load(std::memory_order_relaxed) <= top_.load(std::memory_order_relaxed);
+}
+
+///
+///
+template<typename T>
+  requires(std::is_trivially_copyable_v<T>)
+auto work_stealing_deque<T>::push(const T item) -> void
+{
+  const auto bottom = bottom_.load(std::memory_order_relaxed);
+  const auto top = top_.load(std::memory_order_acquire);
+  auto current = buffer_.load(std::memory_order_relaxed);
+  if(bottom - top > static_cast<std::int64_t>(current->capacity) - 1)
+  {
+    current = grow(*current, bottom, top);
+  }
+  current->store(bottom, item);
+  std::atomic_thread_fence(std::memory_order_release);
+  bottom_.store(bottom + 1, std::memory_order_relaxed);
+}
+
+///
+/// The owner and a thief compete for the last item with a compare exchange of the top index.
+template<typename T>
+  requires(std::is_trivially_copyable_v<T>)
+auto work_stealing_deque<T>::pop() -> std::optional<T>
+{
+  const auto bottom = bottom_.load(std::memory_order_relaxed) - 1;
+  const auto current = buffer_.load(std::memory_order_relaxed);
+  bottom_.store(bottom, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  auto top = top_.load(std::memory_order_relaxed);
+  auto result = std::optional<T>{};
+  if(top <= bottom)
+  {
+    result = current->load(bottom);
+    if(top == bottom)
+    {
+      if(!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+      {
+        result = std::nullopt;
+      }
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+  }
+  else
+  {
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+  }
+  return result;
+}
+
+///
+///
+template<typename T>
+  requires(std::is_trivially_copyable_v<T>)
+auto work_stealing_deque<T>::steal() -> std::optional<T>
+{
+  auto top = top_.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  const auto bottom = bottom_.load(std::memory_order_acquire);
+  if(top >= bottom)
+  {
+    return std::nullopt;
+  }
+  const auto item = buffer_.load(std::memory_order_acquire)->load(top);
+  if(!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+  {
+    return std::nullopt;
+  }
+  return item;
+}
+
+///
+///
+template<typename T>
+  requires(std::is_trivially_copyable_v<T>)
+auto work_stealing_deque<T>::grow(const buffer& current, const std::int64_t bottom, const std::int64_t top) -> buffer*
+{
+  buffers_.push_back(std::make_unique<buffer>(current.capacity * 2));
+  auto& grown = *buffers_.back();
+  for(auto i = top; i < bottom; ++i)
+  {
+    grown.store(i, current.load(i));
+  }
+  buffer_.store(&grown, std::memory_order_release);
+  return &grown;
+}
+
+} // namespace bibstd::app_framework
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "bible/common.hpp"
+#include "txt/aho_corasick.hpp"
 #include "util/const_bimap.hpp"
 #include "util/enum.hpp"
 #include "util/string.hpp"
@@ -198,6 +199,21 @@ public: // Constants
       return to_array(std::tuple_cat(get.template operator()<I>()...));
     }(std::make_index_sequence<std::tuple_size_v<decltype(name_variants)>>{});
   }();
+
+  ///
+  /// Automaton matching all bible book name variants in one pass.
+  /// The pattern indices of the automaton correspond to the indices of `name_variants_list`.
+  ///
+  static constexpr auto name_variants_automaton = []()
+  {
+    constexpr auto patterns = []()
+    {
+      std::array<std::string_view, name_variants_list.size()> result;
+      std::ranges::transform(name_variants_list, result.begin(), [](const auto& element) { return element.second; });
+      return result;
+    }();
+    return txt::aho_corasick<patterns.size(), txt::aho_corasick_state_capacity(patterns)>(patterns);
+  }();
 };
 
 } // namespace bibstd::bible
@@ -1,7 +1,10 @@
 #pragma once
 
+#include "bible/versification.hpp"
 #include "util/enum.hpp"
+#include "util/exception.hpp"
 
+#include <algorithm>
 #include <cstdint>
 #include <optional>
 
@@ -121,16 +124,19 @@ enum class translation
 };
 
 ///
-/// Number of all the verses in the bible.
+/// Number of all the verses in the bible. The versification follows the German translations, which have one verse more
+/// than the King James Version (3 John 1:15).
 ///
-constexpr auto total_verse_count = std::uint32_t{31102};
+constexpr auto total_verse_count = std::uint32_t{31103};
+static_assert(detail::chapter_verse_offsets.back() == total_verse_count);
+static_assert(detail::book_chapter_counts.size() == static_cast<std::size_t>(util::to_integral(book_id::END)));
 
 ///
 /// Get the count of chapters in a book.
 /// \param book The book to get the chapter count of
 /// \return the chapter count
 ///
-auto chapter_count(book_id book) -> std::uint32_t;
+constexpr auto chapter_count(book_id book) -> std::uint32_t;
 
 ///
 /// Get the count of verses in a chapter.
@@ -138,7 +144,95 @@ auto chapter_count(book_id book) -> std::uint32_t;
 /// \param chapter_number The chapter to get the verse count of
 /// \return the verse count
 ///
-auto verse_count(book_id book, std::uint32_t chapter_number) -> std::optional<std::uint32_t>;
+constexpr auto verse_count(book_id book, std::uint32_t chapter_number) -> std::optional<std::uint32_t>;
+
+///
+/// Position of a verse in the bible.
+///
+struct verse_position final
+{
+  book_id book;
+  std::uint32_t chapter;
+  std::uint32_t verse;
+  constexpr auto operator<=>(const verse_position&) const = default;
+};
+
+///
+/// Get the ordinal of a verse, which is the number of verses in the bible before the verse.
+/// The first verse of genesis has the ordinal 0, the last verse of revelation has the ordinal `total_verse_count - 1`.
+/// \param book The book of the verse
+/// \param chapter_number The chapter of the verse
+/// \param verse_number The verse number
+/// \return the verse ordinal or std::nullopt if the verse does not exist
+///
+constexpr auto verse_ordinal(book_id book, std::uint32_t chapter_number, std::uint32_t verse_number)
+  -> std::optional<std::uint32_t>;
+
+///
+/// Get the verse position of a verse ordinal. \see verse_ordinal
+/// \param ordinal The verse ordinal
+/// \return the verse position or std::nullopt if the ordinal is not smaller than `total_verse_count`
+///
+constexpr auto verse_at(std::uint32_t ordinal) -> std::optional<verse_position>;
+
+///
+///
+constexpr auto chapter_count(const book_id book) -> std::uint32_t
+{
+  if(!util::valid(book))
+  {
+    THROW_EXCEPTION(std::invalid_argument("invalid book"));
+  }
+  return detail::book_chapter_counts[static_cast<std::size_t>(util::to_integral(book))];
+}
+
+///
+///
+constexpr auto verse_count(const book_id book, const std::uint32_t chapter_number) -> std::optional<std::uint32_t>
+{
+  if(chapter_number == 0 || chapter_number > chapter_count(book))
+  {
+    return std::nullopt;
+  }
+  const auto book_index = static_cast<std::size_t>(util::to_integral(book));
+  return detail::chapter_verse_counts[detail::book_chapter_offsets[book_index] + chapter_number - 1];
+}
+
+///
+///
+constexpr auto verse_ordinal(const book_id book, const std::uint32_t chapter_number, const std::uint32_t verse_number)
+  -> std::optional<std::uint32_t>
+{
+  const auto count = verse_count(book, chapter_number);
+  if(!count || verse_number == 0 || verse_number > *count)
+  {
+    return std::nullopt;
+  }
+  const auto book_index = static_cast<std::size_t>(util::to_integral(book));
+  const auto chapter_index = detail::book_chapter_offsets[book_index] + chapter_number - 1;
+  return detail::chapter_verse_offsets[chapter_index] + verse_number - 1;
+}
+
+///
+///
+constexpr auto verse_at(const std::uint32_t ordinal) -> std::optional<verse_position>
+{
+  if(ordinal >= total_verse_count)
+  {
+    return std::nullopt;
+  }
+  // Binary searches over the chapter offsets and the book offsets, both bounded by the fixed versification size.
+  const auto chapter_iter = std::ranges::upper_bound(detail::chapter_verse_offsets, ordinal);
+  const auto chapter_index =
+    static_cast<std::uint32_t>(std::ranges::distance(detail::chapter_verse_offsets.cbegin(), chapter_iter) - 1);
+  const auto book_iter = std::ranges::upper_bound(detail::book_chapter_offsets, chapter_index);
+  const auto book_index = static_cast<std::size_t>(std::ranges::distance(detail::book_chapter_offsets.cbegin(), book_iter) - 1);
+  return verse_position{
+    .book = static_cast<book_id>(book_index),
+    .chapter = chapter_index - detail::book_chapter_offsets[book_index] + 1,
+    .verse = ordinal - detail::chapter_verse_offsets[chapter_index] + 1,
+  };
+}
 
 } // namespace bibstd::bible
 
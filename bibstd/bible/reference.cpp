@@ -3,31 +3,10 @@
 #include "util/exception.hpp"
 #include "util/log.hpp"
 
-namespace bibstd::bible
-{
-
-///
-///
-auto reference::create(book_id book, chapter_type chapter, verse_type verse) -> std::optional<reference>
-{
-  const auto count = verse_count(book, chapter.value);
-  if(verse == verse_type{0} || !count || verse > verse_type{*count})
-  {
-    return std::nullopt;
-  }
-  return reference{book, chapter, verse};
-}
+#include <algorithm>
 
-///
-///
-reference::reference(book_id book, chapter_type chapter, verse_type verse)
-  : book_{book}
-  , chapter_{chapter}
-  , verse_{verse}
-  , chapter_count_{chapter_count(book)}
-  , verse_count_{verse_count(book, chapter.value).value()}
+namespace bibstd::bible
 {
-}
 
 ///
 ///
@@ -65,71 +44,68 @@ auto reference::operator--(int) -> reference
 
 ///
 ///
-auto reference::book() const -> book_id
-{
-  return book_;
-}
-
-///
-///
-auto reference::chapter() const -> chapter_type
+auto reference::advance(const std::int64_t n) const -> reference
 {
-  return chapter_;
+  const auto last = static_cast<std::int64_t>(total_verse_count) - 1;
+  const auto advanced = std::clamp(static_cast<std::int64_t>(ordinal()) + n, std::int64_t{0}, last);
+  return from_ordinal(static_cast<std::uint32_t>(advanced)).value();
 }
 
 ///
 ///
-auto reference::verse() const -> verse_type
+auto distance(const reference& first, const reference& last) -> std::int64_t
 {
-  return verse_;
+  return static_cast<std::int64_t>(last.ordinal()) - static_cast<std::int64_t>(first.ordinal());
 }
 
 ///
 ///
 auto reference::increment() -> void
 {
-  if(verse_ < verse_type{verse_count_})
+  auto book_value = book();
+  auto chapter_value = chapter();
+  auto verse_value = verse();
+  if(verse_value < verse_type{verse_count(book_value, chapter_value.value).value()})
   {
-    verse_ = verse_type{verse_.value + 1};
+    verse_value = verse_type{verse_value.value + 1};
   }
-  else if(chapter_ < chapter_type{chapter_count_})
+  else if(chapter_value < chapter_type{chapter_count(book_value)})
   {
-    chapter_ = chapter_type{chapter_.value + 1};
-    verse_ = verse_type{1};
-    verse_count_ = verse_count(book_, chapter_.value).value();
+    chapter_value = chapter_type{chapter_value.value + 1};
+    verse_value = verse_type{1};
   }
-  else if(util::next(book_) < book_id::END)
+  else if(util::next(book_value) < book_id::END)
   {
-    book_ = util::next(book_);
-    chapter_ = chapter_type{1};
-    verse_ = verse_type{1};
-    chapter_count_ = chapter_count(book_);
-    verse_count_ = verse_count(book_, chapter_.value).value();
+    book_value = util::next(book_value);
+    chapter_value = chapter_type{1};
+    verse_value = verse_type{1};
   }
+  packed_ = pack(book_value, chapter_value, verse_value);
 }
 
 ///
 ///
 auto reference::decrement() -> void
 {
-  if(verse_ > verse_type{1})
+  auto book_value = book();
+  auto chapter_value = chapter();
+  auto verse_value = verse();
+  if(verse_value > verse_type{1})
   {
-    verse_ = verse_type{verse_.value - 1};
+    verse_value = verse_type{verse_value.value - 1};
   }
-  else if(chapter_ > chapter_type{1})
+  else if(chapter_value > chapter_type{1})
   {
-    verse_count_ = verse_count(book_, chapter_.value).value();
-    chapter_ = chapter_type{chapter_.value - 1};
-    verse_ = verse_type{verse_count_};
+    chapter_value = chapter_type{chapter_value.value - 1};
+    verse_value = verse_type{verse_count(book_value, chapter_value.value).value()};
   }
-  else if(book_ > util::next(book_id::BEGIN))
+  else if(book_value > book_id::BEGIN)
   {
-    chapter_count_ = chapter_count(book_);
-    verse_count_ = verse_count(book_, chapter_count_).value();
-    book_ = util::prev(book_);
-    chapter_ = chapter_type{chapter_count_};
-    verse_ = verse_type{verse_count_};
+    book_value = util::prev(book_value);
+    chapter_value = chapter_type{chapter_count(book_value)};
+    verse_value = verse_type{verse_count(book_value, chapter_value.value).value()};
   }
+  packed_ = pack(book_value, chapter_value, verse_value);
 }
 
 } // namespace bibstd::bible
@@ -3,12 +3,15 @@
 #include "bible/common.hpp"
 
 #include <cstdint>
+#include <functional>
+#include <type_traits>
 
 namespace bibstd::bible
 {
 
 ///
 /// Bible reference class. This class contains book name, chapter number and verse number.
+/// The reference is packed into a single 32 bit value, ordered by book, chapter and verse.
 ///
 class reference final
 {
@@ -31,51 +34,197 @@ public: // Static constructor
   /// \param verse_number Verse number
   /// \return bible reference or std::nullopt if not valid
   ///
-  static auto create(book_id book, chapter_type chapter, verse_type verse) -> std::optional<reference>;
+  static constexpr auto create(book_id book, chapter_type chapter, verse_type verse) -> std::optional<reference>;
 
   ///
   /// \see reference::create
   ///
   template<std::unsigned_integral C, std::unsigned_integral V>
-  static auto create(book_id book, C chapter, V verse) -> std::optional<reference>;
+  static constexpr auto create(book_id book, C chapter, V verse) -> std::optional<reference>;
+
+  ///
+  /// Create bible reference from a verse ordinal. \see bible::verse_ordinal
+  /// \param ordinal Verse ordinal
+  /// \return bible reference or std::nullopt if the ordinal is out of range
+  ///
+  static constexpr auto from_ordinal(std::uint32_t ordinal) -> std::optional<reference>;
+
+  ///
+  /// Create bible reference from its packed value. \see reference::packed
+  /// \param packed Packed reference value
+  /// \return bible reference or std::nullopt if the packed value is not a valid reference
+  ///
+  static constexpr auto from_packed(std::uint32_t packed) -> std::optional<reference>;
 
 private: // Constructor
-  reference(book_id book, chapter_type chapter, verse_type verse);
+  constexpr reference(book_id book, chapter_type chapter, verse_type verse);
 
 public: // Operators
-  auto operator<=>(const reference&) const = default;
+  constexpr auto operator<=>(const reference&) const = default;
   auto operator++() & -> reference&; // pre-increment
   auto operator++(int) -> reference; // post-increment
   auto operator--() & -> reference&; // pre-decrement
   auto operator--(int) -> reference; // post-decrement
 
 public: // Accessors
-  auto book() const -> book_id;
-  auto chapter() const -> chapter_type;
-  auto verse() const -> verse_type;
+  constexpr auto book() const -> book_id;
+  constexpr auto chapter() const -> chapter_type;
+  constexpr auto verse() const -> verse_type;
+
+  ///
+  /// Get the packed value of the reference, which is `book << 16 | chapter << 8 | verse`.
+  /// \return packed reference value
+  ///
+  constexpr auto packed() const -> std::uint32_t;
+
+  ///
+  /// Get the verse ordinal of the reference. \see bible::verse_ordinal
+  /// \return verse ordinal
+  ///
+  constexpr auto ordinal() const -> std::uint32_t;
+
+  ///
+  /// Get the reference n verses after this reference, or before if n is negative.
+  /// Like increment and decrement, the result is clamped to the first and the last verse of the bible.
+  /// \param n Number of verses to advance
+  /// \return advanced reference
+  ///
+  auto advance(std::int64_t n) const -> reference;
 
 private: // Implementation
   auto increment() -> void;
   auto decrement() -> void;
 
+private: // Constants
+  static constexpr auto book_shift = 16u;
+  static constexpr auto chapter_shift = 8u;
+  static constexpr auto field_mask = std::uint32_t{0xFF};
+
+private: // Implementation
+  static constexpr auto pack(book_id book, chapter_type chapter, verse_type verse) -> std::uint32_t;
+
 private: // Variables
-  book_id book_;
-  chapter_type chapter_;
-  verse_type verse_;
-  std::uint32_t chapter_count_;
-  std::uint32_t verse_count_;
+  std::uint32_t packed_;
 };
+static_assert(sizeof(reference) == sizeof(std::uint32_t));
+static_assert(std::is_trivially_copyable_v<reference>);
+
+///
+///
+constexpr auto reference::create(const book_id book, const chapter_type chapter, const verse_type verse)
+  -> std::optional<reference>
+{
+  const auto count = verse_count(book, chapter.value);
+  if(verse == verse_type{0} || !count || verse > verse_type{*count})
+  {
+    return std::nullopt;
+  }
+  return reference{book, chapter, verse};
+}
 
 ///
 ///
 template<std::unsigned_integral C, std::unsigned_integral V>
-auto reference::create(const book_id book, const C chapter, const V verse) -> std::optional<reference>
+constexpr auto reference::create(const book_id book, const C chapter, const V verse) -> std::optional<reference>
 {
   return reference::create(book, chapter_type{chapter}, verse_type{verse});
 }
 
+///
+///
+constexpr auto reference::from_ordinal(const std::uint32_t ordinal) -> std::optional<reference>
+{
+  if(const auto position = verse_at(ordinal); position)
+  {
+    return reference{position->book, chapter_type{position->chapter}, verse_type{position->verse}};
+  }
+  return std::nullopt;
+}
+
+///
+///
+constexpr auto reference::from_packed(const std::uint32_t packed) -> std::optional<reference>
+{
+  const auto book_value = packed >> book_shift;
+  if(book_value >= static_cast<std::uint32_t>(util::to_integral(book_id::END)))
+  {
+    return std::nullopt;
+  }
+  return create(
+    static_cast<book_id>(book_value), chapter_type{(packed >> chapter_shift) & field_mask}, verse_type{packed & field_mask}
+  );
+}
+
+///
+///
+constexpr reference::reference(const book_id book, const chapter_type chapter, const verse_type verse)
+  : packed_{pack(book, chapter, verse)}
+{
+}
+
+///
+///
+constexpr auto reference::book() const -> book_id
+{
+  return static_cast<book_id>(packed_ >> book_shift);
+}
+
+///
+///
+constexpr auto reference::chapter() const -> chapter_type
+{
+  return chapter_type{(packed_ >> chapter_shift) & field_mask};
+}
+
+///
+///
+constexpr auto reference::verse() const -> verse_type
+{
+  return verse_type{packed_ & field_mask};
+}
+
+///
+///
+constexpr auto reference::packed() const -> std::uint32_t
+{
+  return packed_;
+}
+
+///
+///
+constexpr auto reference::ordinal() const -> std::uint32_t
+{
+  return verse_ordinal(book(), chapter().value, verse().value).value();
+}
+
+///
+///
+constexpr auto reference::pack(const book_id book, const chapter_type chapter, const verse_type verse) -> std::uint32_t
+{
+  return static_cast<std::uint32_t>(util::to_integral(book)) << book_shift | chapter.value << chapter_shift | verse.value;
+}
+
+///
+/// Get the number of verses from first to last.
+/// \param first First reference
+/// \param last Last reference
+/// \return verse count from first to last, negative if last is before first
+///
+auto distance(const reference& first, const reference& last) -> std::int64_t;
+
 } // namespace bibstd::bible
 
+///
+///
+template<>
+struct std::hash<bibstd::bible::reference>
+{
+  auto operator()(const bibstd::bible::reference& e) const noexcept -> std::size_t
+  {
+    return std::hash<std::uint32_t>{}(e.packed());
+  }
+};
+
 ///
 ///
 template<typename T>
@@ -22,17 +22,10 @@ reference_range::reference_range(reference first, reference second)
 }
 
 ///
-/// TODO: This algorithm is correct but very inefficient.
+///
 auto reference_range::size() const -> std::uint32_t
 {
-  auto temp = from_;
-  auto counter = std::uint32_t{0};
-  while(temp <= to_ && counter <= bible::total_verse_count)
-  {
-    ++counter;
-    ++temp;
-  }
-  return counter;
+  return static_cast<std::uint32_t>(distance(from_, to_)) + 1;
 }
 
 ///
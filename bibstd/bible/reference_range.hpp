@@ -23,7 +23,7 @@ public: // Operators
 
 public: // Accessors
   ///
-  /// Get the size of all references in the range.
+  /// Get the number of verses in the range, computed from the verse ordinals of the first and last reference.
   ///
   auto size() const -> std::uint32_t;
 
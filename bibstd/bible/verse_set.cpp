@@ -0,0 +1,169 @@
+#include "bible/verse_set.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace bibstd::bible
+{
+
+///
+///
+verse_set::verse_set(const std::span<const reference_range> ranges)
+{
+  std::ranges::for_each(ranges, [this](const auto& range) { insert(range); });
+}
+
+///
+///
+auto verse_set::operator|=(const verse_set& rhs) -> verse_set&
+{
+  for(std::size_t i = 0; i < word_count; ++i)
+  {
+    words_[i] |= rhs.words_[i];
+  }
+  return *this;
+}
+
+///
+///
+auto verse_set::operator&=(const verse_set& rhs) -> verse_set&
+{
+  for(std::size_t i = 0; i < word_count; ++i)
+  {
+    words_[i] &= rhs.words_[i];
+  }
+  return *this;
+}
+
+///
+///
+auto verse_set::operator-=(const verse_set& rhs) -> verse_set&
+{
+  for(std::size_t i = 0; i < word_count; ++i)
+  {
+    words_[i] &= ~rhs.words_[i];
+  }
+  return *this;
+}
+
+///
+///
+auto verse_set::contains(const reference& verse) const -> bool
+{
+  const auto ordinal = verse.ordinal();
+  return (words_[ordinal / word_size] >> (ordinal % word_size)) & word_type{1};
+}
+
+///
+///
+auto verse_set::size() const -> std::uint32_t
+{
+  return std::transform_reduce(
+    words_.cbegin(), words_.cend(), std::uint32_t{0}, std::plus<>{}, [](const auto word) { return std::popcount(word); }
+  );
+}
+
+///
+///
+auto verse_set::empty() const -> bool
+{
+  return std::ranges::all_of(words_, [](const auto word) { return word == 0; });
+}
+
+///
+///
+auto verse_set::ranges() const -> std::vector<reference_range>
+{
+  auto result = std::vector<reference_range>{};
+  for(auto first = find_next(0, true); first < total_verse_count;)
+  {
+    const auto end = find_next(first, false);
+    result.emplace_back(reference::from_ordinal(first).value(), reference::from_ordinal(end - 1).value());
+    first = find_next(end, true);
+  }
+  return result;
+}
+
+///
+///
+auto verse_set::insert(const reference& verse) -> void
+{
+  const auto ordinal = verse.ordinal();
+  assign(ordinal, ordinal, true);
+}
+
+///
+///
+auto verse_set::insert(const reference_range& range) -> void
+{
+  assign(range.begin().ordinal(), range.end().ordinal(), true);
+}
+
+///
+///
+auto verse_set::erase(const reference& verse) -> void
+{
+  const auto ordinal = verse.ordinal();
+  assign(ordinal, ordinal, false);
+}
+
+///
+///
+auto verse_set::erase(const reference_range& range) -> void
+{
+  assign(range.begin().ordinal(), range.end().ordinal(), false);
+}
+
+///
+///
+auto verse_set::clear() -> void
+{
+  words_.fill(0);
+}
+
+///
+///
+auto verse_set::assign(const std::uint32_t first_ordinal, const std::uint32_t last_ordinal, const bool value) -> void
+{
+  const auto first_word = first_ordinal / word_size;
+  const auto last_word = last_ordinal / word_size;
+  const auto first_mask = ~word_type{0} << (first_ordinal % word_size);
+  const auto last_mask = ~word_type{0} >> (word_size - 1 - last_ordinal % word_size);
+  const auto apply = [&](const std::size_t i, const word_type mask)
+  {
+    words_[i] = value ? (words_[i] | mask) : (words_[i] & ~mask);
+  };
+  if(first_word == last_word)
+  {
+    apply(first_word, first_mask & last_mask);
+    return;
+  }
+  apply(first_word, first_mask);
+  std::fill(words_.begin() + first_word + 1, words_.begin() + last_word, value ? ~word_type{0} : word_type{0});
+  apply(last_word, last_mask);
+}
+
+///
+///
+auto verse_set::find_next(const std::uint32_t ordinal, const bool value) const -> std::uint32_t
+{
+  // Search for the first set bit in the words, inverted when searching for a cleared bit.
+  const auto word_at = [&](const std::size_t i) { return value ? words_[i] : ~words_[i]; };
+  auto i = std::size_t{ordinal / word_size};
+  if(i >= word_count)
+  {
+    return total_verse_count;
+  }
+  auto word = word_at(i) & (~word_type{0} << (ordinal % word_size));
+  while(word == 0 && ++i < word_count)
+  {
+    word = word_at(i);
+  }
+  if(word == 0)
+  {
+    return total_verse_count;
+  }
+  return std::min(static_cast<std::uint32_t>(i * word_size + std::countr_zero(word)), total_verse_count);
+}
+
+} // namespace bibstd::bible
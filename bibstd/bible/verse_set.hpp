@@ -0,0 +1,135 @@
+#pragma once
+
+#include "bible/reference_range.hpp"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace bibstd::bible
+{
+
+///
+/// Set of bible verses. Every verse of the bible is one bit, indexed by its verse ordinal \see bible::verse_ordinal.
+/// Set operations work word by word over the whole bitset, which the compiler vectorizes.
+///
+class verse_set final
+{
+public: // Typedefs
+  using word_type = std::uint64_t;
+
+public: // Constants
+  static constexpr auto word_size = std::size_t{64};
+  static constexpr auto word_count = (std::size_t{total_verse_count} + word_size - 1) / word_size;
+
+public: // Structors
+  verse_set() = default;
+
+  ///
+  /// Create verse set containing all verses of the reference ranges.
+  /// \param ranges Reference ranges
+  ///
+  explicit verse_set(std::span<const reference_range> ranges);
+
+public: // Operators
+  auto operator==(const verse_set&) const -> bool = default;
+  auto operator|=(const verse_set& rhs) -> verse_set&;
+  auto operator&=(const verse_set& rhs) -> verse_set&;
+  auto operator-=(const verse_set& rhs) -> verse_set&;
+  friend auto operator|(verse_set lhs, const verse_set& rhs) -> verse_set { return lhs |= rhs; }
+  friend auto operator&(verse_set lhs, const verse_set& rhs) -> verse_set { return lhs &= rhs; }
+  friend auto operator-(verse_set lhs, const verse_set& rhs) -> verse_set { return lhs -= rhs; }
+
+public: // Accessors
+  ///
+  /// Check if the verse is in the set.
+  /// \param verse Verse to check
+  /// \return true if the verse is in the set, false otherwise
+  ///
+  auto contains(const reference& verse) const -> bool;
+
+  ///
+  /// Get the number of verses in the set.
+  /// \return verse count
+  ///
+  auto size() const -> std::uint32_t;
+
+  ///
+  /// Check if the set is empty.
+  /// \return true if no verse is in the set, false otherwise
+  ///
+  auto empty() const -> bool;
+
+  ///
+  /// Get the minimal list of reference ranges covering exactly the verses in the set.
+  /// Consecutive verses are merged into one range, even across chapters and books.
+  /// \return reference ranges ordered by their first verse
+  ///
+  auto ranges() const -> std::vector<reference_range>;
+
+  ///
+  /// Calls function for each verse in the set, in bible order.
+  /// \param function Function that is called for each verse
+  ///
+  template<typename Function>
+    requires(std::is_invocable_v<Function, const reference&>)
+  auto for_each(Function&& function) const -> void;
+
+public: // Modifiers
+  ///
+  /// Insert a verse.
+  /// \param verse Verse to insert
+  ///
+  auto insert(const reference& verse) -> void;
+
+  ///
+  /// Insert all verses of a reference range.
+  /// \param range Reference range to insert
+  ///
+  auto insert(const reference_range& range) -> void;
+
+  ///
+  /// Erase a verse.
+  /// \param verse Verse to erase
+  ///
+  auto erase(const reference& verse) -> void;
+
+  ///
+  /// Erase all verses of a reference range.
+  /// \param range Reference range to erase
+  ///
+  auto erase(const reference_range& range) -> void;
+
+  ///
+  /// Erase all verses.
+  ///
+  auto clear() -> void;
+
+private: // Implementation
+  auto assign(std::uint32_t first_ordinal, std::uint32_t last_ordinal, bool value) -> void;
+  auto find_next(std::uint32_t ordinal, bool value) const -> std::uint32_t;
+
+private: // Variables
+  std::array<word_type, word_count> words_{};
+};
+
+///
+///
+template<typename Function>
+  requires(std::is_invocable_v<Function, const reference&>)
+auto verse_set::for_each(Function&& function) const -> void
+{
+  for(std::size_t i = 0; i < words_.size(); ++i)
+  {
+    for(auto word = words_[i]; word != 0; word &= word - 1)
+    {
+      const auto ordinal = static_cast<std::uint32_t>(i * word_size + std::countr_zero(word));
+      function(reference::from_ordinal(ordinal).value());
+    }
+  }
+}
+
+} // namespace bibstd::bible
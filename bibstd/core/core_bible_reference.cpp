@@ -6,11 +6,13 @@
 #include "util/contains.hpp"
 #include "util/format.hpp"
 #include "util/log.hpp"
+#include "util/static_vector.hpp"
 #include "util/string.hpp"
 #include "util/visit_helper.hpp"
 
 #include <algorithm>
 #include <cassert>
+#include <limits>
 #include <map>
 #include <ranges>
 
@@ -20,18 +22,83 @@ namespace detail
 {
 
 ///
-/// Matches a generic_passage_template template section and returns the corresponding reference ranges.
+/// Section of a passage template. The numbers are a view on the numbers of the passage template.
+///
+struct passage_section final
+{
+  std::span<const std::uint32_t> numbers;
+  std::string_view generic_template;
+};
+
+///
+/// Longest generic passage template section which can be matched.
+///
+constexpr auto max_generic_template_size = std::string_view("#X#-#X#").size();
+
+///
+/// Calls function for each passage section of the passage template. Transition chars which are neither '-' nor the down
+/// transition char separate the sections. Sections with a template too long to be matched have an empty template.
+///
+auto for_each_passage_section(
+  const auto& passage_template,
+  const std::span<const std::uint32_t> numbers,
+  const std::optional<char> down_transition_char,
+  auto&& function
+) -> void
+{
+  auto generic_template = util::static_vector<char, max_generic_template_size>{};
+  auto overflow = false;
+  auto numbers_begin = std::size_t{0};
+  auto numbers_end = std::size_t{0};
+  const auto push_template_char = [&](const char c)
+  {
+    if(generic_template.full())
+    {
+      overflow = true;
+      return;
+    }
+    generic_template.push_back(c);
+  };
+  const auto emit_section = [&]()
+  {
+    const auto generic_template_view =
+      overflow ? std::string_view{} : std::string_view{generic_template.data(), generic_template.size()};
+    function(passage_section{.numbers = numbers.subspan(numbers_begin, numbers_end - numbers_begin),
+                             .generic_template = generic_template_view});
+    generic_template.clear();
+    overflow = false;
+    numbers_begin = numbers_end;
+  };
+  const auto handle_uint32_t = [&]([[maybe_unused]] const std::uint32_t n)
+  {
+    ++numbers_end;
+    push_template_char('#');
+  };
+  const auto handle_char = [&](const char c)
+  {
+    if(c == '-') push_template_char('-');
+    else if(c == down_transition_char) push_template_char('X');
+    else emit_section();
+  };
+  std::ranges::for_each(passage_template, [&](const auto e) { util::visit_lambdas(e, handle_uint32_t, handle_char); });
+  emit_section();
+}
+
+///
+/// Matches a generic_passage_template template section and appends the corresponding reference ranges to result.
+/// Returns true if any reference range was appended.
 ///
 auto match_passage_template_section(
   const bible::book_id book,
   const std::span<const std::uint32_t> numbers,
   const std::string_view section,
   auto& current_level,
-  std::uint32_t& current_chapter
-) -> std::vector<bible::reference_range>
+  std::uint32_t& current_chapter,
+  std::vector<bible::reference_range>& result
+) -> bool
 {
   using passage_level = std::remove_reference_t<decltype(current_level)>;
-  auto result = std::vector<bible::reference_range>{};
+  const auto result_size = result.size();
   const auto numbers_size = numbers.size();
   if(std::string_view("#X#-#X#") == section && numbers_size == 4)
   {
@@ -131,7 +198,16 @@ auto match_passage_template_section(
       current_chapter = numbers.front();
     }
   }
-  return result;
+  return result.size() > result_size;
+}
+
+///
+/// Scratch space used by parse calls without caller provided scratch space.
+///
+auto thread_local_parse_scratch() -> core_bible_reference::parse_scratch&
+{
+  thread_local auto scratch = core_bible_reference::parse_scratch{};
+  return scratch;
 }
 
 } // namespace detail
@@ -140,31 +216,133 @@ auto match_passage_template_section(
 ///
 auto core_bible_reference::parse(const std::string_view text, const std::size_t index) const -> parse_result
 {
-  auto book = find_book(text, index);
-  if(!book)
+  return parse(text, index, detail::thread_local_parse_scratch());
+}
+
+///
+///
+auto core_bible_reference::parse(const std::string_view text, const std::size_t index, parse_scratch& scratch) const
+  -> const parse_result&
+{
+  scratch.result_.ranges.clear();
+  scratch.result_.index_range_origin = index_range_type{0, 0};
+  if(const auto book = find_book(text, index, scratch); book)
   {
-    return parse_result{};
-  };
-  return parse_result{
-    .ranges = match_passage_template(
-      book->book_id,
-      create_passage_template(text.substr(book->index_range_numbers.begin, index_range_type::size(book->index_range_numbers)))
-    ),
-    .index_range_origin = index_range_type{book->index_range_book.begin, book->index_range_numbers.end},
-  };
+    create_parse_result(text, book.value(), scratch);
+  }
+  return scratch.result_;
 }
 
 ///
 ///
-auto core_bible_reference::find_book(const std::string_view text, const std::size_t index) const
+auto core_bible_reference::parse_passage(
+  const bible::book_id book, const std::string_view passage_text, parse_scratch& scratch
+) const -> const parse_result&
+{
+  create_passage_template(passage_text, scratch);
+  match_passage_template(book, scratch);
+  scratch.result_.index_range_origin = index_range_type{0, passage_text.size()};
+  return scratch.result_;
+}
+
+///
+///
+auto core_bible_reference::scan(const std::string_view text) const -> std::vector<parse_result>
+{
+  auto scratch = parse_scratch{};
+  auto& books = scratch.books_;
+  normalize_text(text, scratch.normalized_);
+  find_books(scratch.normalized_, books);
+
+  // Overlapping books are resolved like in find_book: The variant listed last wins and for the same variant the first
+  // occurrence wins. Books are therefore accepted in this order if they do not overlap with an already accepted book.
+  std::ranges::sort(
+    books,
+    [](const auto& a, const auto& b)
+    {
+      return a.name_variant_index != b.name_variant_index ? a.name_variant_index > b.name_variant_index
+                                                          : a.index_range_book.begin < b.index_range_book.begin;
+    }
+  );
+  auto accepted = std::map<std::size_t, find_book_result>{};
+  std::ranges::for_each(
+    books,
+    [&](const auto& book)
+    {
+      const auto begin = book.index_range_book.begin;
+      const auto next = accepted.lower_bound(begin);
+      if(next != accepted.cend() && next->first < book.index_range_numbers.end)
+      {
+        return;
+      }
+      if(next != accepted.cbegin() && std::prev(next)->second.index_range_numbers.end > begin)
+      {
+        return;
+      }
+      accepted.emplace_hint(next, begin, book);
+    }
+  );
+
+  auto result = std::vector<parse_result>{};
+  result.reserve(accepted.size());
+  std::ranges::for_each(
+    accepted | std::views::values,
+    [&](const auto& book)
+    {
+      create_parse_result(text, book, scratch);
+      if(!scratch.result_.ranges.empty())
+      {
+        result.push_back(scratch.result_);
+      }
+    }
+  );
+  return result;
+}
+
+///
+///
+auto core_bible_reference::find_book(const std::string_view text, const std::size_t index, parse_scratch& scratch) const
   -> std::optional<find_book_result>
 {
+  normalize_text(text, scratch.normalized_);
+  find_books(scratch.normalized_, scratch.books_);
+
+  // If multiple variants match, the variant listed last wins, because of two reasons:
+  // 1. The common searches match more with the latter book names.
+  // 2. For John and X_John the first match would be taken even if it should be the second one.
+  // If the same variant matches multiple times, the first occurrence wins.
   auto found_book = std::optional<find_book_result>{};
+  const auto contains_index = [&](const auto& book)
+  {
+    const auto origin = index_range_type{book.index_range_book.begin, book.index_range_numbers.end};
+    return math::value_range<std::size_t>::contains(origin, index);
+  };
+  std::ranges::for_each(
+    scratch.books_ | std::views::filter(contains_index),
+    [&](const auto& book)
+    {
+      if(!found_book || book.name_variant_index > found_book->name_variant_index)
+      {
+        found_book = book;
+      }
+    }
+  );
+  return found_book;
+}
 
-  std::string normalized_text;
-  normalized_text.reserve(text.size());
-  std::vector<index_range_type> raw_index_ranges;
-  raw_index_ranges.reserve(text.size());
+///
+///
+auto core_bible_reference::normalize_text(const std::string_view text, normalized_text& result) const -> void
+{
+  using raw_index_range_type = normalized_text::raw_index_range_type;
+  if(text.size() > std::numeric_limits<std::uint32_t>::max())
+  {
+    THROW_EXCEPTION(std::length_error("text too long"));
+  }
+  result.text.clear();
+  result.text.reserve(text.size());
+  result.raw_index_ranges.clear();
+  result.raw_index_ranges.reserve(text.size());
   txt::chars::for_each_char(
     text,
     [&](const auto character, const auto pos, const txt::chars::category category) -> void
@@ -176,9 +354,10 @@ auto core_bible_reference::find_book(const std::string_view text, const std::siz
         {
           return;
         }
-        normalized_text.append(c.data(), size);
-        const auto index_range = index_range_type{pos, pos + size};
-        raw_index_ranges.insert(raw_index_ranges.end(), size, index_range);
+        result.text.append(c.data(), size);
+        const auto begin = static_cast<std::uint32_t>(pos);
+        const auto index_range = raw_index_range_type{begin, static_cast<std::uint32_t>(begin + size)};
+        result.raw_index_ranges.insert(result.raw_index_ranges.end(), size, index_range);
       };
       switch(category)
       {
@@ -191,60 +370,53 @@ auto core_bible_reference::find_book(const std::string_view text, const std::siz
       }
     }
   );
-  assert(raw_index_ranges.size() == normalized_text.size());
+  assert(result.raw_index_ranges.size() == result.text.size());
+}
 
-  // Reverse loop through all the book name variants because of two reasons:
-  // 1. The common searches match more with the latter book names.
-  // 2. For John and X_John the first match would be taken even if it should be the second one.
-  std::ranges::for_each(
-    bible::book_name_variants_de::name_variants_list | std::views::reverse |
-      std::views::take_while([&]([[maybe_unused]] auto&) { return !found_book.has_value(); }),
-    [&](const auto& element)
+///
+///
+auto core_bible_reference::find_books(const normalized_text& normalized, std::vector<find_book_result>& result) const
+  -> void
+{
+  // All book name variants are matched in one pass over the normalized text.
+  result.clear();
+  const auto& raw_index_ranges = normalized.raw_index_ranges;
+  bible::book_name_variants_de::name_variants_automaton.for_each_match(
+    normalized.text,
+    [&](const auto& match)
     {
-      auto normalized_text_view = std::string_view{normalized_text};
-      const auto& [book_id, name_variant] = element;
-
-      auto pos_rel = std::size_t{0};
-      auto pos_offset = std::size_t{0};
-      std::ranges::for_each(
-        std::views::iota(std::size_t{0}, normalized_text_view.size()) |
-          std::views::take_while([&](const auto i) { return pos_rel != std::string_view::npos && !found_book.has_value(); }),
-        [&]([[maybe_unused]] const auto)
-        {
-          pos_rel = normalized_text_view.find(name_variant);
-          if(pos_rel == std::string_view::npos)
-          {
-            return;
-          }
-          const auto pos_name_end = pos_rel + name_variant.size();
-          const auto text_after_pos = normalized_text_view.substr(pos_name_end);
-          if(const auto numbers_end_opt = find_numbers_after_book_name(text_after_pos))
-          {
-            const auto number_end = validate_index_range_numbers_end(text_after_pos, numbers_end_opt.value());
-            const auto pos_abs = pos_offset + pos_rel;
-
-            const auto index_book_begin = raw_index_ranges.at(pos_abs).begin;
-            const auto index_book_end = raw_index_ranges.at(pos_abs + name_variant.size() - 1).end;
-            const auto index_numbers_begin = raw_index_ranges.at(pos_abs + name_variant.size()).begin;
-            const auto index_numbers_end = raw_index_ranges.at(pos_abs + name_variant.size() + number_end - 1).end;
-
-            if(math::value_range<std::size_t>::contains(index_range_type{index_book_begin, index_numbers_end}, index))
-            {
-              found_book = find_book_result{
-                .book_id = book_id,
-                .index_range_book = index_range_type{   index_book_begin,    index_book_end},
-                .index_range_numbers = index_range_type{index_numbers_begin, index_numbers_end},
-                .book_name_variant = name_variant
-              };
-            }
-          }
-          pos_offset += pos_name_end;
-          normalized_text_view = normalized_text_view.substr(pos_name_end);
-        }
-      );
+      const auto& [book_id, name_variant] = bible::book_name_variants_de::name_variants_list.at(match.pattern_index);
+      const auto text_after_pos = std::string_view{normalized.text}.substr(match.end);
+      if(const auto numbers_end_opt = find_numbers_after_book_name(text_after_pos))
+      {
+        const auto number_end = validate_index_range_numbers_end(text_after_pos, numbers_end_opt.value());
+        const auto index_book_begin = raw_index_ranges.at(match.begin).begin;
+        const auto index_book_end = raw_index_ranges.at(match.end - 1).end;
+        const auto index_numbers_begin = raw_index_ranges.at(match.end).begin;
+        const auto index_numbers_end = raw_index_ranges.at(match.end + number_end - 1).end;
+        result.push_back(find_book_result{
+          .book_id = book_id,
+          .index_range_book = index_range_type{   index_book_begin,    index_book_end},
+          .index_range_numbers = index_range_type{index_numbers_begin, index_numbers_end},
+          .book_name_variant = name_variant,
+          .name_variant_index = match.pattern_index
+        });
+      }
     }
   );
-  return found_book;
+}
+
+///
+///
+auto core_bible_reference::create_parse_result(
+  const std::string_view text, const find_book_result& book, parse_scratch& scratch
+) const -> void
+{
+  create_passage_template(
+    text.substr(book.index_range_numbers.begin, index_range_type::size(book.index_range_numbers)), scratch
+  );
+  match_passage_template(book.book_id, scratch);
+  scratch.result_.index_range_origin = index_range_type{book.index_range_book.begin, book.index_range_numbers.end};
 }
 
 ///
@@ -283,15 +455,7 @@ auto core_bible_reference::validate_index_range_numbers_end(
      txt::chars::is_char(text_after_name, numbers_end, txt::chars::category::letter))
   {
     const auto text_from_last_number = text_after_name.substr(numbers_end - 1);
-    const auto belongs_to_book_name = std::ranges::any_of(
-      bible::book_name_variants_de::name_variants_list,
-      [&](const auto& element)
-      {
-        const auto& [_, name_variant] = element;
-        return util::starts_with(text_from_last_number, name_variant);
-      }
-    );
-    if(belongs_to_book_name)
+    if(bible::book_name_variants_de::name_variants_automaton.starts_with_any(text_from_last_number))
     {
       --numbers_end;
     }
@@ -301,10 +465,13 @@ auto core_bible_reference::validate_index_range_numbers_end(
 
 ///
 ///
-auto core_bible_reference::create_passage_template(const std::string_view passage_text) const -> passage_template_type
+auto core_bible_reference::create_passage_template(const std::string_view passage_text, parse_scratch& scratch) const
+  -> void
 {
-  const auto normalized = normalize_passage_text(passage_text);
-  passage_template_type passage_template;
+  normalize_passage_text(passage_text, scratch.passage_text_);
+  const auto& normalized = scratch.passage_text_;
+  auto& passage_template = scratch.passage_template_;
+  passage_template.clear();
   auto passage_substring = std::string_view{normalized};
   auto pos = std::size_t{0};
 
@@ -344,14 +511,13 @@ auto core_bible_reference::create_passage_template(const std::string_view passag
   {
     passage_template.erase(std::next(last), std::ranges::cend(passage_template));
   }
-  return passage_template;
 }
 
 ///
 ///
-auto core_bible_reference::normalize_passage_text(const std::string_view text) const -> std::string
+auto core_bible_reference::normalize_passage_text(const std::string_view text, std::string& normalized_text) const -> void
 {
-  std::string normalized_text;
+  normalized_text.clear();
   auto counter = std::size_t{0};
   std::ranges::for_each(
     std::views::iota(std::size_t{0}, text.size()) | std::views::take_while([&](const auto i) { return counter < text.size(); }),
@@ -382,7 +548,6 @@ auto core_bible_reference::normalize_passage_text(const std::string_view text) c
       }
     }
   );
-  return normalized_text;
 }
 
 ///
@@ -417,99 +582,104 @@ auto core_bible_reference::identify_transition(const std::string_view text, std:
 
 ///
 ///
-auto core_bible_reference::match_passage_template(const bible::book_id book, passage_template_type&& passage_template) const
-  -> std::vector<bible::reference_range>
+auto core_bible_reference::match_passage_template(const bible::book_id book, parse_scratch& scratch) const -> void
 {
   if(!util::valid(book))
   {
     THROW_EXCEPTION(std::invalid_argument{"invalid book ID"});
   }
-  auto result = std::vector<bible::reference_range>{};
+  const auto& passage_template = scratch.passage_template_;
+  auto& result = scratch.result_.ranges;
+  result.clear();
   const auto down_transition_chars = passage_template_transition_chars(passage_template);
-  const auto numbers = passage_template_numbers(passage_template);
+  passage_template_numbers(passage_template, scratch.numbers_);
+  const auto& numbers = scratch.numbers_;
   if(passage_template.empty())
   {
     result.emplace_back(bible::reference_range(bible::reference::create(book, 1u, 1u).value()));
-    return result;
+    return;
   }
   else if(down_transition_chars.empty())
   {
     // This should result to only one passage section either # or #-#.
-    const auto passage_sections = create_passage_sections(passage_template, std::nullopt);
-    if(passage_sections.empty())
-    {
-      return result;
-    }
-    else if(passage_sections.size() > 1)
-    {
-      LOG_ERROR("unexpected passage section detected: count={}, expected=1", passage_sections.size());
-      return result;
-    }
+    auto passage_section_count = std::size_t{0};
     auto current_level = passage_level::chapter;
     auto current_chapter = numbers.front();
-    const auto found = detail::match_passage_template_section(
-      book, passage_sections.front().numbers, passage_sections.front().generic_template, current_level, current_chapter
+    detail::for_each_passage_section(
+      passage_template,
+      numbers,
+      std::nullopt,
+      [&](const auto& passage_section)
+      {
+        if(passage_section_count++ == 0)
+        {
+          detail::match_passage_template_section(
+            book, passage_section.numbers, passage_section.generic_template, current_level, current_chapter, result
+          );
+        }
+      }
     );
-    result.insert(result.cend(), found.cbegin(), found.cend());
-    return result;
+    if(passage_section_count > 1)
+    {
+      LOG_ERROR("unexpected passage section detected: count={}, expected=1", passage_section_count);
+      result.clear();
+    }
+    return;
   }
 
-  std::map<char, std::vector<bible::reference_range>> reference_ranges;
-  for(const auto down_transition_char : down_transition_chars)
+  // Every down transition char is tried and the candidate with the fewest verses is taken.
+  // On equal verse count the smaller down transition char wins.
+  auto best_candidate = std::optional<std::size_t>{};
+  auto best_verse_count = std::uint32_t{0};
+  for(std::size_t i = 0; i < down_transition_chars.size(); ++i)
   {
-    const auto passage_sections = create_passage_sections(passage_template, down_transition_char);
+    const auto down_transition_char = down_transition_chars[i];
+    auto& candidate = scratch.candidates_.at(i);
+    candidate.clear();
+    auto valid = true;
     auto current_level = passage_level::chapter;
     auto current_chapter = numbers.front();
-    std::ranges::all_of(
-      passage_sections,
+    detail::for_each_passage_section(
+      passage_template,
+      numbers,
+      down_transition_char,
       [&](const auto& passage_section)
       {
-        const auto found = detail::match_passage_template_section(
-          book, passage_section.numbers, passage_section.generic_template, current_level, current_chapter
-        );
-        const auto result = !found.empty();
-        if(result)
-        {
-          decltype(auto) ranges = reference_ranges[down_transition_char];
-          ranges.insert(ranges.cend(), found.cbegin(), found.cend());
-        }
-        else
+        if(valid)
         {
-          reference_ranges.erase(down_transition_char);
+          valid = detail::match_passage_template_section(
+            book, passage_section.numbers, passage_section.generic_template, current_level, current_chapter, candidate
+          );
         }
-        return result;
       }
     );
-  }
-
-  auto reference_ranges_view = reference_ranges | std::views::filter([](const auto& p) { return !p.second.empty(); });
-  std::vector<std::pair<char, std::uint32_t>> reference_ranges_verse_count;
-  std::ranges::for_each(
-    reference_ranges_view,
-    [&](const auto& pair)
+    if(!valid)
     {
-      const auto& [c, references] = pair;
-      const auto verse_count = std::ranges::fold_left(
-        references, std::uint32_t{0}, [](std::uint32_t total, const auto& ref) { return total + ref.size(); }
-      );
-      reference_ranges_verse_count.emplace_back(std::pair{c, verse_count});
+      continue;
     }
-  );
-  const auto reference_ranges_iter =
-    std::ranges::min_element(reference_ranges_verse_count, [](const auto& a, const auto& b) { return a.second < b.second; });
-  if(reference_ranges_iter != std::ranges::cend(reference_ranges_verse_count))
+    const auto verse_count = std::ranges::fold_left(
+      candidate, std::uint32_t{0}, [](std::uint32_t total, const auto& ref) { return total + ref.size(); }
+    );
+    if(!best_candidate || verse_count < best_verse_count ||
+       (verse_count == best_verse_count && down_transition_char < down_transition_chars[*best_candidate]))
+    {
+      best_candidate = i;
+      best_verse_count = verse_count;
+    }
+  }
+  if(best_candidate)
   {
-    result = std::move(reference_ranges.at(reference_ranges_iter->first));
+    // Swap instead of move, so both buffers keep their capacity in the scratch space.
+    std::swap(result, scratch.candidates_.at(*best_candidate));
   }
-  return result;
 }
 
 ///
 ///
 auto core_bible_reference::passage_template_transition_chars(const passage_template_type& passage_template) const
-  -> std::vector<char>
+  -> transition_chars_type
 {
-  auto result = std::vector<char>{};
+  auto result = transition_chars_type{};
   std::ranges::for_each(
     passage_template | std::views::filter([](const auto e) { return std::holds_alternative<char>(e); }) |
       std::views::transform([](const auto e) { return std::get<char>(e); }) |
@@ -522,53 +692,16 @@ auto core_bible_reference::passage_template_transition_chars(const passage_templ
 
 ///
 ///
-auto core_bible_reference::passage_template_numbers(const passage_template_type& passage_template) const
-  -> std::vector<std::uint32_t>
+auto core_bible_reference::passage_template_numbers(
+  const passage_template_type& passage_template, std::vector<std::uint32_t>& result
+) const -> void
 {
-  auto result = std::vector<std::uint32_t>{};
+  result.clear();
   std::ranges::for_each(
     passage_template | std::views::filter([](const auto e) { return std::holds_alternative<std::uint32_t>(e); }) |
       std::views::transform([](const auto e) { return std::get<std::uint32_t>(e); }),
     [&](const auto n) { result.push_back(n); }
   );
-  return result;
-}
-
-///
-///
-auto core_bible_reference::create_passage_sections(
-  const passage_template_type& passage_template, const std::optional<char> down_transition_char
-) const -> std::vector<passage_section>
-{
-  const auto to_transition_char = [down_transition_char](const char c) -> std::optional<char>
-  {
-    if(c == '-') return '-';
-    else if(c == down_transition_char) return 'X';
-    else return std::nullopt;
-  };
-
-  std::vector<passage_section> result;
-  passage_section current_result;
-  const auto handle_uint32_t = [&](const std::uint32_t n)
-  {
-    current_result.numbers.push_back(n);
-    current_result.generic_template.push_back('#');
-  };
-  const auto handle_char = [&](const char c)
-  {
-    if(const auto transition_char = to_transition_char(c); transition_char)
-    {
-      current_result.generic_template.push_back(*transition_char);
-    }
-    else
-    {
-      result.emplace_back(std::move(current_result));
-      current_result = passage_section{};
-    }
-  };
-  std::ranges::for_each(passage_template, [&](const auto e) { util::visit_lambdas(e, handle_uint32_t, handle_char); });
-  result.emplace_back(std::move(current_result));
-  return result;
 }
 
 } // namespace bibstd::core
@@ -3,8 +3,11 @@
 #include "bible/reference_range.hpp"
 #include "math/value_range.hpp"
 #include "txt/chars.hpp"
+#include "util/static_vector.hpp"
 
+#include <array>
 #include <optional>
+#include <string>
 #include <string_view>
 #include <variant>
 #include <vector>
@@ -24,6 +27,7 @@ public: // Typedefs
     std::vector<bible::reference_range> ranges{};
     index_range_type index_range_origin{0, 0};
   };
+  class parse_scratch;
 
 public: // Constants
   ///
@@ -61,6 +65,36 @@ public: // Modifiers
   ///
   auto parse(std::string_view text, std::size_t index) const -> parse_result;
 
+  ///
+  /// Parse bible reference from a string view using the given scratch space. This function will only parse a reference
+  /// of a single book. Once the scratch space is warmed up by previous calls, no heap allocations are made.
+  /// \param text String view containing bible references
+  /// \param index Index where the bible reference shall be
+  /// \param scratch Scratch space, which must not be used by multiple threads at the same time
+  /// \return parse result with bible reference ranges and origin text, valid until the next call with the same scratch
+  ///
+  auto parse(std::string_view text, std::size_t index, parse_scratch& scratch) const -> const parse_result&;
+
+  ///
+  /// Parse the passage of a bible reference whose book is already known, e.g. a book name decoded from OCR choices.
+  /// The passage text is read like the text after a book name, an empty passage refers to the first verse of the book.
+  /// \param book Book ID of the bible reference
+  /// \param passage_text String view containing the numbers and transition characters of the passage
+  /// \param scratch Scratch space, which must not be used by multiple threads at the same time
+  /// \return parse result with bible reference ranges and the passage text as origin, valid until the next call with the
+  /// same scratch
+  ///
+  auto parse_passage(bible::book_id book, std::string_view passage_text, parse_scratch& scratch) const
+    -> const parse_result&;
+
+  ///
+  /// Scan a string view for all bible references in one pass. Overlapping book name matches are resolved with the same
+  /// priority as in `parse`, so the reference found by `parse` for an index inside a result is that result.
+  /// \param text String view containing bible references
+  /// \return parse results ordered by their origin text, results without valid reference ranges are dropped
+  ///
+  auto scan(std::string_view text) const -> std::vector<parse_result>;
+
 private: // Typedefs
   using passage_template_value_type = std::variant<std::uint32_t, char>;
   using passage_template_type = std::vector<passage_template_value_type>;
@@ -77,14 +111,22 @@ private: // Typedefs
     math::value_range<std::size_t> index_range_book;
     math::value_range<std::size_t> index_range_numbers;
     std::string_view book_name_variant;
+    std::size_t name_variant_index;
   };
 
-  struct passage_section final
+  ///
+  /// Normalized text with the index range in the original text for each normalized character.
+  /// The index ranges are stored with 32 bit indices to keep the map compact.
+  ///
+  struct normalized_text final
   {
-    std::vector<std::uint32_t> numbers;
-    std::string generic_template;
+    using raw_index_range_type = math::value_range<std::uint32_t>;
+    std::string text;
+    std::vector<raw_index_range_type> raw_index_ranges;
   };
 
+  using transition_chars_type = util::static_vector<char, transition_chars.size()>;
+
 private: // Implementation
   ///
   /// Find the book name in the text at the given index. The book name is identified by the book name variants.
@@ -92,7 +134,30 @@ private: // Implementation
   /// \param index Index where the book name shall be
   /// \return Book name and index range of the book name and numbers or std::nullopt if no book name is found
   ///
-  auto find_book(std::string_view text, std::size_t index) const -> std::optional<find_book_result>;
+  auto find_book(std::string_view text, std::size_t index, parse_scratch& scratch) const -> std::optional<find_book_result>;
+
+  ///
+  /// Normalize the text for the book name search. Whitespaces, lines and full stops are removed,
+  /// all other characters which are neither letters nor digits are replaced by '*'.
+  /// \param text Text to normalize
+  /// \param result Normalized text and the index range in the original text for each normalized character
+  ///
+  auto normalize_text(std::string_view text, normalized_text& result) const -> void;
+
+  ///
+  /// Find all book names followed by numbers in the normalized text. The results can overlap.
+  /// \param normalized Normalized text \see normalize_text
+  /// \param result Book names and index ranges of the book names and numbers ordered by the end of the book name
+  ///
+  auto find_books(const normalized_text& normalized, std::vector<find_book_result>& result) const -> void;
+
+  ///
+  /// Create the parse result for a found book.
+  /// \param text Text in which the book was found
+  /// \param book Found book
+  /// \param scratch Scratch space receiving the parse result
+  ///
+  auto create_parse_result(std::string_view text, const find_book_result& book, parse_scratch& scratch) const -> void;
 
   ///
   /// Find the numbers after the book name that are possibly part of the reference.
@@ -115,16 +180,16 @@ private: // Implementation
   ///
   /// Create a passage template from a string view. The passage template is a vector of numbers and transition characters.
   /// \param passage_text String view from which the passage template is created
-  /// \return Passage template with numbers and transition characters
+  /// \param scratch Scratch space receiving the passage template with numbers and transition characters
   ///
-  auto create_passage_template(std::string_view passage_text) const -> passage_template_type;
+  auto create_passage_template(std::string_view passage_text, parse_scratch& scratch) const -> void;
 
   ///
   /// Normalize the passage text by removing all characters that are not part of the passage template.
   /// \param text String view to normalize
-  /// \return Normalized passage text
+  /// \param result Normalized passage text
   ///
-  auto normalize_passage_text(std::string_view text) const -> std::string;
+  auto normalize_passage_text(std::string_view text, std::string& result) const -> void;
 
   ///
   /// Helper to identify the numbers in the text at the given index.
@@ -145,36 +210,47 @@ private: // Implementation
   auto identify_transition(std::string_view text, std::size_t& pos) const -> std::optional<char>;
 
   ///
-  /// Match a passage template section and return the corresponding reference ranges.
+  /// Match the passage template in the scratch space and return the corresponding reference ranges.
   /// \param book Book ID of the bible reference
-  /// \param passage_template Passage template with numbers and transition characters
-  /// \return Vector of reference ranges matching the passage template section
+  /// \param scratch Scratch space with the passage template, receives the reference ranges in its parse result
   ///
-  auto match_passage_template(bible::book_id book, passage_template_type&& passage_template) const
-    -> std::vector<bible::reference_range>;
+  auto match_passage_template(bible::book_id book, parse_scratch& scratch) const -> void;
 
   ///
   /// Create a list of chars from the passage template.
   /// \param passage_template Passage template with numbers and transition characters
-  /// \return Vector of chars corresponding to the passage template
+  /// \return List of chars corresponding to the passage template
   ///
-  auto passage_template_transition_chars(const passage_template_type& passage_template) const -> std::vector<char>;
+  auto passage_template_transition_chars(const passage_template_type& passage_template) const -> transition_chars_type;
 
   ///
   /// Create a list of numbers from the passage template.
   /// \param passage_template Passage template with numbers and transition characters
-  /// \return Vector of numbers corresponding to the passage template
+  /// \param result Vector of numbers corresponding to the passage template
   ///
-  auto passage_template_numbers(const passage_template_type& passage_template) const -> std::vector<std::uint32_t>;
+  auto passage_template_numbers(const passage_template_type& passage_template, std::vector<std::uint32_t>& result) const
+    -> void;
+};
 
-  ///
-  /// Create a list of passage sections from the passage template.
-  /// \param passage_template Passage template with numbers and transition characters
-  /// \param down_transition_char Transition character to use as separations between the passage sections
-  /// \return Vector of passage sections
-  ///
-  auto create_passage_sections(const passage_template_type& passage_template, std::optional<char> down_transition_char) const
-    -> std::vector<passage_section>;
+///
+/// Scratch space of the bible reference parser. The buffers keep their capacity between parse calls,
+/// so a warmed up scratch space makes parsing allocation free.
+///
+class core_bible_reference::parse_scratch final
+{
+  friend class core_bible_reference;
+
+public: // Structors
+  parse_scratch() = default;
+
+private: // Variables
+  normalized_text normalized_{};
+  std::vector<find_book_result> books_{};
+  std::string passage_text_{};
+  passage_template_type passage_template_{};
+  std::vector<std::uint32_t> numbers_{};
+  std::array<std::vector<bible::reference_range>, transition_chars.size()> candidates_{};
+  parse_result result_{};
 };
 
 } // namespace bibstd::core
@@ -1,29 +1,62 @@
 #include "core/core_bible_reference_ocr.hpp"
 #include "bible/book_name_variants_de.hpp"
+#include "core/core_bible_reference.hpp"
+#include "core/core_ocr_page.hpp"
+#include "core/core_reference_lattice_decoder.hpp"
 #include "core/core_tesseract.hpp"
+#include "data/luma.hpp"
+#include "data/text_region.hpp"
 #include "system/screen.hpp"
 #include "txt/chars.hpp"
+#include "txt/indexed_strings.hpp"
 #include "util/boost_numeric_cast.hpp"
+#include "util/contains.hpp"
+#include "util/exception.hpp"
 #include "util/format.hpp"
 #include "util/log.hpp"
-#include "util/string.hpp"
 
 #include <algorithm>
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
 
 namespace bibstd::core
 {
 
 ///
 ///
-core_bible_reference_ocr::core_bible_reference_ocr(core_tesseract_common::language language)
-  : core_tesseract_{std::make_unique<core::core_tesseract>(language)}
+core_bible_reference_ocr::core_bible_reference_ocr(core_tesseract_pool::lease core_tesseract)
+  : core_tesseract_{std::move(core_tesseract)}
 {
+  if(!core_tesseract_)
+  {
+    THROW_EXCEPTION(std::invalid_argument("core tesseract lease is empty"));
+  }
 }
 
 ///
 ///
 core_bible_reference_ocr::~core_bible_reference_ocr() noexcept = default;
 
+///
+///
+auto core_bible_reference_ocr::model() const -> core_tesseract_common::model
+{
+  return core_tesseract_->traineddata().model;
+}
+
+///
+///
+auto core_bible_reference_ocr::mean_symbol_confidence(const screen_rect_type& area) const -> double
+{
+  return core_tesseract_->page().mean_confidence(core::core_tesseract::text_resolution::character, area);
+}
+
 ///
 ///
 auto core_bible_reference_ocr::generate_capture_areas(
@@ -64,6 +97,85 @@ auto core_bible_reference_ocr::generate_capture_areas(
   return result;
 }
 
+///
+///
+auto core_bible_reference_ocr::estimate_capture_area(
+  const screen_capture& capture, const screen_coordinates_type& cursor_position, const std::uint16_t assumed_char_height
+) const -> std::optional<capture_area_estimate>
+{
+  const auto start = std::chrono::steady_clock::now();
+  const auto search_width = static_cast<std::int32_t>(area_estimation_search_width_multiplier * assumed_char_height);
+  const auto search_height = static_cast<std::int32_t>(area_estimation_search_height_multiplier * assumed_char_height);
+  const auto search_area = screen_rect_type::overlap(
+    capture.area,
+    screen_rect_type(
+      cursor_position - screen_coordinates_type(search_width / 2, search_height / 2), search_width, search_height
+    )
+  );
+  if(!capture.pixels || !search_area || !screen_rect_type::contains(*search_area, cursor_position))
+  {
+    return std::nullopt;
+  }
+  const auto section_origin = search_area->origin() - capture.area.origin();
+  auto luma = data::luma_plane{};
+  data::convert_to_luma(
+    data::plane_view<data::pixel>(
+      *capture.pixels,
+      boost::numeric_cast<std::uint32_t>(section_origin.x()),
+      boost::numeric_cast<std::uint32_t>(section_origin.y()),
+      boost::numeric_cast<std::uint32_t>(search_area->horizontal_range()),
+      boost::numeric_cast<std::uint32_t>(search_area->vertical_range())
+    ),
+    luma
+  );
+  const auto relative_cursor_position = cursor_position - search_area->origin();
+  const auto region = data::find_text_region(
+    luma,
+    relative_cursor_position.x(),
+    relative_cursor_position.y(),
+    area_estimation_line_band_multiplier * assumed_char_height
+  );
+  if(!region)
+  {
+    LOG_DEBUG("no text region found: cursor_position={}, search_area={}", cursor_position, *search_area);
+    return std::nullopt;
+  }
+
+  // The area contains the cursor line with context lines above and below within the paragraph and the margins that are
+  // required by the capture area verification. A paragraph cut off by the search area is extended to the capture border.
+  const auto bottom = [](const auto& rect) { return rect.origin().y() + rect.vertical_range(); };
+  const auto right = [](const auto& rect) { return rect.origin().x() + rect.horizontal_range(); };
+  const auto char_height = static_cast<std::int32_t>(region->char_height);
+  const auto margin = area_estimation_margin_multiplier * char_height;
+  const auto context = area_estimation_context_lines * static_cast<std::int32_t>(region->line_pitch);
+  const auto& paragraph = region->paragraph;
+  const auto left_edge = paragraph.origin().x() <= 0 ? -section_origin.x() : paragraph.origin().x() - margin;
+  const auto right_edge = right(paragraph) >= search_area->horizontal_range()
+                            ? capture.area.horizontal_range() - section_origin.x()
+                            : right(paragraph) + margin;
+  const auto top_edge = std::max(paragraph.origin().y(), region->line.origin().y() - context) - margin;
+  const auto bottom_edge = std::min(bottom(paragraph), bottom(region->line) + context) + margin;
+  const auto capture_area = screen_rect_type::overlap(
+    capture.area,
+    screen_rect_type(
+      search_area->origin() + screen_coordinates_type(left_edge, top_edge), right_edge - left_edge, bottom_edge - top_edge
+    )
+  );
+  LOG_DEBUG(
+    "capture area estimated: capture_area={}, char_height={}, line_pitch={}, line_count={}, elapsed_us={}",
+    capture_area ? std::format("{}", *capture_area) : std::string{"none"},
+    char_height,
+    region->line_pitch,
+    region->line_count,
+    std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count()
+  );
+  if(!capture_area)
+  {
+    return std::nullopt;
+  }
+  return capture_area_estimate{*capture_area, boost::numeric_cast<std::uint16_t>(region->char_height)};
+}
+
 ///
 ///
 auto core_bible_reference_ocr::capture_and_set_ocr_area(const screen_rect_type& screen_area) const -> bool
@@ -79,8 +191,44 @@ auto core_bible_reference_ocr::capture_and_set_ocr_area(const screen_rect_type&
 
 ///
 ///
-auto core_bible_reference_ocr::recognize_paragraph_bounding_box(const screen_coordinates_type& relative_cursor_position) const
-  -> std::optional<screen_rect_type>
+auto core_bible_reference_ocr::capture_screen_area(const screen_rect_type& screen_area) const -> std::optional<screen_capture>
+{
+  auto pixel_plane = std::make_shared<pixel_plane_type>();
+  if(!system::screen::capture(screen_area, *pixel_plane))
+  {
+    return std::nullopt;
+  }
+  return screen_capture{screen_area, std::move(pixel_plane)};
+}
+
+///
+///
+auto core_bible_reference_ocr::set_ocr_area(const screen_capture& capture, const screen_rect_type& screen_area) const -> bool
+{
+  if(!capture.pixels || !screen_rect_type::contains(capture.area, screen_area))
+  {
+    return false;
+  }
+  // The captured pixel rows start at the top left of the captured area, as the screen coordinates.
+  const auto section_origin = screen_area.origin() - capture.area.origin();
+  core_tesseract_->set_image(
+    capture.pixels, screen_rect_type(section_origin, screen_area.horizontal_range(), screen_area.vertical_range())
+  );
+  return true;
+}
+
+///
+///
+auto core_bible_reference_ocr::set_image_preprocessing(const core_tesseract_common::image_preprocessing preprocessing) -> void
+{
+  core_tesseract_->set_image_preprocessing(preprocessing);
+}
+
+///
+///
+auto core_bible_reference_ocr::recognize_paragraph_bounding_box(
+  const screen_coordinates_type& relative_cursor_position, const std::stop_token stop_token
+) const -> std::optional<screen_rect_type>
 {
   const auto bounding_boxes = core_tesseract_->bounding_boxes(core::core_tesseract::text_resolution::paragraph);
   const auto iter = std::ranges::find_if(
@@ -88,28 +236,116 @@ auto core_bible_reference_ocr::recognize_paragraph_bounding_box(const screen_coo
   );
   if(iter != std::ranges::cend(bounding_boxes))
   {
-    return core_tesseract_->recognize(*iter) ? std::make_optional(*iter) : std::nullopt;
+    return core_tesseract_->recognize(*iter, stop_token) ? std::make_optional(*iter) : std::nullopt;
   }
   return std::nullopt;
 }
 
+///
+///
+auto core_bible_reference_ocr::recognize_cursor_lines(
+  const screen_coordinates_type& relative_cursor_position, const std::size_t context_lines, const std::stop_token stop_token
+) const -> std::optional<cursor_lines_recognition>
+{
+  const auto paragraphs = core_tesseract_->layout_paragraphs();
+  const auto paragraph = std::ranges::find_if(
+    paragraphs, [&](const auto& e) { return screen_rect_type::contains(e.bounding_box, relative_cursor_position); }
+  );
+  if(paragraph == std::ranges::cend(paragraphs) || paragraph->line_bounding_boxes.empty())
+  {
+    return std::nullopt;
+  }
+  const auto result = select_cursor_lines(*paragraph, relative_cursor_position, context_lines);
+  LOG_DEBUG(
+    "recognize cursor lines: recognized_area={}, lines_above_skipped={}, lines_below_skipped={}, paragraph_lines={}",
+    result.recognized_area,
+    result.lines_above_skipped,
+    result.lines_below_skipped,
+    paragraph->line_bounding_boxes.size()
+  );
+  if(!core_tesseract_->recognize(result.recognized_area, stop_token))
+  {
+    return std::nullopt;
+  }
+  return result;
+}
+
+///
+/// The cursor might be between two lines, so the vertically closest line is taken as cursor line.
+auto core_bible_reference_ocr::select_cursor_lines(
+  const core_tesseract_common::layout_paragraph& paragraph,
+  const screen_coordinates_type& relative_cursor_position,
+  const std::size_t context_lines
+) -> cursor_lines_recognition
+{
+  const auto& lines = paragraph.line_bounding_boxes;
+  const auto vertical_distance = [&](const auto& line)
+  {
+    const auto top = line.origin().y();
+    const auto bottom = top + line.vertical_range();
+    const auto y = relative_cursor_position.y();
+    return y < top ? top - y : (y > bottom ? y - bottom : 0);
+  };
+  const auto cursor_line =
+    static_cast<std::size_t>(std::ranges::distance(lines.cbegin(), std::ranges::min_element(lines, {}, vertical_distance)));
+  const auto first_line = cursor_line - std::min(cursor_line, context_lines);
+  const auto last_line = std::min(lines.size() - 1, cursor_line + context_lines);
+  const auto recognized_lines = std::span(lines).subspan(first_line, last_line - first_line + 1);
+  const auto top = std::ranges::min(recognized_lines | std::views::transform([](const auto& e) { return e.origin().y(); }));
+  const auto bottom = std::ranges::max(
+    recognized_lines | std::views::transform([](const auto& e) { return e.origin().y() + e.vertical_range(); })
+  );
+  const auto& paragraph_box = paragraph.bounding_box;
+  const auto recognized_area =
+    screen_rect_type({paragraph_box.origin().x(), top}, paragraph_box.horizontal_range(), bottom - top);
+  return cursor_lines_recognition{paragraph_box, recognized_area, first_line > 0, last_line + 1 < lines.size()};
+}
+
+///
+///
+auto core_bible_reference_ocr::recognize_area(const screen_rect_type& area, const std::stop_token stop_token) const -> bool
+{
+  return core_tesseract_->recognize(area, stop_token);
+}
+
+///
+/// A passage may continue after a trailing transition char in the next line, e.g. "Joh 3,16-" followed by "18", while the
+/// parsed range ends before the transition char.
+auto core_bible_reference_ocr::is_reference_cut_off(
+  const cursor_lines_recognition& recognition,
+  const reference_position_data& position_data,
+  const core_bible_reference_ocr_common::index_range_type& index_range
+) -> bool
+{
+  if(core_bible_reference_ocr_common::index_range_type::empty(index_range))
+  {
+    return false;
+  }
+  const auto following_text = std::string_view(position_data.text).substr(std::min(index_range.end, position_data.text.size()));
+  const auto followed_by_transition_chars_only = std::ranges::all_of(
+    following_text, [](const char c) { return util::contains(core_bible_reference::transition_chars, c); }
+  );
+  return (recognition.lines_above_skipped && index_range.begin == 0) ||
+         (recognition.lines_below_skipped && followed_by_transition_chars_only);
+}
+
 ///
 ///
 auto core_bible_reference_ocr::find_main_reference_position_data(const screen_coordinates_type& relative_cursor_position) const
   -> std::optional<reference_position_data>
 {
-  auto text = std::string{};
+  const auto& page = core_tesseract_->page();
+  const auto& symbols = page.elements(core::core_tesseract::text_resolution::character);
+  auto text = std::string(page.text());
   std::vector<character_data> char_data{};
-
-  core_tesseract_->for_each(
-    core::core_tesseract::text_resolution::character,
-    [&](const auto text_character, const auto& bounding_box)
-    {
-      text.append(text_character.data(), text_character.size());
-      const auto abs_distance = std::abs(screen_coordinates_type::distance(bounding_box.center(), relative_cursor_position));
-      char_data.insert(char_data.cend(), text_character.size(), {abs_distance, bounding_box});
-    }
-  );
+  char_data.reserve(text.size());
+  for(core_ocr_page::index_type i = 0; i < symbols.size(); ++i)
+  {
+    const auto& bounding_box = symbols.boxes[i];
+    const auto abs_distance = std::abs(screen_coordinates_type::distance(bounding_box.center(), relative_cursor_position));
+    const auto symbol_size = core_ocr_page::index_range_type::size(symbols.text_ranges[i]);
+    char_data.insert(char_data.cend(), symbol_size, {abs_distance, bounding_box});
+  }
   const auto distance_index = min_distance_index(char_data);
   auto result = std::optional<reference_position_data>{};
   if(distance_index)
@@ -125,50 +361,66 @@ auto core_bible_reference_ocr::find_main_reference_position_data(const screen_co
 }
 
 ///
-///
-auto core_bible_reference_ocr::find_reference_position_data_from_choices(
-  const screen_coordinates_type& relative_cursor_position
-) const -> std::vector<reference_position_data>
+/// The decoded choices replace the main symbols in the text, so the text can be verified like the main text. The main
+/// symbols are the shared base of all decoded references, each reference only keeps its decoded choices.
+auto core_bible_reference_ocr::decode_references_from_choices(
+  const screen_coordinates_type& relative_cursor_position, const std::size_t max_results
+) const -> std::vector<decoded_reference>
 {
-  auto choices_list = std::vector<tesseract_choices>{};
+  const auto& page = core_tesseract_->page();
+  const auto& symbols = page.elements(core::core_tesseract::text_resolution::character);
+  // The choices reference the texts of the page, so no choice text is copied.
+  const auto& choice_arena = page.choice_arena();
   auto choices_char_data = std::vector<character_data>{};
-  core_tesseract_->for_each_choices(
-    [&](const auto& choices, const auto& bounding_box)
-    {
-      choices_list.emplace_back(choices);
-      const auto abs_distance = std::abs(screen_coordinates_type::distance(bounding_box.center(), relative_cursor_position));
-      choices_char_data.emplace_back(abs_distance, bounding_box);
-    }
-  );
-  const auto matching_indexed_strings = match_choices_to_bible_book(
-    choices_list,
-    [&](const auto& choices)
-    {
-      return txt::chars::is_char(choices.front().symbol, 0, txt::chars::category::letter) ||
-             txt::chars::is_char(choices.front().symbol, 0, txt::chars::category::digit);
-    }
-  );
-  assert(choices_list.size() == choices_char_data.size());
-  assert(std::ranges::all_of(matching_indexed_strings, [&](const auto& e) { return e.size() == choices_list.size(); }));
-  auto result = std::vector<reference_position_data>{};
+  choices_char_data.reserve(symbols.size());
+  for(core_ocr_page::index_type i = 0; i < symbols.size(); ++i)
+  {
+    const auto& bounding_box = symbols.boxes[i];
+    const auto abs_distance = std::abs(screen_coordinates_type::distance(bounding_box.center(), relative_cursor_position));
+    choices_char_data.emplace_back(abs_distance, bounding_box);
+  }
+  const auto cursor_symbol_index = min_distance_index(choices_char_data);
+  if(!cursor_symbol_index)
+  {
+    return {};
+  }
+  assert(choice_arena.size() == choices_char_data.size());
+  const auto decode_results = core_reference_lattice_decoder().decode(choice_arena, *cursor_symbol_index, max_results);
+  auto main_strings = txt::indexed_strings{};
+  for(std::size_t i = 0; i < choice_arena.size(); ++i)
+  {
+    const auto choices = choice_arena.symbol_choices(i);
+    main_strings.append_string(choices.empty() ? std::string_view{} : choices.front().symbol);
+  }
+  auto result = std::vector<decoded_reference>{};
   std::ranges::for_each(
-    matching_indexed_strings,
-    [&](const auto& indexed_strings)
+    decode_results,
+    [&](const auto& decode_result)
     {
-      auto text = std::string{};
-      std::vector<character_data> char_data{};
-      std::ranges::for_each(
-        indexed_strings.indexed_chars(),
-        [&](const auto& index_character_pair)
+      const auto& symbol_range = decode_result.symbol_range;
+      auto strings = main_strings;
+      for(auto i = symbol_range.begin; i < symbol_range.end; ++i)
+      {
+        const auto choices = choice_arena.symbol_choices(i);
+        if(!choices.empty())
         {
-          text.push_back(index_character_pair.second);
-          char_data.push_back(choices_char_data.at(index_character_pair.first));
+          strings.overwrite_at(i, choices[decode_result.choice_indices.at(i - symbol_range.begin)].symbol);
         }
-      );
-      const auto distance_index = min_distance_index(char_data);
-      if(distance_index)
+      }
+      auto char_data = std::vector<character_data>{};
+      char_data.reserve(strings.string_offset(strings.size()));
+      for(std::size_t i = 0; i < strings.size(); ++i)
       {
-        result.emplace_back(std::move(text), std::move(char_data), *distance_index);
+        char_data.insert(char_data.cend(), strings.read_at(i).size(), choices_char_data.at(i));
+      }
+      if(const auto distance_index = min_distance_index(char_data); distance_index)
+      {
+        result.push_back(
+          {.position_data = {std::string(strings.joined_string()), std::move(char_data), *distance_index},
+           .ranges = decode_result.ranges,
+           .index_range_origin = {strings.string_offset(symbol_range.begin), strings.string_offset(symbol_range.end)},
+           .confidence = decode_result.confidence}
+        );
       }
     }
   );
@@ -177,11 +429,133 @@ auto core_bible_reference_ocr::find_reference_position_data_from_choices(
     const auto result_range =
       result |
       std::views::transform(
-        [&](const auto& e) { return std::format("(text=\"{}\", cursor_character_index={})", e.text, e.cursor_character_index); }
+        [&](const auto& e)
+        {
+          const auto& origin = e.index_range_origin;
+          return std::format(
+            "(text=\"{}\", references=[{}], confidence={:.1f})",
+            std::string_view(e.position_data.text).substr(origin.begin, index_range_type::size(origin)),
+            util::format::join(e.ranges, ", "),
+            e.confidence
+          );
+        }
       );
     return util::format::join(result_range, ", ");
   };
-  LOG_DEBUG("reference position choices result: [{}], cursor_position={}", format_result(), relative_cursor_position);
+  LOG_DEBUG("decoded references from choices: [{}], cursor_position={}", format_result(), relative_cursor_position);
+  return result;
+}
+
+///
+/// Hypotheses of the same start symbol have read the same number of symbols, so their summed confidences are compared.
+/// The choices of a hypothesis are linked steps, so a hypothesis is copied without its choices.
+auto core_bible_reference_ocr::match_choices_to_bible_book(
+  const tesseract_choice_arena& choice_arena, const std::size_t max_results
+) -> std::vector<txt::indexed_strings>
+{
+  using category = txt::chars::category;
+  const auto& automaton = bible::book_name_variants_de::name_variants_automaton;
+  using state_index_type = std::remove_cvref_t<decltype(automaton)>::state_index_type;
+  static constexpr auto no_step = std::numeric_limits<std::size_t>::max();
+  struct step final
+  {
+    std::size_t symbol_index;
+    std::size_t choice_index;
+    std::size_t previous;
+  };
+  struct hypothesis final
+  {
+    std::size_t start;
+    state_index_type state;
+    double confidence_sum;
+    std::size_t last_step;
+  };
+
+  auto main_strings = txt::indexed_strings{};
+  auto steps = std::vector<step>{};
+  auto active = std::vector<hypothesis>{};
+  auto extended = std::vector<hypothesis>{};
+  auto matches = std::vector<hypothesis>{};
+  for(std::size_t i = 0; i < choice_arena.size(); ++i)
+  {
+    const auto choices = choice_arena.symbol_choices(i);
+    main_strings.append_string(choices.empty() ? std::string_view{} : choices.front().symbol);
+    if(choices.empty() || !(txt::chars::is_char(choices.front().symbol, 0, category::letter) ||
+                            txt::chars::is_char(choices.front().symbol, 0, category::digit)))
+    {
+      continue;
+    }
+    extended.clear();
+    const auto extend = [&](const hypothesis& current)
+    {
+      for(std::size_t c = 0; c < choices.size(); ++c)
+      {
+        const auto state = choices[c].symbol.empty() ? automaton.no_state
+                                                     : automaton.trie_transition(current.state, choices[c].symbol);
+        if(state == automaton.no_state)
+        {
+          continue;
+        }
+        steps.push_back({.symbol_index = i, .choice_index = c, .previous = current.last_step});
+        const auto next = hypothesis{
+          .start = current.start,
+          .state = state,
+          .confidence_sum = current.confidence_sum + choices[c].confidence,
+          .last_step = steps.size() - 1
+        };
+        if(automaton.state_pattern(state) != automaton.no_pattern)
+        {
+          matches.push_back(next);
+        }
+        if(automaton.has_trie_children(state))
+        {
+          extended.push_back(next);
+        }
+      }
+    };
+    std::ranges::for_each(active, extend);
+    extend({.start = i, .state = automaton.root, .confidence_sum = 0.0, .last_step = no_step});
+
+    // Hypotheses of the same start symbol in the same trie state read the same name, so the best one is kept.
+    std::ranges::sort(
+      extended,
+      [](const auto& a, const auto& b)
+      { return std::tie(a.start, a.state, b.confidence_sum) < std::tie(b.start, b.state, a.confidence_sum); }
+    );
+    const auto duplicates =
+      std::ranges::unique(extended, [](const auto& a, const auto& b) { return a.start == b.start && a.state == b.state; });
+    extended.erase(duplicates.begin(), duplicates.end());
+    std::ranges::sort(
+      extended,
+      [](const auto& a, const auto& b) { return std::tie(a.start, b.confidence_sum) < std::tie(b.start, a.confidence_sum); }
+    );
+    active.clear();
+    for(std::size_t e = 0, start_count = 0; e < extended.size(); ++e)
+    {
+      start_count = e > 0 && extended[e - 1].start == extended[e].start ? start_count + 1 : 0;
+      if(start_count < book_name_beam_width)
+      {
+        active.push_back(extended[e]);
+      }
+    }
+  }
+
+  // All results share the main strings, so results with the same overwritten strings are the same text.
+  std::ranges::stable_sort(matches, std::ranges::greater{}, &hypothesis::confidence_sum);
+  auto result = std::vector<txt::indexed_strings>{};
+  for(auto m = matches.cbegin(); m != matches.cend() && result.size() < max_results; ++m)
+  {
+    auto strings = main_strings;
+    for(auto s = m->last_step; s != no_step; s = steps[s].previous)
+    {
+      const auto& [symbol_index, choice_index, _] = steps[s];
+      strings.overwrite_at(symbol_index, choice_arena.symbol_choices(symbol_index)[choice_index].symbol);
+    }
+    if(std::ranges::none_of(result, [&](const auto& e) { return e.overlay() == strings.overlay(); }))
+    {
+      result.push_back(std::move(strings));
+    }
+  }
   return result;
 }
 
@@ -287,98 +661,16 @@ auto core_bible_reference_ocr::is_verified_capture_area(
 
 ///
 ///
-auto core_bible_reference_ocr::match_choices_to_bible_book(
-  const std::vector<tesseract_choices>& choices_list, const std::function<bool(const tesseract_choices&)>& choices_filter
-) const -> std::vector<txt::indexed_strings>
-{
-  auto results_unsorted = std::vector<std::pair<double, txt::indexed_strings>>{};
-  std::ranges::for_each(
-    bible::book_name_variants_de::name_variants_list,
-    [&](const auto& element)
-    {
-      const auto& [_, name_variant] = element;
-      const auto element_result = match_choices_to_string(choices_list, name_variant, choices_filter);
-      results_unsorted.insert(results_unsorted.cend(), element_result.cbegin(), element_result.cend());
-    }
-  );
-  std::ranges::sort(results_unsorted, [&](const auto& a, const auto& b) { return a.first > b.first; });
-  auto results = std::vector<txt::indexed_strings>{};
-  results.reserve(results_unsorted.size());
-  std::ranges::for_each(results_unsorted, [&](auto& e) { results.emplace_back(std::move(e.second)); });
-  return results;
-}
-
-///
-///
-auto core_bible_reference_ocr::match_choices_to_string(
-  const std::vector<tesseract_choices>& choices_list,
-  const std::string_view text_template,
-  const std::function<bool(const tesseract_choices&)>& choices_filter
-) const -> std::vector<std::pair<double, txt::indexed_strings>>
+auto core_bible_reference_ocr::measure_char_height(const screen_coordinates_type& relative_cursor_position) const
+  -> std::optional<std::uint16_t>
 {
-  auto results = std::vector<std::pair<double, txt::indexed_strings>>{};
-  if(!text_template.empty())
+  const auto line_position_data = find_line_position_data(relative_cursor_position);
+  if(!line_position_data)
   {
-    const auto indexed_strings = [&]
-    {
-      auto result = txt::indexed_strings{};
-      std::ranges::for_each(choices_list, [&](const auto& choices) mutable { result.append_string(choices.front().symbol); });
-      return result;
-    }();
-
-    std::ranges::for_each(
-      std::views::iota(decltype(choices_list.size()){0}, choices_list.size()),
-      [&](const auto choices_list_offset) mutable
-      {
-        auto text_template_found = false;
-        auto confidence_value = 0.0;
-        auto local_indexed_strings = indexed_strings;
-        std::ranges::any_of(
-          std::views::iota(choices_list_offset, choices_list.size()) |
-            std::views::filter([&](const auto index) { return choices_filter(choices_list.at(index)); }),
-          [&, text_template_position = std::size_t{0}](const auto choices_list_index) mutable
-          {
-            const auto& choices = choices_list.at(choices_list_index);
-            const auto choice_optional = find_chars_begin_match(choices, text_template.substr(text_template_position));
-            if(choice_optional)
-            {
-              text_template_position += choice_optional->symbol.size();
-              confidence_value += choice_optional->confidence;
-              local_indexed_strings.overwrite_at(choices_list_index, choice_optional->symbol);
-              text_template_found = text_template_position >= text_template.size();
-              return text_template_found;
-            }
-            return true;
-          }
-        );
-        if(text_template_found)
-        {
-          results.emplace_back(confidence_value, std::move(local_indexed_strings));
-        }
-      }
-    );
+    return std::nullopt;
   }
-  return results;
-}
-
-///
-///
-auto core_bible_reference_ocr::find_chars_begin_match(const tesseract_choices& choices, const std::string_view chars) const
-  -> std::optional<tesseract_choice>
-{
-  auto result = std::optional<tesseract_choice>{};
-  std::ranges::for_each(
-    choices,
-    [&](const auto& choice)
-    {
-      auto match_found = util::starts_with(chars, choice.symbol);
-      if(match_found)
-      {
-        result = choice;
-      }
-    }
-  );
-  return result;
+  const auto char_height = line_position_data->line_bounding_boxes.at(line_position_data->cursor_line_index).vertical_range();
+  return char_height > 0 ? std::make_optional(boost::numeric_cast<std::uint16_t>(char_height)) : std::nullopt;
 }
 
 ///
@@ -405,20 +697,16 @@ auto core_bible_reference_ocr::min_distance_index(const std::vector<character_da
 auto core_bible_reference_ocr::find_line_position_data(const screen_coordinates_type& relative_cursor_position) const
   -> std::optional<line_position_data>
 {
-  auto line_bounding_boxes = decltype(line_position_data::line_bounding_boxes){};
+  const auto& lines = core_tesseract_->page().elements(core::core_tesseract::text_resolution::line);
+  auto line_bounding_boxes = lines.boxes;
   auto cursor_line_index = std::optional<std::size_t>{};
-  core_tesseract_->for_each(
-    core::core_tesseract::text_resolution::line,
-    [&]([[maybe_unused]] const auto, const auto& line_bounding_box)
+  for(std::size_t i = 0; i < line_bounding_boxes.size(); ++i)
+  {
+    if(screen_rect_type::contains(line_bounding_boxes[i], relative_cursor_position))
     {
-      line_bounding_boxes.push_back(line_bounding_box);
-      const auto contains_cursor = screen_rect_type::contains(line_bounding_box, relative_cursor_position);
-      if(contains_cursor)
-      {
-        cursor_line_index = line_bounding_boxes.size() - 1;
-      }
+      cursor_line_index = i;
     }
-  );
+  }
   return cursor_line_index ? std::make_optional(line_position_data{std::move(line_bounding_boxes), *cursor_line_index})
                            : std::nullopt;
 }
@@ -3,18 +3,18 @@
 #include "bible/reference_range.hpp"
 #include "core/core_bible_reference_ocr_common.hpp"
 #include "core/core_tesseract_common.hpp"
+#include "core/core_tesseract_pool.hpp"
 #include "math/value_range.hpp"
 #include "txt/indexed_strings.hpp"
 #include "util/screen_types.hpp"
 
 #include <memory>
 #include <optional>
+#include <stop_token>
 #include <string_view>
 
 namespace bibstd::core
 {
-// Forward declarations
-class core_tesseract;
 
 ///
 /// Core bible reference OCR. This class calls contains functions to parse the OCR data for bible references.
@@ -22,18 +22,43 @@ class core_tesseract;
 class core_bible_reference_ocr final
 {
 public: // Typedefs
+  using index_range_type = core_bible_reference_ocr_common::index_range_type;
   using screen_rect_type = util::screen_types::screen_rect_type;
   using screen_coordinates_type = util::screen_types::screen_coordinates_type;
   using pixel_plane_type = util::screen_types::pixel_plane_type;
   using tesseract_choice = core_tesseract_common::tesseract_choice;
   using tesseract_choices = core_tesseract_common::tesseract_choices;
+  using tesseract_choice_arena = core_tesseract_common::tesseract_choice_arena;
   using character_data = core_bible_reference_ocr_common::character_data;
   using reference_position_data = core_bible_reference_ocr_common::reference_position_data;
+  using decoded_reference = core_bible_reference_ocr_common::decoded_reference;
+  using screen_capture = core_bible_reference_ocr_common::screen_capture;
+  using cursor_lines_recognition = core_bible_reference_ocr_common::cursor_lines_recognition;
+  using capture_area_estimate = core_bible_reference_ocr_common::capture_area_estimate;
 
 public: // Structors
-  core_bible_reference_ocr(core_tesseract_common::language language);
+  ///
+  /// Create bible reference OCR on a checked out tesseract engine. The engine is returned to its pool on destruction.
+  /// Throws std::invalid_argument if the lease is empty.
+  /// \param core_tesseract Lease of a tesseract engine
+  ///
+  explicit core_bible_reference_ocr(core_tesseract_pool::lease core_tesseract);
   ~core_bible_reference_ocr() noexcept;
 
+public: // Accessors
+  ///
+  /// Get the model of the tesseract engine used for the recognition.
+  /// \return traineddata model
+  ///
+  auto model() const -> core_tesseract_common::model;
+
+  ///
+  /// Get the mean symbol confidence of the last recognition within an area of the image.
+  /// \param area Area of the image, e.g. the paragraph at the cursor
+  /// \return mean confidence in the range [0, 100], 0 if nothing was recognized in the area
+  ///
+  auto mean_symbol_confidence(const screen_rect_type& area) const -> double;
+
 public: // Operations
   ///
   /// Generate a list of rectangles that are used to capture the screen for OCR.
@@ -46,6 +71,18 @@ public: // Operations
   auto generate_capture_areas(const screen_coordinates_type& cursor_position, std::uint16_t assumed_char_height) const
     -> std::vector<screen_rect_type>;
 
+  ///
+  /// Estimate a single capture area from the text layout around the cursor in a screen capture. The layout is found with
+  /// projection profiles of the luma values, which takes about a millisecond, so no OCR is needed to size the area.
+  /// \param capture Screen capture containing the cursor position
+  /// \param cursor_position Cursor position on the screen
+  /// \param assumed_char_height Assumed character height, it defines the size of the searched area around the cursor
+  /// \return capture area estimate, std::nullopt if no text line is found at the cursor position
+  ///
+  [[nodiscard]] auto estimate_capture_area(
+    const screen_capture& capture, const screen_coordinates_type& cursor_position, std::uint16_t assumed_char_height
+  ) const -> std::optional<capture_area_estimate>;
+
   ///
   /// Capture an area of the screen and set as OCR recognition image.
   /// \param screen_area Area of the screen that shall be captured
@@ -53,15 +90,87 @@ public: // Operations
   ///
   [[nodiscard]] auto capture_and_set_ocr_area(const screen_rect_type& screen_area) const -> bool;
 
+  ///
+  /// Capture an area of the screen, such that all areas within can be set as OCR recognition image without capturing again.
+  /// \param screen_area Area of the screen that shall be captured
+  /// \return screen capture if capturing was successful, std::nullopt otherwise
+  ///
+  [[nodiscard]] auto capture_screen_area(const screen_rect_type& screen_area) const -> std::optional<screen_capture>;
+
+  ///
+  /// Set an area of a screen capture as OCR recognition image. The area is cut out of the capture without capturing it again.
+  /// \param capture Screen capture containing the area
+  /// \param screen_area Area of the screen that shall be recognized
+  /// \return true if the area is within the captured area and was set, false otherwise
+  ///
+  [[nodiscard]] auto set_ocr_area(const screen_capture& capture, const screen_rect_type& screen_area) const -> bool;
+
+  ///
+  /// Set the preprocessing that is applied to the OCR areas set afterwards.
+  /// \param preprocessing Image preprocessing
+  ///
+  auto set_image_preprocessing(core_tesseract_common::image_preprocessing preprocessing) -> void;
+
   ///
   /// Find the bounding box of the paragraph containing the given cursor position.
   /// If no paragraph is found at the specified position, returns std::nullopt.
   /// \param relative_cursor_position The position of the cursor on the screen in the image.
+  /// \param stop_token Optional stop token that cancels the recognition
   /// \return An optional screen rectangle representing the bounding box of the paragraph.
-  /// If no paragraph is found, returns std::nullopt.
+  /// If no paragraph is found or the recognition was cancelled, returns std::nullopt.
+  ///
+  [[nodiscard]] auto recognize_paragraph_bounding_box(
+    const screen_coordinates_type& relative_cursor_position, std::stop_token stop_token = {}
+  ) const -> std::optional<screen_rect_type>;
+
+  ///
+  /// Recognize only the text line containing the cursor and the given number of lines above and below within its
+  /// paragraph. The lines are found by the layout analysis, which is much faster than the recognition of the paragraph.
+  /// \param relative_cursor_position The position of the cursor on the screen in the image.
+  /// \param context_lines Number of lines recognized above and below the cursor line
+  /// \param stop_token Optional stop token that cancels the recognition
+  /// \return recognition result, std::nullopt if no paragraph is found or the recognition failed or was cancelled
+  ///
+  [[nodiscard]] auto recognize_cursor_lines(
+    const screen_coordinates_type& relative_cursor_position, std::size_t context_lines, std::stop_token stop_token = {}
+  ) const -> std::optional<cursor_lines_recognition>;
+
   ///
-  [[nodiscard]] auto recognize_paragraph_bounding_box(const screen_coordinates_type& relative_cursor_position) const
-    -> std::optional<screen_rect_type>;
+  /// Select the text lines that are recognized by recognize_cursor_lines, i.e. the cursor line and the given number of
+  /// lines above and below it within the paragraph.
+  /// \param paragraph Paragraph containing the cursor, it must have at least one line
+  /// \param relative_cursor_position The position of the cursor on the screen in the image.
+  /// \param context_lines Number of lines selected above and below the cursor line
+  /// \return selected lines as recognition result, the recognized area spans the paragraph width and the selected lines
+  ///
+  [[nodiscard]] static auto select_cursor_lines(
+    const core_tesseract_common::layout_paragraph& paragraph,
+    const screen_coordinates_type& relative_cursor_position,
+    std::size_t context_lines
+  ) -> cursor_lines_recognition;
+
+  ///
+  /// Recognize an area of the OCR recognition image, e.g. the paragraph of a previous cursor lines recognition.
+  /// \param area Area within the OCR recognition image
+  /// \param stop_token Optional stop token that cancels the recognition
+  /// \return true if the recognition was successful, false otherwise
+  ///
+  [[nodiscard]] auto recognize_area(const screen_rect_type& area, std::stop_token stop_token = {}) const -> bool;
+
+  ///
+  /// Check if a reference found in the recognized cursor lines might continue in the skipped lines of the paragraph.
+  /// This is the case if the reference starts at the first recognized character or is only followed by transition chars,
+  /// while lines were skipped on this side.
+  /// \param recognition Cursor lines recognition
+  /// \param position_data OCR character position data of the recognized lines
+  /// \param index_range Index range of the reference in the position data text
+  /// \return true if the paragraph must be recognized completely to get the complete reference, false otherwise
+  ///
+  [[nodiscard]] static auto is_reference_cut_off(
+    const cursor_lines_recognition& recognition,
+    const reference_position_data& position_data,
+    const core_bible_reference_ocr_common::index_range_type& index_range
+  ) -> bool;
 
   ///
   /// Finds the main reference position data based on the given cursor position.
@@ -77,15 +186,28 @@ public: // Operations
     -> std::optional<reference_position_data>;
 
   ///
-  /// Finds reference position data based on the given cursor position.
-  /// This function analyzes the provided cursor position and determines the
-  /// corresponding reference position data from a set of OCR choices. The result
-  /// is a list of possible `reference_position_data` objects.
+  /// Decode the bible references at the given cursor position from the OCR choices of all symbols. The references are
+  /// decoded in one pass over the choices, see `core_reference_lattice_decoder`.
   /// \param relative_cursor_position The screen coordinates of the cursor position in the image.
-  /// \return A vector containing the reference position data associated with the given cursor position.
+  /// \param max_results Maximum number of decoded references
+  /// \return decoded references containing the symbol closest to the cursor, sorted by confidence from the highest to
+  /// the lowest
+  ///
+  auto decode_references_from_choices(const screen_coordinates_type& relative_cursor_position, std::size_t max_results) const
+    -> std::vector<decoded_reference>;
+
   ///
-  auto find_reference_position_data_from_choices(const screen_coordinates_type& relative_cursor_position) const
-    -> std::vector<reference_position_data>;
+  /// Find bible book names in the OCR choices of all symbols with a single traversal of the symbol choice lattice. At each
+  /// symbol a hypothesis is started at the root of the trie of all name variants, and all hypotheses are extended by the
+  /// choices that continue a name variant. Symbols whose main choice is neither a letter nor a digit are skipped and keep
+  /// their main choice. Only the best hypotheses of each start symbol by summed confidence are kept.
+  /// \param choice_arena OCR choices of all symbols, the choices of each symbol sorted by confidence
+  /// \param max_results Maximum number of returned book names
+  /// \return main choices of all symbols with a book name inserted at a possible position, sorted by the summed confidence
+  /// of the book name choices from the highest to the lowest. The size of each result is the number of symbols.
+  ///
+  [[nodiscard]] static auto match_choices_to_bible_book(const tesseract_choice_arena& choice_arena, std::size_t max_results)
+    -> std::vector<txt::indexed_strings>;
 
   ///
   /// Check if the given capture area is valid. The capture area is valid if the OCR character data is within the capture area
@@ -106,6 +228,15 @@ public: // Operations
     const core_bible_reference_ocr_common::index_range_type& index_range
   ) -> bool;
 
+  ///
+  /// Measure the character height as the height of the recognized text line containing the cursor. This is the character
+  /// height the capture area verification uses.
+  /// \param relative_cursor_position The screen coordinates of the cursor position in the image.
+  /// \return character height, std::nullopt if no recognized line contains the cursor position
+  ///
+  [[nodiscard]] auto measure_char_height(const screen_coordinates_type& relative_cursor_position) const
+    -> std::optional<std::uint16_t>;
+
 private: // Typedefs
   struct line_position_data final
   {
@@ -118,47 +249,19 @@ private: // Constants
   static constexpr auto area_generation_steps = std::array{1.0, 2.0, 3.0, 4.0};
   static constexpr auto area_generation_char_height_multiplier = 2;
   static constexpr auto area_generation_height_to_width_ratio = 9;
+  // Area estimation constants
+  static constexpr auto area_estimation_search_width_multiplier = 48;
+  static constexpr auto area_estimation_search_height_multiplier = 12;
+  static constexpr auto area_estimation_line_band_multiplier = 8;
+  static constexpr auto area_estimation_context_lines = 2;
+  static constexpr auto area_estimation_margin_multiplier = 3;
   // Area validation constants
   static constexpr auto area_validation_horizontal_margin_multiplier = 2.0;
   static constexpr auto area_validation_vertical_margin_multiplier = 0.2;
+  // Book name matching constants
+  static constexpr std::size_t book_name_beam_width = 8;
 
 private: // Implementation
-  ///
-  /// Find bible book given OCR character data. Tesseract choices must be sorted by confidence and must not be empty.
-  /// \param choices_list OCR character choices
-  /// \param choices_filter Filter function that is called for each choice. If the filter returns false, the choices are
-  /// ignored and the main symbol is taken for the result chars.
-  /// \return vector of indexed strings with the bible book names inserted at possible positions.
-  /// The index count is guaranteed to be the same as the number of choices in the choices_list.
-  ///
-  [[nodiscard]] auto match_choices_to_bible_book(
-    const std::vector<tesseract_choices>& choices_list, const std::function<bool(const tesseract_choices&)>& choices_filter
-  ) const -> std::vector<txt::indexed_strings>;
-
-  ///
-  /// Find text template given OCR character data. Tesseract choices must be sorted by confidence and must not be empty.
-  /// \param choices_list OCR character choices
-  /// \param text_template Text template that shall be chosen from the character choices
-  /// \param choices_filter Filter function that is called for each choice. If the filter returns false, the choices are ignored
-  /// and the main symbol is taken for the result chars.
-  /// \return vector of confidence sums and indexed strings with the text template symbols inserted at possible positions
-  /// The index count is guaranteed to be the same as the number of choices in the choices_list.
-  ///
-  [[nodiscard]] auto match_choices_to_string(
-    const std::vector<tesseract_choices>& choices_list,
-    std::string_view text_template,
-    const std::function<bool(const tesseract_choices&)>& choices_filter
-  ) const -> std::vector<std::pair<double, txt::indexed_strings>>;
-
-  ///
-  /// Check if the given character is found in the choices.
-  /// \param choices OCR character choices.
-  /// \param chars Expected characters of which the begin is checked to find in the choices
-  /// \return optional tesseract choice if the character is found, otherwise nullopt
-  ///
-  [[nodiscard]] auto find_chars_begin_match(const tesseract_choices& choices, std::string_view chars) const
-    -> std::optional<tesseract_choice>;
-
   ///
   /// Finds the index of the character data with the minimum distance.
   /// This function iterates through a vector of `character_data` and determines
@@ -178,7 +281,7 @@ private: // Implementation
     -> std::optional<line_position_data>;
 
 private: // Variables
-  const std::unique_ptr<core::core_tesseract> core_tesseract_;
+  const core_tesseract_pool::lease core_tesseract_;
 };
 
 } // namespace bibstd::core
@@ -1,7 +1,9 @@
 #pragma once
 
+#include "bible/reference_range.hpp"
 #include "util/screen_types.hpp"
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -16,6 +18,7 @@ struct core_bible_reference_ocr_common final
   // Typedefs
   using index_range_type = math::value_range<std::size_t>;
   using screen_rect_type = util::screen_types::screen_rect_type;
+  using pixel_plane_type = util::screen_types::pixel_plane_type;
 
   ///
   /// This struct contains OCR data for recognized symbol (character).
@@ -40,6 +43,58 @@ struct core_bible_reference_ocr_common final
     std::vector<character_data> char_data;
     std::size_t cursor_character_index;
   };
+
+  ///
+  /// This struct contains a bible reference decoded from the OCR choices.
+  /// \param position_data OCR data of the recognized area with the decoded choices as text
+  /// \param ranges Reference ranges of the decoded reference
+  /// \param index_range_origin Index range of the decoded reference in the position data text
+  /// \param confidence Combined OCR and grammar confidence of the decoded reference in the range [0, 100]
+  ///
+  struct decoded_reference final
+  {
+    reference_position_data position_data;
+    std::vector<bible::reference_range> ranges;
+    index_range_type index_range_origin;
+    double confidence;
+  };
+
+  ///
+  /// This struct contains a captured screen area. The pixels are shared read only between all OCR areas set from the capture.
+  /// \param area Captured screen area
+  /// \param pixels Captured pixels
+  ///
+  struct screen_capture final
+  {
+    screen_rect_type area;
+    std::shared_ptr<pixel_plane_type> pixels;
+  };
+
+  ///
+  /// This struct contains the result of the recognition of the text lines around the cursor.
+  /// \param paragraph_bounding_box Bounding box of the paragraph containing the cursor
+  /// \param recognized_area Recognized area, it spans the paragraph width and the recognized lines
+  /// \param lines_above_skipped True if lines of the paragraph above the recognized area were not recognized
+  /// \param lines_below_skipped True if lines of the paragraph below the recognized area were not recognized
+  ///
+  struct cursor_lines_recognition final
+  {
+    screen_rect_type paragraph_bounding_box;
+    screen_rect_type recognized_area;
+    bool lines_above_skipped;
+    bool lines_below_skipped;
+  };
+
+  ///
+  /// This struct contains a capture area estimated from the text layout around the cursor without OCR.
+  /// \param capture_area Capture area containing the cursor paragraph with the margins of the capture area verification
+  /// \param char_height Estimated character height
+  ///
+  struct capture_area_estimate final
+  {
+    screen_rect_type capture_area;
+    std::uint16_t char_height;
+  };
 };
 
 } // namespace bibstd::core
@@ -0,0 +1,83 @@
+#include "core/core_bible_reference_scanner.hpp"
+#include "util/exception.hpp"
+
+#include <algorithm>
+#include <ranges>
+
+namespace bibstd::core
+{
+
+///
+///
+core_bible_reference_scanner::core_bible_reference_scanner(callback_type&& callback, const std::size_t buffer_size)
+  : callback_{std::move(callback)}
+  , buffer_size_{buffer_size}
+{
+  if(buffer_size_ <= 2 * max_reference_size)
+  {
+    THROW_EXCEPTION(std::invalid_argument("buffer size too small"));
+  }
+  buffer_.reserve(buffer_size_);
+}
+
+///
+///
+auto core_bible_reference_scanner::feed(std::string_view chunk) -> void
+{
+  while(!chunk.empty())
+  {
+    const auto count = std::min(chunk.size(), buffer_size_ - buffer_.size());
+    buffer_.append(chunk.substr(0, count));
+    chunk.remove_prefix(count);
+    if(buffer_.size() == buffer_size_)
+    {
+      scan_buffer(false);
+    }
+  }
+}
+
+///
+///
+auto core_bible_reference_scanner::finish() -> void
+{
+  scan_buffer(true);
+  buffer_offset_ = 0;
+  reported_end_ = 0;
+}
+
+///
+///
+auto core_bible_reference_scanner::scan_buffer(const bool final) -> void
+{
+  // References starting after the cut are reported with the next buffer, where their complete text is available.
+  // The cut must not split a UTF-8 character, since the text after the cut is scanned again.
+  // A UTF-8 character has at most three continuation bytes, invalid sequences are cut anyway.
+  auto cut = final ? buffer_.size() : buffer_.size() - max_reference_size;
+  const auto is_continuation_byte = [](const char c) { return (static_cast<unsigned char>(c) & 0xC0u) == 0x80u; };
+  for(auto i = 0; i < 3 && cut > 0 && cut < buffer_.size() && is_continuation_byte(buffer_[cut]); ++i)
+  {
+    --cut;
+  }
+
+  const auto results = core_.scan(buffer_);
+  std::ranges::for_each(
+    results | std::views::take_while([&](const auto& result) { return result.index_range_origin.begin < cut; }),
+    [&](const auto& result)
+    {
+      const auto origin = index_range_type{
+        buffer_offset_ + result.index_range_origin.begin, buffer_offset_ + result.index_range_origin.end
+      };
+      // The reference overlaps with a reference reported with the previous buffer.
+      if(origin.begin < reported_end_)
+      {
+        return;
+      }
+      reported_end_ = origin.end;
+      callback_(parse_result{.ranges = result.ranges, .index_range_origin = origin});
+    }
+  );
+  buffer_.erase(0, cut);
+  buffer_offset_ += cut;
+}
+
+} // namespace bibstd::core
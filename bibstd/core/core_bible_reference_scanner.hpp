@@ -0,0 +1,68 @@
+#pragma once
+
+#include "core/core_bible_reference.hpp"
+
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace bibstd::core
+{
+
+///
+/// Core bible reference scanner. This class finds all bible references in a text which is fed in chunks.
+/// Every reference is reported once with its index range in the whole text. The memory used is bounded by the buffer
+/// size and independent of the text size.
+///
+class core_bible_reference_scanner final
+{
+public: // Typedefs
+  using parse_result = core_bible_reference::parse_result;
+  using index_range_type = core_bible_reference::index_range_type;
+  using callback_type = std::move_only_function<void(const parse_result&)>;
+
+public: // Constants
+  ///
+  /// Number of bytes which are carried over to the next buffer. References starting in the carried text are reported
+  /// with the next buffer, so a reference must not be longer than this to be found in full.
+  ///
+  static constexpr auto max_reference_size = std::size_t{256};
+
+  ///
+  /// Default number of bytes which are buffered before they are scanned.
+  ///
+  static constexpr auto default_buffer_size = std::size_t{64 * 1024};
+
+public: // Structors
+  ///
+  /// Create scanner.
+  /// \param callback Function that is called for each reference found, the origin index range is relative to the whole text
+  /// \param buffer_size Number of bytes which are buffered before they are scanned, must exceed twice `max_reference_size`
+  ///
+  explicit core_bible_reference_scanner(callback_type&& callback, std::size_t buffer_size = default_buffer_size);
+
+public: // Modifiers
+  ///
+  /// Feed the next chunk of the text. Chunks may split words and UTF-8 characters.
+  /// \param chunk Next chunk of the text
+  ///
+  auto feed(std::string_view chunk) -> void;
+
+  ///
+  /// Scan the remaining buffered text. The scanner can be reused for a new text afterwards.
+  ///
+  auto finish() -> void;
+
+private: // Implementation
+  auto scan_buffer(bool final) -> void;
+
+private: // Variables
+  core_bible_reference core_;
+  callback_type callback_;
+  std::size_t buffer_size_;
+  std::string buffer_{};
+  std::size_t buffer_offset_{0};
+  std::size_t reported_end_{0};
+};
+
+} // namespace bibstd::core
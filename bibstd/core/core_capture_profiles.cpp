@@ -0,0 +1,134 @@
+#include "core/core_capture_profiles.hpp"
+#include "util/exception.hpp"
+#include "util/log.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <format>
+#include <ranges>
+#include <stdexcept>
+
+namespace bibstd::core
+{
+namespace detail
+{
+
+///
+/// Parse an integer that must span the complete text.
+///
+template<typename T>
+auto parse_number(const std::string_view text) -> std::optional<T>
+{
+  auto value = T{};
+  const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+  return error == std::errc{} && end == text.data() + text.size() ? std::make_optional(value) : std::nullopt;
+}
+
+///
+/// Parse a stored entry. The numbers are split off from the right, since a window class name may contain the separator.
+///
+auto parse_entry(const std::string_view entry) -> std::optional<std::pair<std::string, core_capture_profiles::profile>>
+{
+  auto fields = std::array<std::string_view, 3>{};
+  auto rest = entry;
+  for(auto& field : fields | std::views::reverse)
+  {
+    const auto separator = rest.rfind('|');
+    if(separator == std::string_view::npos)
+    {
+      return std::nullopt;
+    }
+    field = rest.substr(separator + 1);
+    rest = rest.substr(0, separator);
+  }
+  const auto char_height = parse_number<std::uint16_t>(fields[0]);
+  const auto capture_width = parse_number<std::int32_t>(fields[1]);
+  const auto capture_height = parse_number<std::int32_t>(fields[2]);
+  if(rest.empty() || !char_height || !capture_width || !capture_height || *char_height == 0 || *capture_width <= 0 ||
+     *capture_height <= 0)
+  {
+    return std::nullopt;
+  }
+  return std::pair{
+    std::string{rest},
+    core_capture_profiles::profile{
+      .char_height = *char_height, .capture_width = *capture_width, .capture_height = *capture_height
+    }
+  };
+}
+
+} // namespace detail
+
+///
+///
+core_capture_profiles::core_capture_profiles(const std::vector<std::string>& entries, const std::size_t capacity)
+  : capacity_{capacity}
+{
+  if(capacity_ == 0)
+  {
+    THROW_EXCEPTION(std::invalid_argument("capture profile capacity must not be zero"));
+  }
+  for(const auto& entry : entries)
+  {
+    auto parsed = detail::parse_entry(entry);
+    if(!parsed)
+    {
+      LOG_WARN("invalid capture profile dropped: entry={}", entry);
+      continue;
+    }
+    if(profiles_.size() < capacity_ && !find(parsed->first))
+    {
+      profiles_.push_back(std::move(*parsed));
+    }
+  }
+}
+
+///
+///
+auto core_capture_profiles::find(const std::string_view application) const -> std::optional<profile>
+{
+  const auto iter = std::ranges::find(profiles_, application, &entry_type::first);
+  return iter != profiles_.cend() ? std::make_optional(iter->second) : std::nullopt;
+}
+
+///
+///
+auto core_capture_profiles::entries() const -> std::vector<std::string>
+{
+  auto result = std::vector<std::string>{};
+  result.reserve(profiles_.size());
+  for(const auto& [application, profile] : profiles_)
+  {
+    result.push_back(
+      std::format("{}|{}|{}|{}", application, profile.char_height, profile.capture_width, profile.capture_height)
+    );
+  }
+  return result;
+}
+
+///
+///
+auto core_capture_profiles::size() const -> std::size_t
+{
+  return profiles_.size();
+}
+
+///
+/// The profiles are few, so a linear search with a move to the front is faster than a list with a map.
+auto core_capture_profiles::record(const std::string_view application, const profile& profile) -> void
+{
+  auto iter = std::ranges::find(profiles_, application, &entry_type::first);
+  if(iter == profiles_.end())
+  {
+    if(profiles_.size() == capacity_)
+    {
+      profiles_.pop_back();
+    }
+    iter = profiles_.insert(profiles_.end(), std::pair{std::string{application}, profile});
+  }
+  iter->second = profile;
+  std::rotate(profiles_.begin(), iter, iter + 1);
+}
+
+} // namespace bibstd::core
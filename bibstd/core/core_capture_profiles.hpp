@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace bibstd::core
+{
+
+///
+/// Core capture profiles. Least recently used table of the capture parameters that were successful for an application.
+/// The table is stored as a list of strings, so it can be persisted as a setting. Each entry has the format
+/// `application|char_height|capture_width|capture_height`, the most recently used entry is the first one.
+///
+class core_capture_profiles final
+{
+public: // Typedefs
+  ///
+  /// Capture parameters of an application.
+  /// \param char_height Measured character height
+  /// \param capture_width Width of the capture area that was verified
+  /// \param capture_height Height of the capture area that was verified
+  ///
+  struct profile final
+  {
+    std::uint16_t char_height;
+    std::int32_t capture_width;
+    std::int32_t capture_height;
+
+    auto operator==(const profile&) const -> bool = default;
+  };
+
+public: // Constants
+  static constexpr std::size_t default_capacity = 16;
+
+public: // Structors
+  ///
+  /// Create the table from stored entries. Invalid entries and entries above the capacity are dropped.
+  /// \param entries Stored entries, the most recently used entry first
+  /// \param capacity Maximum number of profiles, the least recently used profile is dropped if it is exceeded
+  ///
+  explicit core_capture_profiles(const std::vector<std::string>& entries, std::size_t capacity = default_capacity);
+
+public: // Accessors
+  ///
+  /// Find the profile of an application.
+  /// \param application Application name, e.g. the executable name
+  /// \return profile, std::nullopt if no profile is recorded for the application
+  ///
+  auto find(std::string_view application) const -> std::optional<profile>;
+
+  ///
+  /// Get the entries of the table in the stored format.
+  /// \return entries, the most recently used entry first
+  ///
+  auto entries() const -> std::vector<std::string>;
+
+  ///
+  /// Get the number of profiles.
+  /// \return number of profiles
+  ///
+  auto size() const -> std::size_t;
+
+public: // Modifiers
+  ///
+  /// Record the profile of an application. The profile replaces a previous profile of the application and becomes the
+  /// most recently used one.
+  /// \param application Application name, e.g. the executable name
+  /// \param profile Capture parameters
+  ///
+  auto record(std::string_view application, const profile& profile) -> void;
+
+private: // Typedefs
+  using entry_type = std::pair<std::string, profile>;
+
+private: // Variables
+  std::size_t capacity_;
+  std::vector<entry_type> profiles_;
+};
+
+} // namespace bibstd::core
@@ -0,0 +1,240 @@
+#include "core/core_ocr_page.hpp"
+#include "util/exception.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+
+namespace bibstd::core
+{
+namespace detail
+{
+
+///
+/// Append text to a buffer.
+/// \param buffer Text buffer
+/// \param text Text that is appended
+/// \return byte range of the appended text in the buffer
+///
+auto append_text(std::string& buffer, const std::string_view text) -> core_ocr_page::index_range_type
+{
+  const auto begin = static_cast<core_ocr_page::index_type>(buffer.size());
+  buffer.append(text);
+  return core_ocr_page::index_range_type(begin, static_cast<core_ocr_page::index_type>(buffer.size()));
+}
+
+///
+/// Get the parent resolution of a text resolution.
+/// \param resolution Text resolution
+/// \return next higher text resolution, std::nullopt for paragraphs
+///
+constexpr auto parent_resolution(const core_ocr_page::text_resolution resolution)
+  -> std::optional<core_ocr_page::text_resolution>
+{
+  using enum core_ocr_page::text_resolution;
+  switch(resolution)
+  {
+  case character: return word;
+  case word: return line;
+  case line: return paragraph;
+  case paragraph: return std::nullopt;
+  }
+  return std::nullopt;
+}
+
+} // namespace detail
+
+///
+///
+auto core_ocr_page::empty() const -> bool
+{
+  return elements(text_resolution::character).boxes.empty();
+}
+
+///
+///
+auto core_ocr_page::elements(const text_resolution resolution) const -> const element_table&
+{
+  return tables_.at(static_cast<std::size_t>(resolution));
+}
+
+///
+///
+auto core_ocr_page::text() const -> std::string_view
+{
+  return text_;
+}
+
+///
+///
+auto core_ocr_page::text(const text_resolution resolution, const index_type index) const -> std::string_view
+{
+  const auto& range = elements(resolution).text_ranges.at(index);
+  return std::string_view(text_).substr(range.begin, index_range_type::size(range));
+}
+
+///
+///
+auto core_ocr_page::mean_confidence(const text_resolution resolution) const -> double
+{
+  const auto& confidences = elements(resolution).confidences;
+  if(confidences.empty())
+  {
+    return 0.0;
+  }
+  return std::accumulate(confidences.cbegin(), confidences.cend(), 0.0) / static_cast<double>(confidences.size());
+}
+
+///
+///
+auto core_ocr_page::mean_confidence(const text_resolution resolution, const screen_rect_type& area) const -> double
+{
+  const auto& table = elements(resolution);
+  auto sum = 0.0;
+  auto count = std::size_t{0};
+  for(index_type i = 0; i < table.size(); ++i)
+  {
+    if(screen_rect_type::contains(area, table.boxes[i].center()))
+    {
+      sum += table.confidences[i];
+      ++count;
+    }
+  }
+  return count > 0 ? sum / static_cast<double>(count) : 0.0;
+}
+
+///
+///
+auto core_ocr_page::choices() const -> const choice_table&
+{
+  return choices_;
+}
+
+///
+///
+auto core_ocr_page::symbol_choices(const index_type symbol_index) const -> index_range_type
+{
+  return symbol_choices_.at(symbol_index);
+}
+
+///
+///
+auto core_ocr_page::choice_text(const index_type choice_index) const -> std::string_view
+{
+  const auto& range = choices_.text_ranges.at(choice_index);
+  return std::string_view(choice_text_).substr(range.begin, index_range_type::size(range));
+}
+
+///
+/// The choices of the page are already stored by symbol, so the symbol ranges are taken over as they are.
+auto core_ocr_page::choice_arena() const -> const core_tesseract_common::tesseract_choice_arena&
+{
+  if(choice_arena_text_ != choice_text_.data())
+  {
+    choice_arena_.choices.clear();
+    for(index_type c = 0; c < choices_.size(); ++c)
+    {
+      choice_arena_.choices.push_back({.symbol = choice_text(c), .confidence = choices_.confidences[c]});
+    }
+    choice_arena_.symbol_ranges.assign(symbol_choices_.cbegin(), symbol_choices_.cend());
+    choice_arena_text_ = choice_text_.data();
+  }
+  return choice_arena_;
+}
+
+///
+///
+auto core_ocr_page::clear() -> void
+{
+  text_.clear();
+  choice_text_.clear();
+  std::ranges::for_each(
+    tables_,
+    [](auto& table)
+    {
+      table.boxes.clear();
+      table.confidences.clear();
+      table.parents.clear();
+      table.text_ranges.clear();
+    }
+  );
+  symbol_choices_.clear();
+  choices_.text_ranges.clear();
+  choices_.confidences.clear();
+  choice_arena_text_ = nullptr;
+}
+
+///
+///
+auto core_ocr_page::begin_element(const text_resolution resolution, const screen_rect_type& box, const float confidence)
+  -> void
+{
+  if(resolution == text_resolution::character)
+  {
+    THROW_EXCEPTION(std::invalid_argument("symbols must be added with add_symbol"));
+  }
+  const auto parent = detail::parent_resolution(resolution);
+  const auto& parent_table = parent ? table(*parent) : table(resolution);
+  auto& element_table = table(resolution);
+  const auto text_end = static_cast<index_type>(text_.size());
+  element_table.boxes.push_back(box);
+  element_table.confidences.push_back(confidence);
+  element_table.parents.push_back(parent && parent_table.size() > 0 ? parent_table.size() - 1 : no_parent);
+  element_table.text_ranges.emplace_back(text_end, text_end);
+}
+
+///
+///
+auto core_ocr_page::add_symbol(const std::string_view text, const screen_rect_type& box, const float confidence) -> void
+{
+  auto& symbols = table(text_resolution::character);
+  const auto& words = table(text_resolution::word);
+  const auto text_range = detail::append_text(text_, text);
+  symbols.boxes.push_back(box);
+  symbols.confidences.push_back(confidence);
+  symbols.parents.push_back(words.size() > 0 ? words.size() - 1 : no_parent);
+  symbols.text_ranges.push_back(text_range);
+  // The symbol belongs to the last begun word, line and paragraph, so their text ranges are extended.
+  for(const auto resolution : {text_resolution::word, text_resolution::line, text_resolution::paragraph})
+  {
+    if(auto& ranges = table(resolution).text_ranges; !ranges.empty())
+    {
+      ranges.back().end = text_range.end;
+    }
+  }
+  const auto choice_begin = choices_.size();
+  symbol_choices_.emplace_back(choice_begin, choice_begin);
+  add_choice(text, confidence);
+}
+
+///
+///
+auto core_ocr_page::add_choice(const std::string_view text, const float confidence) -> void
+{
+  if(symbol_choices_.empty())
+  {
+    THROW_EXCEPTION(std::logic_error("choice added without symbol"));
+  }
+  // Each symbol is added with its first choice, so the arena is invalidated by every modification of the choices.
+  choice_arena_text_ = nullptr;
+  auto& range = symbol_choices_.back();
+  choices_.text_ranges.push_back(detail::append_text(choice_text_, text));
+  choices_.confidences.push_back(confidence);
+  ++range.end;
+  // Insertion sort, since a symbol has only a few choices that are added one after another.
+  for(auto i = range.end - 1; i > range.begin && choices_.confidences[i - 1] < choices_.confidences[i]; --i)
+  {
+    std::swap(choices_.confidences[i - 1], choices_.confidences[i]);
+    std::swap(choices_.text_ranges[i - 1], choices_.text_ranges[i]);
+  }
+}
+
+///
+///
+auto core_ocr_page::table(const text_resolution resolution) -> element_table&
+{
+  return tables_.at(static_cast<std::size_t>(resolution));
+}
+
+} // namespace bibstd::core
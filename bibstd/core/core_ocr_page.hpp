@@ -0,0 +1,180 @@
+#pragma once
+
+#include "core/core_tesseract_common.hpp"
+#include "math/value_range.hpp"
+#include "util/screen_types.hpp"
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bibstd::core
+{
+
+///
+/// Core OCR page. Structured result of a single tesseract recognition.
+/// The symbols, words, lines and paragraphs are stored in flat tables (structure of arrays), where each element
+/// references its parent element of the next higher level by index. The text of all symbols is stored in one contiguous
+/// UTF-8 buffer and each element references its text as a byte range of this buffer.
+///
+class core_ocr_page final
+{
+public: // Typedefs
+  using screen_rect_type = util::screen_types::screen_rect_type;
+  using text_resolution = core_tesseract_common::text_resolution;
+  using index_type = std::uint32_t;
+  using index_range_type = math::value_range<index_type>;
+
+  ///
+  /// Table of the elements of one text resolution. The element at index `i` is described by the `i`-th entry of each column.
+  /// \param boxes Bounding boxes
+  /// \param confidences Recognition confidences
+  /// \param parents Index of the parent element of the next higher resolution, `no_parent` for paragraphs
+  /// \param text_ranges Byte range of the element text in the page text
+  ///
+  struct element_table final
+  {
+    std::vector<screen_rect_type> boxes;
+    std::vector<float> confidences;
+    std::vector<index_type> parents;
+    std::vector<index_range_type> text_ranges;
+
+    auto size() const -> index_type { return static_cast<index_type>(boxes.size()); }
+  };
+
+  ///
+  /// Table of the alternative symbol choices. The choices of a symbol are stored consecutively, sorted by confidence.
+  /// \param text_ranges Byte range of the choice text in the choice text buffer
+  /// \param confidences Choice confidences
+  ///
+  struct choice_table final
+  {
+    std::vector<index_range_type> text_ranges;
+    std::vector<float> confidences;
+
+    auto size() const -> index_type { return static_cast<index_type>(text_ranges.size()); }
+  };
+
+public: // Constants
+  static constexpr auto no_parent = std::numeric_limits<index_type>::max();
+
+public: // Accessors
+  ///
+  /// Check if the page contains no symbols.
+  /// \return true if no symbol was recognized, false otherwise
+  ///
+  auto empty() const -> bool;
+
+  ///
+  /// Get the element table of a text resolution.
+  /// \param resolution Text resolution
+  /// \return element table
+  ///
+  auto elements(text_resolution resolution) const -> const element_table&;
+
+  ///
+  /// Get the text of all symbols of the page. Symbols are concatenated without separators.
+  /// \return page text
+  ///
+  auto text() const -> std::string_view;
+
+  ///
+  /// Get the text of an element.
+  /// \param resolution Text resolution of the element
+  /// \param index Index of the element
+  /// \return element text
+  ///
+  auto text(text_resolution resolution, index_type index) const -> std::string_view;
+
+  ///
+  /// Get the mean recognition confidence of all elements of a text resolution.
+  /// \param resolution Text resolution
+  /// \return mean confidence, 0 if there are no elements
+  ///
+  auto mean_confidence(text_resolution resolution) const -> double;
+
+  ///
+  /// Get the mean recognition confidence of the elements of a text resolution whose bounding box center is within an area.
+  /// \param resolution Text resolution
+  /// \param area Area containing the elements, e.g. a paragraph
+  /// \return mean confidence, 0 if there are no elements in the area
+  ///
+  auto mean_confidence(text_resolution resolution, const screen_rect_type& area) const -> double;
+
+  ///
+  /// Get the choice table. The choices of a symbol are found with `symbol_choices`.
+  /// \return choice table
+  ///
+  auto choices() const -> const choice_table&;
+
+  ///
+  /// Get the range of the choices of a symbol in the choice table. The range is never empty, since the recognized symbol
+  /// itself is a choice as well.
+  /// \param symbol_index Index of the symbol
+  /// \return index range in the choice table
+  ///
+  auto symbol_choices(index_type symbol_index) const -> index_range_type;
+
+  ///
+  /// Get the text of a choice.
+  /// \param choice_index Index of the choice
+  /// \return choice text
+  ///
+  auto choice_text(index_type choice_index) const -> std::string_view;
+
+  ///
+  /// Get the arena of the choices of all symbols. The arena is built on the first call after the page was modified and
+  /// kept for the following calls. The choice texts reference this page.
+  /// \return choice arena, valid until the page is modified
+  ///
+  auto choice_arena() const -> const core_tesseract_common::tesseract_choice_arena&;
+
+public: // Modifiers
+  ///
+  /// Remove all elements. The allocated memory is kept for the next recognition.
+  ///
+  auto clear() -> void;
+
+  ///
+  /// Begin a new word, line or paragraph. The following symbols belong to this element until a new element of the same
+  /// resolution is begun. The parent is the last begun element of the next higher resolution.
+  /// \param resolution Text resolution of the element, must not be `character`
+  /// \param box Bounding box of the element
+  /// \param confidence Recognition confidence of the element
+  ///
+  auto begin_element(text_resolution resolution, const screen_rect_type& box, float confidence) -> void;
+
+  ///
+  /// Add a symbol to the last begun word. The symbol is added as its first choice as well.
+  /// \param text Symbol text
+  /// \param box Bounding box of the symbol
+  /// \param confidence Recognition confidence of the symbol in the range [0, 100]
+  ///
+  auto add_symbol(std::string_view text, const screen_rect_type& box, float confidence) -> void;
+
+  ///
+  /// Add an alternative choice to the last added symbol. The choices of the symbol are kept sorted by confidence.
+  /// \param text Choice text
+  /// \param confidence Choice confidence in the range [0, 100]
+  ///
+  auto add_choice(std::string_view text, float confidence) -> void;
+
+private: // Implementation
+  auto table(text_resolution resolution) -> element_table&;
+
+private: // Variables
+  std::string text_;
+  std::string choice_text_;
+  std::array<element_table, 4> tables_;
+  std::vector<index_range_type> symbol_choices_;
+  choice_table choices_;
+  // Cache of the choice arena, it is rebuilt in the allocated memory after the page was modified. The arena is only valid
+  // for the choice text buffer it references, so a copied or moved page rebuilds it as well.
+  mutable core_tesseract_common::tesseract_choice_arena choice_arena_;
+  mutable const char* choice_arena_text_{nullptr};
+};
+
+} // namespace bibstd::core
@@ -0,0 +1,389 @@
+#include "core/core_reference_lattice_decoder.hpp"
+#include "bible/book_name_variants_de.hpp"
+#include "txt/chars.hpp"
+#include "util/contains.hpp"
+#include "util/exception.hpp"
+#include "util/static_vector.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+namespace bibstd::core
+{
+namespace detail
+{
+
+using automaton_type = std::remove_cvref_t<decltype(bible::book_name_variants_de::name_variants_automaton)>;
+using state_index_type = automaton_type::state_index_type;
+using passage_type = util::static_vector<char, core_reference_lattice_decoder::max_passage_size>;
+using decode_result = core_reference_lattice_decoder::decode_result;
+
+static constexpr auto no_step = std::numeric_limits<std::uint32_t>::max();
+
+///
+/// Last token read by a hypothesis. A hypothesis reads the book name until its first passage number.
+///
+enum class grammar_token : std::uint8_t
+{
+  name,
+  digit,
+  transition,
+  postfix,
+  following_postfix,
+};
+
+///
+/// Choice of a symbol taken by a hypothesis, linked to the choice taken for the previous symbol.
+///
+struct hypothesis_step final
+{
+  std::uint32_t symbol_index;
+  std::uint32_t choice_index;
+  std::uint32_t previous;
+};
+
+///
+/// Last state of a hypothesis in which its passage was complete, i.e. ended with a number or a number postfix.
+///
+struct complete_state final
+{
+  std::uint32_t end{0};
+  std::uint32_t last_step{no_step};
+  std::uint32_t passage_size{0};
+  double confidence_sum{0.0};
+  double grammar{1.0};
+};
+
+///
+/// Partial or complete reading of a reference.
+///
+struct hypothesis final
+{
+  std::uint32_t start;
+  state_index_type state;
+  passage_type passage{};
+  grammar_token token{grammar_token::name};
+  std::uint32_t number_digits{0};
+  double confidence_sum{0.0};
+  double grammar{1.0};
+  std::uint32_t last_step{no_step};
+  complete_state complete{};
+};
+
+///
+/// Complete reading of a reference, ended by a choice that does not continue the reference or by the last symbol.
+///
+struct decoded_candidate final
+{
+  std::uint32_t start;
+  state_index_type state;
+  passage_type passage;
+  complete_state complete;
+  double confidence;
+};
+
+///
+/// Decoded reference with the pattern index of its book name variant.
+///
+struct decoded_reference final
+{
+  decode_result result;
+  std::size_t pattern;
+};
+
+///
+/// Calls function for each hypothesis that extends the given hypothesis by the symbol. The confidence and the steps of the
+/// extended hypotheses are not updated.
+///
+auto for_each_extension(const hypothesis& current, const std::string_view symbol, auto&& function) -> void
+{
+  using category = txt::chars::category;
+  if(symbol.empty())
+  {
+    return;
+  }
+  const auto& automaton = bible::book_name_variants_de::name_variants_automaton;
+  const auto info = txt::chars::char_info(symbol, 0);
+  const auto char_category = info && info->char_size == symbol.size() ? info->char_category : category::other;
+  auto next = current;
+  if(current.token == grammar_token::name)
+  {
+    // Full stops within and after a book name are skipped, e.g. "1.Mo" or "Joh.".
+    if(char_category == category::fullstop)
+    {
+      if(current.state != automaton.root)
+      {
+        function(next);
+      }
+      return;
+    }
+    if(char_category == category::digit && automaton.state_pattern(current.state) != automaton.no_pattern)
+    {
+      next.passage.push_back(symbol.front());
+      next.token = grammar_token::digit;
+      next.number_digits = 1;
+      function(next);
+      next = current;
+    }
+    next.state = automaton.trie_transition(current.state, symbol);
+    if(next.state != automaton.no_state)
+    {
+      function(next);
+    }
+    return;
+  }
+
+  const auto is_postfix = current.token == grammar_token::postfix || current.token == grammar_token::following_postfix;
+  if(char_category == category::digit)
+  {
+    if(is_postfix || current.passage.full() ||
+       (current.token == grammar_token::digit && current.number_digits >= core_reference_lattice_decoder::max_number_digits))
+    {
+      return;
+    }
+    next.passage.push_back(symbol.front());
+    next.number_digits = current.token == grammar_token::digit ? current.number_digits + 1 : 1;
+    next.token = grammar_token::digit;
+    function(next);
+  }
+  else if(current.token == grammar_token::following_postfix && char_category == category::fullstop)
+  {
+    // The full stop is part of the postfixes "f." and "ff.".
+    function(next);
+  }
+  else if(char_category == category::line || util::contains(core_bible_reference::transition_chars, symbol.front()))
+  {
+    if(current.token == grammar_token::transition || current.passage.full())
+    {
+      return;
+    }
+    next.passage.push_back(char_category == category::line ? '-' : symbol.front());
+    next.token = grammar_token::transition;
+    function(next);
+  }
+  else if(char_category == category::letter && util::contains(core_bible_reference::number_postfix_chars, symbol.front()))
+  {
+    if(current.token == grammar_token::transition)
+    {
+      return;
+    }
+    next.grammar *= is_postfix ? 1.0 : core_reference_lattice_decoder::postfix_prior;
+    next.token = symbol.front() == 'f' ? grammar_token::following_postfix : grammar_token::postfix;
+    function(next);
+  }
+}
+
+///
+/// Create the decoded candidate of the complete state of a hypothesis.
+/// \param current Hypothesis with a complete state
+/// \param end_confidence Confidence of the choice ending the reference, std::nullopt at the end of the symbols
+///
+auto create_candidate(const hypothesis& current, const std::optional<float> end_confidence) -> decoded_candidate
+{
+  const auto& complete = current.complete;
+  auto passage = passage_type{};
+  std::ranges::for_each(
+    current.passage | std::views::take(complete.passage_size), [&](const auto c) { passage.push_back(c); }
+  );
+  const auto symbol_count = complete.end - current.start + (end_confidence ? 1.0 : 0.0);
+  return decoded_candidate{
+    .start = current.start,
+    .state = current.state,
+    .passage = passage,
+    .complete = complete,
+    .confidence = (complete.confidence_sum + end_confidence.value_or(0.0F)) / symbol_count * complete.grammar
+  };
+}
+
+///
+/// Check if the choices of the inner reference are the choices of the outer reference for the same symbols.
+///
+auto is_contained(const decode_result& outer, const decode_result& inner) -> bool
+{
+  const auto offset = inner.symbol_range.begin - outer.symbol_range.begin;
+  return outer.symbol_range.begin <= inner.symbol_range.begin && inner.symbol_range.end <= outer.symbol_range.end &&
+         std::ranges::equal(inner.choice_indices, std::span(outer.choice_indices).subspan(offset, inner.choice_indices.size()));
+}
+
+} // namespace detail
+
+///
+///
+core_reference_lattice_decoder::core_reference_lattice_decoder(const std::size_t beam_width)
+  : beam_width_{beam_width}
+{
+  if(beam_width_ == 0)
+  {
+    THROW_EXCEPTION(std::invalid_argument("reference lattice decoder beam width must not be zero"));
+  }
+}
+
+///
+/// Hypotheses of the same start symbol have read the same number of symbols, so their summed confidences are compared.
+auto core_reference_lattice_decoder::decode(
+  const tesseract_choice_arena& choice_arena, const std::size_t symbol_index, const std::size_t max_results
+) const -> std::vector<decode_result>
+{
+  using detail::grammar_token;
+  const auto& automaton = bible::book_name_variants_de::name_variants_automaton;
+  const auto score = [](const detail::hypothesis& h) { return h.confidence_sum * h.grammar; };
+  const auto key = [](const detail::hypothesis& h)
+  { return std::tuple(h.start, h.state, std::string_view(h.passage.data(), h.passage.size()), h.token); };
+  auto steps = std::vector<detail::hypothesis_step>{};
+  auto active = std::vector<detail::hypothesis>{};
+  auto extended = std::vector<detail::hypothesis>{};
+  auto candidates = std::vector<detail::decoded_candidate>{};
+  for(std::uint32_t i = 0; i < choice_arena.size(); ++i)
+  {
+    const auto choices = choice_arena.symbol_choices(i);
+    extended.clear();
+    const auto extend = [&](const detail::hypothesis& hypothesis)
+    {
+      auto ended = false;
+      for(std::uint32_t c = 0; c < choices.size(); ++c)
+      {
+        auto extends = false;
+        detail::for_each_extension(
+          hypothesis,
+          choices[c].symbol,
+          [&](detail::hypothesis next)
+          {
+            extends = true;
+            steps.push_back({.symbol_index = i, .choice_index = c, .previous = hypothesis.last_step});
+            next.confidence_sum += choices[c].confidence;
+            next.last_step = static_cast<std::uint32_t>(steps.size() - 1);
+            if(next.token == grammar_token::digit || next.token == grammar_token::postfix ||
+               next.token == grammar_token::following_postfix)
+            {
+              next.complete = {
+                .end = i + 1,
+                .last_step = next.last_step,
+                .passage_size = static_cast<std::uint32_t>(next.passage.size()),
+                .confidence_sum = next.confidence_sum,
+                .grammar = next.grammar
+              };
+            }
+            extended.push_back(next);
+          }
+        );
+        // The choices are sorted by confidence, so the first choice not continuing the reference is its best end.
+        if(!extends && !ended && hypothesis.complete.last_step != detail::no_step)
+        {
+          ended = true;
+          candidates.push_back(detail::create_candidate(hypothesis, choices[c].confidence));
+        }
+      }
+    };
+    std::ranges::for_each(active, extend);
+    if(i <= symbol_index)
+    {
+      extend({.start = i, .state = automaton.root});
+    }
+
+    // Hypotheses of the same start symbol in the same grammar state read the same reference, so the best one is kept.
+    std::ranges::sort(
+      extended,
+      [&](const auto& a, const auto& b)
+      { return std::tuple_cat(key(a), std::tuple(score(b))) < std::tuple_cat(key(b), std::tuple(score(a))); }
+    );
+    const auto duplicates = std::ranges::unique(extended, [&](const auto& a, const auto& b) { return key(a) == key(b); });
+    extended.erase(duplicates.begin(), duplicates.end());
+    std::ranges::sort(
+      extended,
+      [&](const auto& a, const auto& b) { return std::tuple(a.start, score(b)) < std::tuple(b.start, score(a)); }
+    );
+    active.clear();
+    for(std::size_t e = 0, start_count = 0; e < extended.size(); ++e)
+    {
+      start_count = e > 0 && extended[e - 1].start == extended[e].start ? start_count + 1 : 0;
+      if(start_count < beam_width_)
+      {
+        active.push_back(extended[e]);
+      }
+    }
+  }
+  std::ranges::for_each(
+    active | std::views::filter([](const auto& h) { return h.complete.last_step != detail::no_step; }),
+    [&](const auto& h) { candidates.push_back(detail::create_candidate(h, std::nullopt)); }
+  );
+
+  // A complete state ended by several hypotheses is decoded once, with its best end.
+  std::ranges::sort(
+    candidates,
+    [](const auto& a, const auto& b)
+    { return std::tie(a.complete.last_step, b.confidence) < std::tie(b.complete.last_step, a.confidence); }
+  );
+  const auto duplicates = std::ranges::unique(candidates, {}, [](const auto& e) { return e.complete.last_step; });
+  candidates.erase(duplicates.begin(), duplicates.end());
+
+  auto decoded = std::vector<detail::decoded_reference>{};
+  auto scratch = core_bible_reference::parse_scratch{};
+  for(const auto& candidate : candidates | std::views::filter([&](const auto& e) { return e.complete.end > symbol_index; }))
+  {
+    const auto pattern = automaton.state_pattern(candidate.state);
+    const auto book_id = bible::book_name_variants_de::name_variants_list.at(pattern).first;
+    const auto passage = std::string_view(candidate.passage.data(), candidate.passage.size());
+    const auto& parse_result = bible_reference_.parse_passage(book_id, passage, scratch);
+    if(parse_result.ranges.empty())
+    {
+      continue;
+    }
+    auto choice_indices = std::vector<std::uint32_t>(candidate.complete.end - candidate.start);
+    for(auto s = candidate.complete.last_step; s != detail::no_step; s = steps[s].previous)
+    {
+      choice_indices.at(steps[s].symbol_index - candidate.start) = steps[s].choice_index;
+    }
+    decoded.push_back(
+      {.result = {.ranges = parse_result.ranges,
+                  .symbol_range = index_range_type{candidate.start, candidate.complete.end},
+                  .choice_indices = std::move(choice_indices),
+                  .confidence = candidate.confidence},
+       .pattern = pattern}
+    );
+  }
+
+  // Readings containing another reading of the same choices are resolved like overlapping books in the parser:
+  // The variant listed last wins.
+  const auto is_resolved = [&](const detail::decoded_reference& reference)
+  {
+    return std::ranges::none_of(
+      decoded,
+      [&](const auto& other)
+      {
+        return other.pattern > reference.pattern && (detail::is_contained(other.result, reference.result) ||
+                                                     detail::is_contained(reference.result, other.result));
+      }
+    );
+  };
+  auto resolved = std::vector<detail::decoded_reference>{};
+  std::ranges::copy_if(decoded, std::back_inserter(resolved), is_resolved);
+  std::ranges::stable_sort(
+    resolved,
+    [](const auto& a, const auto& b)
+    { return std::tie(a.result.confidence, a.pattern) > std::tie(b.result.confidence, b.pattern); }
+  );
+
+  auto result = std::vector<decode_result>{};
+  for(auto& reference : resolved)
+  {
+    if(result.size() >= max_results)
+    {
+      break;
+    }
+    if(std::ranges::none_of(result, [&](const auto& e) { return e.ranges == reference.result.ranges; }))
+    {
+      result.push_back(std::move(reference.result));
+    }
+  }
+  return result;
+}
+
+} // namespace bibstd::core
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "bible/reference_range.hpp"
+#include "core/core_bible_reference.hpp"
+#include "core/core_tesseract_common.hpp"
+#include "math/value_range.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bibstd::core
+{
+
+///
+/// Core reference lattice decoder. Decodes complete bible references, i.e. the book name, the numbers and the transition
+/// chars, directly from the choices of the recognized symbols with a single Viterbi-style traversal of the symbol choice
+/// lattice. At each symbol a hypothesis is started and all hypotheses are extended by the choices that continue the
+/// reference grammar: the book name is driven by the trie of all name variants, the passage accepts numbers, number
+/// postfixes and transition chars. Hypotheses of the same start symbol in the same grammar state are merged, and only the
+/// best hypotheses of each start symbol are kept. The decoded passages are matched with the passage grammar of
+/// `core_bible_reference`, so a decoded reference has the same reference ranges as the parsed text of its choices.
+///
+class core_reference_lattice_decoder final
+{
+public: // Typedefs
+  using tesseract_choice_arena = core_tesseract_common::tesseract_choice_arena;
+  using index_range_type = math::value_range<std::size_t>;
+
+  ///
+  /// Decoded bible reference.
+  /// \param ranges Reference ranges of the decoded reference
+  /// \param symbol_range Index range of the symbols of the decoded reference
+  /// \param choice_indices Index of the decoded choice within the choices of each symbol in the symbol range
+  /// \param confidence Combined OCR and grammar confidence in the range [0, 100] of the choice confidences
+  ///
+  struct decode_result final
+  {
+    std::vector<bible::reference_range> ranges;
+    index_range_type symbol_range;
+    std::vector<std::uint32_t> choice_indices;
+    double confidence;
+  };
+
+public: // Constants
+  static constexpr std::size_t default_beam_width = 8;
+
+  ///
+  /// Maximum number of digits of a passage number and maximum size of a decoded passage.
+  ///
+  static constexpr std::size_t max_number_digits = 3;
+  static constexpr std::size_t max_passage_size = 32;
+
+  ///
+  /// Grammar prior of a number postfix. Letters after a number are valid postfixes, but they are more often the misread
+  /// start of the following text, so a reading without the postfix is preferred at the same OCR confidence.
+  ///
+  static constexpr double postfix_prior = 0.8;
+
+public: // Structors
+  ///
+  /// Create reference lattice decoder. Throws std::invalid_argument if the beam width is zero.
+  /// \param beam_width Maximum number of hypotheses that are kept per start symbol
+  ///
+  explicit core_reference_lattice_decoder(std::size_t beam_width = default_beam_width);
+
+public: // Operations
+  ///
+  /// Decode the bible references containing the given symbol from the symbol choices.
+  /// The confidence of a reference is the mean confidence of its decoded choices and the choice ending it, multiplied by
+  /// the grammar priors of its passage. Readings the passage grammar rejects are not returned.
+  /// \param choice_arena OCR choices of all symbols, the choices of each symbol sorted by confidence in the range [0, 100]
+  /// \param symbol_index Index of the symbol that must be part of the decoded references, e.g. the symbol at the cursor
+  /// \param max_results Maximum number of returned references
+  /// \return decoded references with distinct reference ranges, sorted by confidence from the highest to the lowest
+  ///
+  [[nodiscard]] auto decode(const tesseract_choice_arena& choice_arena, std::size_t symbol_index, std::size_t max_results)
+    const -> std::vector<decode_result>;
+
+private: // Variables
+  const std::size_t beam_width_;
+  const core_bible_reference bible_reference_{};
+};
+
+} // namespace bibstd::core
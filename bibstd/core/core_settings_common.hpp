@@ -1,6 +1,7 @@
 #pragma once
 
 #include "bible/common.hpp"
+#include "core/core_tesseract_common.hpp"
 #include "meta/contains.hpp"
 #include "meta/for_each.hpp"
 #include "system/filesystem.hpp"
@@ -53,7 +54,11 @@ struct core_settings_common final
     bible::testament_id,
     std::vector<bible::testament_id>,
     bible::translation,
-    std::vector<bible::translation>>;
+    std::vector<bible::translation>,
+
+    // OCR types
+    core_tesseract_common::image_preprocessing,
+    core_tesseract_common::recognition_strategy>;
 
   ///
   /// Setting class.
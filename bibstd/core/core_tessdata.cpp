@@ -0,0 +1,41 @@
+#include "core/core_tessdata.hpp"
+
+#if defined(BIBLE_EMBED_TESSDATA)
+#include "util/incbin.hpp"
+
+// The traineddata of the selected models is placed in a read-only section of the binary.
+#if defined(BIBLE_EMBED_TESSDATA_FAST)
+INC_RESOURCE(tessdata_deu_fast, BIBLE_TESSDATA_FOLDER "/tessdata-fast/deu.traineddata");
+#endif
+#if defined(BIBLE_EMBED_TESSDATA_BEST)
+INC_RESOURCE(tessdata_deu_best, BIBLE_TESSDATA_FOLDER "/tessdata-best/deu.traineddata");
+#endif
+#endif
+
+namespace bibstd::core
+{
+
+///
+///
+auto embedded_traineddata(const core_tesseract_common::traineddata_id traineddata) -> std::span<const std::byte>
+{
+#if defined(BIBLE_EMBED_TESSDATA)
+  using language = core_tesseract_common::language;
+  using model = core_tesseract_common::model;
+#if defined(BIBLE_EMBED_TESSDATA_FAST)
+  if(traineddata == core_tesseract_common::traineddata_id{language::de, model::fast})
+  {
+    return util::incbin::to_span<std::byte>(res_tessdata_deu_fast_data, res_tessdata_deu_fast_size);
+  }
+#endif
+#if defined(BIBLE_EMBED_TESSDATA_BEST)
+  if(traineddata == core_tesseract_common::traineddata_id{language::de, model::best})
+  {
+    return util::incbin::to_span<std::byte>(res_tessdata_deu_best_data, res_tessdata_deu_best_size);
+  }
+#endif
+#endif
+  return {};
+}
+
+} // namespace bibstd::core
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "core/core_tesseract_common.hpp"
+
+#include <cstddef>
+#include <span>
+
+namespace bibstd::core
+{
+
+///
+/// Get traineddata that is embedded into the binary. Traineddata is only embedded if the project is configured with
+/// `BIBLE_EMBED_TESSDATA` and its model is listed in `BIBLE_EMBED_TESSDATA_MODELS`, otherwise it is loaded from the
+/// tessdata folder.
+/// \param traineddata Language and model of the traineddata
+/// \return traineddata, empty if the traineddata is not embedded
+///
+auto embedded_traineddata(core_tesseract_common::traineddata_id traineddata) -> std::span<const std::byte>;
+
+} // namespace bibstd::core
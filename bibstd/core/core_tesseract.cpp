@@ -1,12 +1,21 @@
 #include "core/core_tesseract.hpp"
+#include "core/core_tessdata.hpp"
+#include "data/luma.hpp"
 #include "data/pix.hpp"
 #include "util/boost_numeric_cast.hpp"
 #include "util/const_bimap.hpp"
 #include "util/enum.hpp"
+#include "util/exception.hpp"
 #include "util/log.hpp"
 
 #include <leptonica/allheaders.h>
 #include <tesseract/baseapi.h>
+#include <tesseract/ocrclass.h>
+
+#include <algorithm>
+#include <array>
+#include <format>
+#include <utility>
 
 namespace bibstd::core
 {
@@ -18,15 +27,141 @@ constexpr auto resolution_map = util::const_bimap{
   std::pair{     core_tesseract::text_resolution::line, tesseract::RIL_TEXTLINE},
   std::pair{core_tesseract::text_resolution::paragraph,     tesseract::RIL_PARA},
 };
+// The LSTM symbol choices are probabilities in [0, 1], the recognition confidences are in [0, 100].
+constexpr auto lstm_choice_confidence_scale = 100.0F;
+
+namespace detail
+{
 
 ///
+/// Get the bounding box of the current element of a page iterator.
+/// \param ri Page or result iterator
+/// \param level Page iterator level of the element
+/// \param origin Origin of the image area within the tesseract image, the box is relative to it
+/// \return bounding box, std::nullopt if tesseract reports an invalid box
 ///
-core_tesseract::core_tesseract(core_tesseract_common::language language)
-  : tesseract_{new tesseract::TessBaseAPI()}
+auto bounding_box(
+  const tesseract::PageIterator& ri,
+  const tesseract::PageIteratorLevel level,
+  const core_tesseract::screen_coordinates_type& origin
+) -> std::optional<core_tesseract::screen_rect_type>
+{
+  int left, top, right, bottom;
+  if(!ri.BoundingBox(level, &left, &top, &right, &bottom))
+  {
+    return std::nullopt;
+  }
+  left -= origin.x();
+  top -= origin.y();
+  right -= origin.x();
+  bottom -= origin.y();
+  if(left >= 0 && top >= 0 && right >= 1 && bottom >= 1)
+  {
+    using screen_rect_type = core_tesseract::screen_rect_type;
+    return screen_rect_type(screen_rect_type::coordinates_type(left, top), right - left, bottom - top);
+  }
+  return std::nullopt;
+}
+
+///
+/// Fill page with the recognition result in a single walk over all symbols.
+/// Elements with invalid bounding boxes are skipped.
+/// \param ri Result iterator positioned at the first symbol
+/// \param origin Origin of the image area within the tesseract image, the page boxes are relative to it
+/// \param page Page that is filled
+///
+auto fill_page(tesseract::ResultIterator& ri, const core_tesseract::screen_coordinates_type& origin, core_ocr_page& page)
+  -> void
+{
+  constexpr auto symbol_level = resolution_map.at(core_tesseract::text_resolution::character);
+  // Higher resolutions first, so the parents are begun before their children.
+  constexpr auto element_resolutions = std::array{
+    core_tesseract::text_resolution::paragraph, core_tesseract::text_resolution::line, core_tesseract::text_resolution::word
+  };
+  do
+  {
+    std::ranges::for_each(
+      element_resolutions,
+      [&](const auto resolution)
+      {
+        const auto level = resolution_map.at(resolution);
+        if(!ri.IsAtBeginningOf(level))
+        {
+          return;
+        }
+        if(const auto box = bounding_box(ri, level, origin))
+        {
+          page.begin_element(resolution, *box, ri.Confidence(level));
+        }
+        else
+        {
+          LOG_WARN("invalid bounding box in fill_page: resolution={}", util::to_string_view(resolution));
+        }
+      }
+    );
+    const std::unique_ptr<char[]> symbol(ri.GetUTF8Text(symbol_level));
+    const auto box = bounding_box(ri, symbol_level, origin);
+    if(!symbol || !box)
+    {
+      LOG_WARN("invalid symbol in fill_page: symbol={}", symbol ? symbol.get() : "");
+      continue;
+    }
+    page.add_symbol(symbol.get(), *box, ri.Confidence(symbol_level));
+    // Get confidence level for alternative symbol choices. Code is based on
+    // https://github.com/tesseract-ocr/tesseract/blob/main/src/api/hocrrenderer.cpp#L325-L344
+    // The choice probabilities are scaled like the hOCR x_confs, so all choices of a symbol share the symbol scale.
+    if(const auto choice_map = ri.GetBestLSTMSymbolChoices(); choice_map)
+    {
+      std::ranges::for_each(
+        *choice_map,
+        [&](const auto& timesteps)
+        {
+          std::ranges::for_each(
+            timesteps, [&](const auto& choice) { page.add_choice(choice.first, choice.second * lstm_choice_confidence_scale); }
+          );
+        }
+      );
+    }
+  }
+  while(ri.Next(symbol_level));
+}
+
+} // namespace detail
+
+///
+///
+core_tesseract::core_tesseract(const traineddata_id traineddata)
+  : traineddata_{traineddata}
+  , tesseract_{new tesseract::TessBaseAPI()}
   , pix_{std::make_unique<data::pix>()}
+  , page_{std::make_unique<core_ocr_page>()}
 {
-  const auto tessdata_string = tessdata_folder_path.generic_string();
-  tesseract_->Init(tessdata_string.data(), language_map.at(language).data(), tesseract::OEM_LSTM_ONLY);
+  const auto language_string = language_map.at(traineddata_.language).data();
+  // Embedded traineddata is loaded from memory, so no file of the tessdata folder is read.
+  const auto embedded = embedded_traineddata(traineddata_);
+  const auto model_folder_path = tessdata_folder_path / util::to_string_view(traineddata_.model);
+  const auto init_result =
+    embedded.empty()
+      ? tesseract_->Init(model_folder_path.generic_string().data(), language_string, tesseract::OEM_LSTM_ONLY)
+      : tesseract_->Init(
+          reinterpret_cast<const char*>(embedded.data()),
+          boost::numeric_cast<int>(embedded.size()),
+          language_string,
+          tesseract::OEM_LSTM_ONLY,
+          nullptr,
+          0,
+          nullptr,
+          nullptr,
+          false,
+          nullptr
+        );
+  if(init_result != 0)
+  {
+    const auto model_string = util::to_string_view(traineddata_.model);
+    THROW_EXCEPTION(
+      util::exception(std::format("failed to initialize tesseract: language={}, model={}", language_string, model_string))
+    );
+  }
   tesseract_->SetVariable("lstm_choice_mode", "2"); // set lstm_choice_mode to alternative symbol choices per character
 }
 
@@ -37,41 +172,130 @@ core_tesseract::~core_tesseract() noexcept
   tesseract_->End();
 }
 
+///
+///
+auto core_tesseract::traineddata() const -> traineddata_id
+{
+  return traineddata_;
+}
+
+///
+///
+auto core_tesseract::warm_up() -> void
+{
+  // A few dark blocks on a light background look like a text line, so the layout analysis and the LSTM recognizer both run.
+  auto pixel_plane = pixel_plane_type(warm_up_image_width, warm_up_image_height);
+  std::ranges::fill(pixel_plane.data, data::pixel{.red = 255, .green = 255, .blue = 255});
+  for(std::uint32_t y = warm_up_image_height / 4; y < 3 * warm_up_image_height / 4; ++y)
+  {
+    for(std::uint32_t x = warm_up_image_height / 4; x + warm_up_image_height / 4 < warm_up_image_width; ++x)
+    {
+      if((x / (warm_up_image_height / 4)) % 2 == 1)
+      {
+        pixel_plane.data[static_cast<std::size_t>(y) * warm_up_image_width + x] = data::pixel{};
+      }
+    }
+  }
+  const auto preprocessing = std::exchange(image_preprocessing_, image_preprocessing::none);
+  set_image(std::move(pixel_plane));
+  recognize(std::nullopt);
+  image_preprocessing_ = preprocessing;
+  tesseract_->Clear();
+  page_->clear();
+}
+
+///
+///
+auto core_tesseract::set_image_preprocessing(const image_preprocessing preprocessing) -> void
+{
+  image_preprocessing_ = preprocessing;
+}
+
 ///
 ///
 auto core_tesseract::set_image(pixel_plane_type&& pixel_plane) -> void
 {
-  pix_->update(std::forward<decltype(pixel_plane)>(pixel_plane));
+  if(image_preprocessing_ == image_preprocessing::none)
+  {
+    pix_->update(std::forward<decltype(pixel_plane)>(pixel_plane));
+  }
+  else
+  {
+    forward_image(data::plane_view<data::pixel>(pixel_plane));
+  }
+  image_plane_.reset();
+  image_area_ = screen_rect_type({0, 0}, pix_->width(), pix_->height());
   tesseract_->SetImage(pix_->get());
   tesseract_->SetPageSegMode(tesseract::PSM_AUTO_OSD);
+  page_->clear();
 }
 
 ///
+/// Without preprocessing the whole pixel plane is set as tesseract image once, since tesseract copies each image it is set.
+/// The sections of the plane are selected with a rectangle. The preprocessed images are converted per section.
+auto core_tesseract::set_image(std::shared_ptr<pixel_plane_type> pixel_plane, const screen_rect_type& section) -> void
+{
+  if(!pixel_plane)
+  {
+    THROW_EXCEPTION(std::invalid_argument("pixel plane is empty"));
+  }
+  const auto x = boost::numeric_cast<std::uint32_t>(section.origin().x());
+  const auto y = boost::numeric_cast<std::uint32_t>(section.origin().y());
+  const auto width = boost::numeric_cast<std::uint32_t>(section.horizontal_range());
+  const auto height = boost::numeric_cast<std::uint32_t>(section.vertical_range());
+  if(image_preprocessing_ != image_preprocessing::none)
+  {
+    forward_image(data::plane_view<data::pixel>(*pixel_plane, x, y, width, height));
+    image_plane_.reset();
+    image_area_ = screen_rect_type({0, 0}, pix_->width(), pix_->height());
+    tesseract_->SetImage(pix_->get());
+  }
+  else
+  {
+    // The section is checked before the rectangle is set, tesseract clips it silently.
+    [[maybe_unused]] const auto view = data::plane_view<data::pixel>(*pixel_plane, x, y, width, height);
+    if(image_plane_ != pixel_plane)
+    {
+      pix_->update(pixel_plane, 0, 0, pixel_plane->width, pixel_plane->height);
+      image_plane_ = std::move(pixel_plane);
+      tesseract_->SetImage(pix_->get());
+    }
+    image_area_ = section;
+    select_image_area(screen_rect_type({0, 0}, width, height));
+  }
+  tesseract_->SetPageSegMode(tesseract::PSM_AUTO_OSD);
+  page_->clear();
+}
+
 ///
-auto core_tesseract::recognize(std::optional<screen_rect_type> bounding_box) const -> bool
+///
+auto core_tesseract::recognize(std::optional<screen_rect_type> bounding_box, std::stop_token stop_token) const -> bool
 {
-  if(bounding_box && !pix_->pixels().empty())
+  // Tesseract polls the cancel function of the monitor while recognizing, so a stop request aborts the recognition early.
+  auto monitor = tesseract::ETEXT_DESC{};
+  monitor.cancel = [](void* cancel_this, int) { return static_cast<std::stop_token*>(cancel_this)->stop_requested(); };
+  monitor.cancel_this = &stop_token;
+  page_->clear();
+  if(bounding_box && !pix_->empty())
   {
-    auto pix_rect = screen_rect_type({0, 0}, pix_->width(), pix_->height());
-    const auto overlap = screen_rect_type::overlap(pix_rect, *bounding_box);
+    const auto image_rect = screen_rect_type({0, 0}, image_area_.horizontal_range(), image_area_.vertical_range());
+    const auto overlap = screen_rect_type::overlap(image_rect, *bounding_box);
     if(!overlap)
     {
       return true;
     }
-    pix_rect = overlap.value();
-    // Each SetRectangle clears the recognition results so multiple rectangles can be recognized with the same image.
-    tesseract_->SetRectangle(
-      boost::numeric_cast<int>(pix_rect.origin().x()),
-      boost::numeric_cast<int>(pix_rect.origin().y()),
-      boost::numeric_cast<int>(pix_rect.horizontal_range()),
-      boost::numeric_cast<int>(pix_rect.vertical_range())
-    );
-    return tesseract_->Recognize(nullptr) == 0;
+    select_image_area(*overlap);
   }
-  else
+  const auto success = tesseract_->Recognize(&monitor) == 0 && !stop_token.stop_requested();
+  if(success && !pix_->empty())
   {
-    return tesseract_->Recognize(nullptr) == 0;
+    std::unique_ptr<tesseract::ResultIterator> ri(tesseract_->GetIterator());
+    if(ri)
+    {
+      detail::fill_page(*ri, image_area_.origin(), *page_);
+    }
   }
+  return success;
 }
 
 ///
@@ -85,11 +309,9 @@ auto core_tesseract::bounding_boxes(const text_resolution resolution) const -> s
     const auto level = resolution_map.at(resolution);
     do
     {
-      int left, top, right, bottom;
-      const auto success = pi->BoundingBox(level, &left, &top, &right, &bottom);
-      if(success && left >= 0 && top >= 0 && right >= 1 && bottom >= 1)
+      if(const auto box = detail::bounding_box(*pi, level, image_area_.origin()))
       {
-        result.emplace_back(screen_rect_type(screen_coordinates_type(left, top), right - left, bottom - top));
+        result.push_back(*box);
       }
       else
       {
@@ -103,120 +325,91 @@ auto core_tesseract::bounding_boxes(const text_resolution resolution) const -> s
 
 ///
 ///
-auto core_tesseract::for_each(const text_resolution resolution, const text_callback_type& do_with_text) const -> void
-{
-  for_each_while(
-    resolution,
-    [&](const auto text, const auto& bounding_box)
-    {
-      do_with_text(text, bounding_box);
-      return true;
-    }
-  );
-}
-
-///
-///
-auto core_tesseract::for_each_while(const text_resolution resolution, const text_while_callback_type& do_with_text) const
-  -> void
+auto core_tesseract::layout_paragraphs() const -> std::vector<layout_paragraph>
 {
-  if(pix_->pixels().empty())
-  {
-    return;
-  }
-  std::unique_ptr<tesseract::ResultIterator> ri(tesseract_->GetIterator());
-  tesseract::PageIteratorLevel level = resolution_map.at(resolution);
-  if(ri)
+  auto result = std::vector<layout_paragraph>{};
+  std::unique_ptr<tesseract::PageIterator> pi(tesseract_->AnalyseLayout());
+  if(pi)
   {
-    auto found = true;
+    constexpr auto line_level = resolution_map.at(text_resolution::line);
+    constexpr auto paragraph_level = resolution_map.at(text_resolution::paragraph);
+    // Lines of a paragraph with an invalid bounding box are skipped with the paragraph.
+    auto valid_paragraph = false;
     do
     {
-      std::unique_ptr<char[]> txt(ri->GetUTF8Text(level));
-      if(txt)
+      if(pi->IsAtBeginningOf(paragraph_level))
       {
-        int left, top, right, bottom;
-        const auto success = ri->BoundingBox(level, &left, &top, &right, &bottom);
-        if(success && left >= 0 && top >= 0 && right >= 1 && bottom >= 1)
+        const auto paragraph_box = detail::bounding_box(*pi, paragraph_level, image_area_.origin());
+        valid_paragraph = paragraph_box.has_value();
+        if(valid_paragraph)
         {
-          const auto box = screen_rect_type(screen_coordinates_type(left, top), right - left, bottom - top);
-          found = do_with_text(std::string_view(txt.get()), box);
+          result.push_back(layout_paragraph{*paragraph_box, {}});
         }
         else
         {
-          LOG_WARN("invalid bounding box in for_each_while: txt={}", txt.get());
+          LOG_WARN(
+            "invalid bounding box in layout_paragraphs: resolution={}", util::to_string_view(text_resolution::paragraph)
+          );
         }
       }
+      if(!valid_paragraph)
+      {
+        continue;
+      }
+      if(const auto line_box = detail::bounding_box(*pi, line_level, image_area_.origin()))
+      {
+        result.back().line_bounding_boxes.push_back(*line_box);
+      }
+      else
+      {
+        LOG_WARN("invalid bounding box in layout_paragraphs: resolution={}", util::to_string_view(text_resolution::line));
+      }
     }
-    while(found && (ri->Next(level)));
+    while(pi->Next(line_level));
   }
+  return result;
 }
 
 ///
-///
-auto core_tesseract::for_each_choices(const choices_callback_type& do_with_choices) const -> void
+/// Each SetRectangle clears the recognition results so multiple rectangles can be recognized with the same image.
+auto core_tesseract::select_image_area(const screen_rect_type& area) const -> void
 {
-  for_each_choices_while(
-    [&](const auto& choices, const auto& bounding_box)
-    {
-      do_with_choices(choices, bounding_box);
-      return true;
-    }
+  tesseract_->SetRectangle(
+    boost::numeric_cast<int>(image_area_.origin().x() + area.origin().x()),
+    boost::numeric_cast<int>(image_area_.origin().y() + area.origin().y()),
+    boost::numeric_cast<int>(area.horizontal_range()),
+    boost::numeric_cast<int>(area.vertical_range())
   );
 }
 
 ///
 ///
-auto core_tesseract::for_each_choices_while(const choices_while_callback_type& do_with_choices) const -> void
+auto core_tesseract::forward_image(const data::plane_view<data::pixel>& pixels) -> void
 {
-  if(pix_->pixels().empty())
+  // Tesseract recognizes dark text on a light background best, so light on dark text is inverted first.
+  data::convert_to_luma(pixels, luma_);
+  auto histogram = data::create_luma_histogram(luma_);
+  if(data::has_dark_background(histogram))
   {
-    return;
+    data::invert(luma_);
+    // The histogram of the inverted image is the mirrored histogram.
+    std::ranges::reverse(histogram);
   }
-  std::unique_ptr<tesseract::ResultIterator> ri(tesseract_->GetIterator());
-  if(ri)
+  switch(image_preprocessing_)
   {
-    constexpr auto level = resolution_map.at(text_resolution::character);
-    auto found = true;
-    auto choices = tesseract_choices{};
-    do
-    {
-      // Get confidence level for alternative symbol choices. Code is based on
-      // https://github.com/tesseract-ocr/tesseract/blob/main/src/api/hocrrenderer.cpp#L325-L344
-      const auto choice_map = ri->GetBestLSTMSymbolChoices();
-
-      std::unique_ptr<char[]> main_symbol_data(ri->GetUTF8Text(level));
-      const auto main_symbol = std::string(main_symbol_data.get());
-
-      choices.clear();
-      if(choice_map && !choice_map->empty())
-      {
-        std::ranges::for_each(
-          *choice_map,
-          [&](const auto& timesteps)
-          {
-            std::ranges::for_each(
-              timesteps, [&](const auto& choice) { choices.emplace_back(std::string(choice.first), choice.second); }
-            );
-          }
-        );
-      }
-      choices.emplace_back(main_symbol, ri->Confidence(level));
-      std::ranges::sort(choices, [](const auto& a, const auto& b) { return a.confidence > b.confidence; });
-
-      int left, top, right, bottom;
-      const auto success = ri->BoundingBox(level, &left, &top, &right, &bottom);
-      if(success && left >= 0 && top >= 0 && right >= 1 && bottom >= 1)
-      {
-        const auto box = screen_rect_type(screen_coordinates_type(left, top), right - left, bottom - top);
-        found = do_with_choices(choices, box);
-      }
-      else
-      {
-        LOG_WARN("invalid bounding box in for_each_choices_while: main_symbol={}", main_symbol);
-      }
-    }
-    while(found && (ri->Next(level)));
+  case image_preprocessing::luma_otsu: data::binarize(luma_, data::otsu_threshold(histogram)); break;
+  case image_preprocessing::luma_sauvola: data::binarize_sauvola(luma_, sauvola_window_radius, sauvola_k); break;
+  case image_preprocessing::none:
+  case image_preprocessing::luma: break;
   }
+  pix_->update(luma_);
+}
+
+///
+///
+auto core_tesseract::page() const -> const core_ocr_page&
+{
+  return *page_;
 }
 
 } // namespace bibstd::core
@@ -1,10 +1,13 @@
 #pragma once
 
+#include "core/core_ocr_page.hpp"
 #include "core/core_tesseract_common.hpp"
 #include "system/filesystem.hpp"
 #include "util/screen_types.hpp"
 
+#include <memory>
 #include <optional>
+#include <stop_token>
 #include <string_view>
 
 // Forward declarations
@@ -25,6 +28,7 @@ namespace bibstd::core
 class core_tesseract final
 {
 public: // Constants
+  // The traineddata of each model is located in a subfolder named after the model, e.g. `tessdata/fast`.
   static constexpr std::string_view tessdata_folder_name = "tessdata";
   inline static const std::filesystem::path tessdata_folder_path{
     system::filesystem::executable_folder() / tessdata_folder_name
@@ -34,29 +38,40 @@ public: // Typedefs
   using screen_rect_type = util::screen_types::screen_rect_type;
   using screen_coordinates_type = util::screen_types::screen_coordinates_type;
   using pixel_plane_type = util::screen_types::pixel_plane_type;
-  using text_callback_type = std::function<void(std::string_view, const screen_rect_type&)>;
-  using text_while_callback_type = std::function<bool(std::string_view, const screen_rect_type&)>;
-  using tesseract_choice = core_tesseract_common::tesseract_choice;
-  using tesseract_choices = core_tesseract_common::tesseract_choices;
-
-  // clang-format off
-  using choices_callback_type = std::function<void(const tesseract_choices&, const screen_rect_type&)>;
-  using choices_while_callback_type = std::function<bool(const tesseract_choices&, const screen_rect_type&)>;
-  // clang-format on
-
-  enum class text_resolution
-  {
-    character,
-    word,
-    line,
-    paragraph,
-  };
+  using text_resolution = core_tesseract_common::text_resolution;
+  using image_preprocessing = core_tesseract_common::image_preprocessing;
+  using traineddata_id = core_tesseract_common::traineddata_id;
+  using layout_paragraph = core_tesseract_common::layout_paragraph;
 
 public: // Structors
-  core_tesseract(core_tesseract_common::language language);
+  ///
+  /// Initialize tesseract with the embedded traineddata or, if none is embedded, with the traineddata of the tessdata
+  /// folder. Throws util::exception if the initialization fails.
+  /// \param traineddata Language and model of the traineddata
+  ///
+  core_tesseract(traineddata_id traineddata);
   ~core_tesseract() noexcept;
 
+public: // Accessors
+  ///
+  /// Get the traineddata tesseract is initialized with.
+  /// \return language and model of the traineddata
+  ///
+  auto traineddata() const -> traineddata_id;
+
 public: // Modifiers
+  ///
+  /// Recognize a small synthetic image, so the lazy allocations of tesseract are done before the first real recognition.
+  /// The image and the page are cleared afterwards.
+  ///
+  auto warm_up() -> void;
+
+  ///
+  /// Set the preprocessing that is applied to the images set afterwards.
+  /// \param preprocessing Image preprocessing
+  ///
+  auto set_image_preprocessing(image_preprocessing preprocessing) -> void;
+
   ///
   /// Set image that shall be recognized with tesseract.
   /// \param pixel_plane Pixel plane that defines the image that shall be read with tesseract
@@ -64,11 +79,21 @@ public: // Modifiers
   auto set_image(pixel_plane_type&& pixel_plane) -> void;
 
   ///
-  /// Recognize image or sub-rectangle of image with tesseract.
+  /// Set a section of a shared pixel plane as image that shall be recognized with tesseract. Without preprocessing the plane
+  /// is set as tesseract image only once for all its sections, and each section is selected as rectangle of this image.
+  /// All coordinates reported by tesseract are relative to the section origin.
+  /// \param pixel_plane Pixel plane containing the image, it must not be modified while it is set
+  /// \param section Rectangle within the pixel plane that defines the image
+  ///
+  auto set_image(std::shared_ptr<pixel_plane_type> pixel_plane, const screen_rect_type& section) -> void;
+
+  ///
+  /// Recognize image or sub-rectangle of image with tesseract. On success the recognition result is stored in the page.
   /// \param bounding_box Optional rectangle within image to recognize, if not set the whole image is recognized.
-  /// \return true if recognition was successful, false otherwise
+  /// \param stop_token Optional stop token, the recognition is cancelled as soon as a stop is requested
+  /// \return true if recognition was successful, false otherwise or if it was cancelled
   ///
-  auto recognize(std::optional<screen_rect_type> bounding_box) const -> bool;
+  auto recognize(std::optional<screen_rect_type> bounding_box, std::stop_token stop_token = {}) const -> bool;
 
   ///
   /// Run tesseract analyze layout on image and list all bounding boxes.
@@ -78,42 +103,45 @@ public: // Modifiers
   auto bounding_boxes(text_resolution resolution) const -> std::vector<screen_rect_type>;
 
   ///
-  /// Run tesseract OCR on image.
-  /// \param resolution Text resolution
-  /// \param do_with_text Callback that is called for each parse found
-  ///
-  auto for_each(text_resolution resolution, const text_callback_type& do_with_text) const -> void;
-
-  ///
-  /// Run tesseract OCR on image with breakout condition.
-  /// \param resolution Text resolution
-  /// \param do_with_text Callback that is called for each parse found. If function returns true, the parsing is stopped.
+  /// Run tesseract analyze layout on image and list all paragraphs with their text lines. No text is recognized.
+  /// \return list of paragraphs
   ///
-  auto for_each_while(text_resolution resolution, const text_while_callback_type& do_with_text) const -> void;
+  auto layout_paragraphs() const -> std::vector<layout_paragraph>;
 
   ///
-  /// Run tesseract OCR on image.
-  /// \param do_with_choices Callback that is called for each symbol and its choices found. The choices are guaranteed to be non
-  /// empty and sorted by confidence.
+  /// Get the result of the last recognition. The page is empty if nothing was recognized since the image was set.
+  /// \return recognized page
   ///
-  auto for_each_choices(const choices_callback_type& do_with_choices) const -> void;
-
-  ///
-  /// Run tesseract OCR on image with breakout condition.
-  /// \param do_with_choices Callback that is called for each symbol and its choices found. The choices are guaranteed to be non
-  /// empty and sorted by confidence. If function returns true, the parsing is stopped.
-  ///
-  auto for_each_choices_while(const choices_while_callback_type& do_with_choices) const -> void;
+  auto page() const -> const core_ocr_page&;
 
 private: // Constants
+  static constexpr auto warm_up_image_width = std::uint32_t{96};
+  static constexpr auto warm_up_image_height = std::uint32_t{32};
+  static constexpr auto sauvola_window_radius = std::uint32_t{15};
+  static constexpr auto sauvola_k = 0.34;
   static constexpr auto language_map = util::const_bimap{
     std::pair{core_tesseract_common::language::de, std::string_view("deu")},
     // ...
   };
 
+private: // Implementation
+  ///
+  /// Select an area of the image for the following layout analysis and recognition.
+  /// \param area Area relative to the image area origin
+  ///
+  auto select_image_area(const screen_rect_type& area) const -> void;
+  auto forward_image(const data::plane_view<data::pixel>& pixels) -> void;
+
 private: // Variables
+  const traineddata_id traineddata_;
+  image_preprocessing image_preprocessing_{image_preprocessing::none};
+  data::plane<std::uint8_t> luma_;
   const std::unique_ptr<tesseract::TessBaseAPI> tesseract_;
   const std::unique_ptr<data::pix> pix_;
+  // Pixel plane that is set as tesseract image, the image area is the section of it that is recognized.
+  std::shared_ptr<pixel_plane_type> image_plane_;
+  screen_rect_type image_area_{{0, 0}, 0, 0};
+  const std::unique_ptr<core_ocr_page> page_;
 };
 
 } // namespace bibstd::core
@@ -3,10 +3,16 @@
 #include "data/pixel.hpp"
 #include "data/plane.hpp"
 #include "math/rect.hpp"
+#include "math/value_range.hpp"
 #include "util/const_bimap.hpp"
 #include "util/screen_types.hpp"
 
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <span>
 #include <string_view>
+#include <vector>
 
 namespace bibstd::core
 {
@@ -22,12 +28,99 @@ struct core_tesseract_common final
     de,
   };
 
+  ///
+  /// Traineddata model. The fast model uses integer weights and recognizes several times faster than the best model,
+  /// which recognizes low quality text more reliably.
+  ///
+  enum class model
+  {
+    fast,
+    best,
+  };
+
+  ///
+  /// Models used for the recognition. With `fast_then_best` the capture areas are recognized with the fast model. If its
+  /// result has no references or a low confidence, the paragraph at the cursor that the fast model found is recognized
+  /// once more with the best model, without a layout analysis.
+  ///
+  enum class recognition_strategy
+  {
+    fast,
+    best,
+    fast_then_best,
+  };
+
+  ///
+  /// Identifies the traineddata a tesseract engine is initialized with.
+  ///
+  struct traineddata_id final
+  {
+    core_tesseract_common::language language{core_tesseract_common::language::de};
+    core_tesseract_common::model model{core_tesseract_common::model::fast};
+    auto operator<=>(const traineddata_id&) const = default;
+  };
+
+  ///
+  /// Image preprocessing before the recognition. Without preprocessing the 32-bpp image is handed to tesseract, otherwise
+  /// an 8-bpp luma image with dark text on a light background, which is optionally binarized.
+  ///
+  enum class image_preprocessing
+  {
+    none,
+    luma,
+    luma_otsu,
+    luma_sauvola,
+  };
+
+  enum class text_resolution
+  {
+    character,
+    word,
+    line,
+    paragraph,
+  };
+
+  ///
+  /// Alternative of a recognized symbol. The symbol text is owned by the recognized page.
+  /// \param symbol Choice text
+  /// \param confidence Choice confidence in the range [0, 100], like the symbol confidences of tesseract
+  ///
   struct tesseract_choice final
   {
-    std::string symbol{""};
-    double confidence{0.0};
+    std::string_view symbol;
+    float confidence{0.0F};
+  };
+  using tesseract_choices = std::span<const tesseract_choice>;
+
+  ///
+  /// Choices of all symbols of a recognized page in one flat array. The choices of a symbol are stored consecutively and
+  /// sorted by confidence. The choice texts reference the page, so the arena is valid until the page is cleared.
+  /// \param choices Choices of all symbols
+  /// \param symbol_ranges Index range of the choices of each symbol
+  ///
+  struct tesseract_choice_arena final
+  {
+    std::vector<tesseract_choice> choices;
+    std::vector<math::value_range<std::uint32_t>> symbol_ranges;
+
+    auto size() const -> std::size_t { return symbol_ranges.size(); }
+    auto symbol_choices(const std::size_t symbol_index) const -> tesseract_choices
+    {
+      const auto& range = symbol_ranges[symbol_index];
+      return tesseract_choices(choices).subspan(range.begin, range.end - range.begin);
+    }
+  };
+
+  ///
+  /// Paragraph found by the layout analysis.
+  /// \param bounding_box Bounding box of the paragraph
+  /// \param line_bounding_boxes Bounding boxes of the text lines of the paragraph, from top to bottom
+  ///
+  struct layout_paragraph final
+  {
+    util::screen_types::screen_rect_type bounding_box;
+    std::vector<util::screen_types::screen_rect_type> line_bounding_boxes;
   };
-  using tesseract_choices = std::vector<tesseract_choice>;
 };
 
 } // namespace bibstd::core
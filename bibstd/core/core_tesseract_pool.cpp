@@ -0,0 +1,30 @@
+#include "core/core_tesseract_pool.hpp"
+#include "util/enum.hpp"
+#include "util/log.hpp"
+#include "util/scoped_timer.hpp"
+
+namespace bibstd::core
+{
+
+///
+///
+auto create_core_tesseract_pool(const core_tesseract_pool::limits limits) -> std::unique_ptr<core_tesseract_pool>
+{
+  return std::make_unique<core_tesseract_pool>(
+    [](const core_tesseract_common::traineddata_id traineddata)
+    {
+      const auto timer = util::scoped_timer("tesseract engine initialization");
+      auto engine = std::make_unique<core_tesseract>(traineddata);
+      engine->warm_up();
+      LOG_DEBUG(
+        "tesseract engine initialized: language={}, model={}",
+        util::to_string_view(traineddata.language),
+        util::to_string_view(traineddata.model)
+      );
+      return engine;
+    },
+    limits
+  );
+}
+
+} // namespace bibstd::core
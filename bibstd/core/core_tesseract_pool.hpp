@@ -0,0 +1,27 @@
+#pragma once
+
+#include "core/core_tesseract.hpp"
+#include "core/core_tesseract_common.hpp"
+#include "util/object_pool.hpp"
+
+#include <memory>
+
+namespace bibstd::core
+{
+
+///
+/// Pool of initialized tesseract engines per traineddata (language and model). An engine is checked out to one thread at
+/// a time and returned to the pool when its lease is destroyed, so the model initialization is paid once per engine and
+/// not per recognition.
+///
+using core_tesseract_pool = util::object_pool<core_tesseract_common::traineddata_id, core_tesseract>;
+
+///
+/// Create a pool of tesseract engines. No engine is initialized until the first checkout or reserve.
+/// Each engine runs a warm-up recognition when it is created \see core_tesseract::warm_up.
+/// \param limits Limits of the engine count per traineddata
+/// \return tesseract pool
+///
+auto create_core_tesseract_pool(core_tesseract_pool::limits limits) -> std::unique_ptr<core_tesseract_pool>;
+
+} // namespace bibstd::core
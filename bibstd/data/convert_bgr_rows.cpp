@@ -0,0 +1,242 @@
+#include "data/convert_bgr_rows.hpp"
+#include "util/exception.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <immintrin.h>
+#endif
+
+namespace bibstd::data
+{
+namespace detail
+{
+
+// Typedefs
+using row_function = void (*)(const std::byte*, pixel*, std::uint32_t);
+
+// Constants
+constexpr auto luma_block_size = std::uint32_t{256};
+static_assert(sizeof(pixel) == 4);
+
+///
+/// Convert a single source pixel.
+///
+inline auto convert_pixel(const std::byte* source) -> pixel
+{
+  return pixel{
+    .red = static_cast<std::uint8_t>(source[2]),
+    .green = static_cast<std::uint8_t>(source[1]),
+    .blue = static_cast<std::uint8_t>(source[0]),
+    .alpha = 0,
+  };
+}
+
+///
+/// Scalar conversion of the pixels from x to the end of the row.
+///
+template<std::uint16_t BytesPerPixel>
+inline auto convert_row_tail(const std::byte* source, pixel* pixels, std::uint32_t x, const std::uint32_t width) -> void
+{
+  for(; x < width; ++x)
+  {
+    pixels[x] = convert_pixel(source + static_cast<std::size_t>(x) * BytesPerPixel);
+  }
+}
+
+///
+///
+template<std::uint16_t BytesPerPixel>
+auto convert_row_scalar(const std::byte* source, pixel* pixels, const std::uint32_t width) -> void
+{
+  convert_row_tail<BytesPerPixel>(source, pixels, 0, width);
+}
+
+#if defined(__SSE2__)
+///
+/// Four 32 bit pixels per iteration. Red and blue are swapped with shifts and masks, the unused byte is cleared.
+///
+auto convert_row_sse2_32(const std::byte* source, pixel* pixels, const std::uint32_t width) -> void
+{
+  const auto byte_mask = _mm_set1_epi32(0xff);
+  const auto green_mask = _mm_set1_epi32(0xff00);
+  auto x = std::uint32_t{0};
+  for(; x + 4 <= width; x += 4)
+  {
+    const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + static_cast<std::size_t>(x) * 4));
+    const auto red = _mm_and_si128(_mm_srli_epi32(v, 16), byte_mask);
+    const auto green = _mm_and_si128(v, green_mask);
+    const auto blue = _mm_slli_epi32(_mm_and_si128(v, byte_mask), 16);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + x), _mm_or_si128(_mm_or_si128(red, green), blue));
+  }
+  convert_row_tail<4>(source, pixels, x, width);
+}
+#endif
+
+#if defined(__SSE2__) && defined(__GNUC__)
+///
+/// Eight 32 bit pixels per iteration with a byte shuffle.
+///
+__attribute__((target("avx2"))) auto convert_row_avx2_32(const std::byte* source, pixel* pixels, const std::uint32_t width)
+  -> void
+{
+  const auto shuffle = _mm256_setr_epi8(
+    2, 1, 0, -1, 6, 5, 4, -1, 10, 9, 8, -1, 14, 13, 12, -1, 2, 1, 0, -1, 6, 5, 4, -1, 10, 9, 8, -1, 14, 13, 12, -1
+  );
+  auto x = std::uint32_t{0};
+  for(; x + 8 <= width; x += 8)
+  {
+    const auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + static_cast<std::size_t>(x) * 4));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels + x), _mm256_shuffle_epi8(v, shuffle));
+  }
+  convert_row_tail<4>(source, pixels, x, width);
+}
+
+///
+/// Eight 24 bit pixels per iteration. Each 128 bit lane loads four pixels (12 bytes) and spreads them to 16 bytes.
+/// The second load reads 16 bytes starting at byte 12, so the loop stops while at least 28 bytes are left in the row.
+///
+__attribute__((target("avx2"))) auto convert_row_avx2_24(const std::byte* source, pixel* pixels, const std::uint32_t width)
+  -> void
+{
+  const auto shuffle = _mm256_setr_epi8(
+    2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1
+  );
+  auto x = std::uint32_t{0};
+  for(; x + 10 <= width; x += 8)
+  {
+    const auto* row = source + static_cast<std::size_t>(x) * 3;
+    const auto low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row));
+    const auto high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + 12));
+    const auto v = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels + x), _mm256_shuffle_epi8(v, shuffle));
+  }
+  convert_row_tail<3>(source, pixels, x, width);
+}
+#endif
+
+///
+/// Select the row conversion for a kernel and pixel size.
+///
+auto select_row_function(const bgr_kernel kernel, const std::uint16_t bytes_per_pixel) -> row_function
+{
+  if(!is_available(kernel))
+  {
+    THROW_EXCEPTION(std::invalid_argument("bgr kernel not available"));
+  }
+  const auto is_24_bit = bytes_per_pixel == 3;
+  switch(kernel)
+  {
+#if defined(__SSE2__)
+  case bgr_kernel::sse2: return is_24_bit ? &convert_row_scalar<3> : &convert_row_sse2_32;
+#endif
+#if defined(__SSE2__) && defined(__GNUC__)
+  case bgr_kernel::avx2: return is_24_bit ? &convert_row_avx2_24 : &convert_row_avx2_32;
+#endif
+  default: return is_24_bit ? &convert_row_scalar<3> : &convert_row_scalar<4>;
+  }
+}
+
+///
+/// Validate the source layout.
+///
+auto validate(const bgr_rows& source) -> void
+{
+  if(source.bytes_per_pixel != 3 && source.bytes_per_pixel != 4)
+  {
+    THROW_EXCEPTION(std::invalid_argument("bgr rows must have 3 or 4 bytes per pixel"));
+  }
+  if(source.pitch < static_cast<std::size_t>(source.width) * source.bytes_per_pixel)
+  {
+    THROW_EXCEPTION(std::invalid_argument("bgr rows pitch too small"));
+  }
+  if(source.data == nullptr && source.width != 0 && source.height != 0)
+  {
+    THROW_EXCEPTION(std::invalid_argument("bgr rows without data"));
+  }
+}
+
+///
+/// Get the first byte of an output row in the source.
+///
+inline auto source_row(const bgr_rows& source, const std::uint32_t y) -> const std::byte*
+{
+  const auto source_y = source.bottom_up ? source.height - 1 - y : y;
+  return source.data + static_cast<std::size_t>(source_y) * source.pitch;
+}
+
+} // namespace detail
+
+///
+///
+auto is_available(const bgr_kernel kernel) -> bool
+{
+  switch(kernel)
+  {
+  case bgr_kernel::scalar: return true;
+#if defined(__SSE2__)
+  case bgr_kernel::sse2: return true;
+#endif
+#if defined(__SSE2__) && defined(__GNUC__)
+  case bgr_kernel::avx2: return __builtin_cpu_supports("avx2");
+#endif
+  default: return false;
+  }
+}
+
+///
+///
+auto best_bgr_kernel() -> bgr_kernel
+{
+  static const auto kernel = is_available(bgr_kernel::avx2)   ? bgr_kernel::avx2
+                             : is_available(bgr_kernel::sse2) ? bgr_kernel::sse2
+                                                              : bgr_kernel::scalar;
+  return kernel;
+}
+
+///
+///
+auto convert_bgr_rows(const bgr_rows& source, plane<pixel>& pixels, const bgr_kernel kernel) -> void
+{
+  detail::validate(source);
+  const auto convert_row = detail::select_row_function(kernel, source.bytes_per_pixel);
+  pixels.width = source.width;
+  pixels.height = source.height;
+  pixels.data.resize(static_cast<std::size_t>(source.width) * source.height);
+  for(std::uint32_t y = 0; y < source.height; ++y)
+  {
+    convert_row(detail::source_row(source, y), pixels.data.data() + static_cast<std::size_t>(y) * source.width, source.width);
+  }
+}
+
+///
+///
+auto convert_bgr_rows(const bgr_rows& source, luma_plane& luma, const bgr_kernel kernel) -> void
+{
+  detail::validate(source);
+  const auto convert_row = detail::select_row_function(kernel, source.bytes_per_pixel);
+  luma.width = source.width;
+  luma.height = source.height;
+  luma.data.resize(static_cast<std::size_t>(source.width) * source.height);
+
+  // The rows are converted in blocks small enough to stay in the L1 cache, so no full pixel plane is created.
+  auto block = std::array<pixel, detail::luma_block_size>{};
+  for(std::uint32_t y = 0; y < source.height; ++y)
+  {
+    const auto* row = detail::source_row(source, y);
+    auto* luma_row = luma.data.data() + static_cast<std::size_t>(y) * source.width;
+    for(std::uint32_t x = 0; x < source.width; x += detail::luma_block_size)
+    {
+      const auto count = std::min(detail::luma_block_size, source.width - x);
+      convert_row(row + static_cast<std::size_t>(x) * source.bytes_per_pixel, block.data(), count);
+      convert_row_to_luma(block.data(), luma_row + x, count);
+    }
+  }
+}
+
+} // namespace bibstd::data
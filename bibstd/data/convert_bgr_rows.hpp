@@ -0,0 +1,68 @@
+#pragma once
+
+#include "data/luma.hpp"
+#include "data/pixel.hpp"
+#include "data/plane.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bibstd::data
+{
+
+///
+/// Rows of 24 or 32 bit pixels with blue, green, red (and unused) byte order, as delivered by screen capture APIs.
+/// Rows start `pitch` bytes apart, so padded rows (e.g. Windows device independent bitmaps) are supported.
+///
+struct bgr_rows final
+{
+  // Variables
+  const std::byte* data{nullptr};
+  std::uint32_t width{0};
+  std::uint32_t height{0};
+  std::size_t pitch{0};
+  std::uint16_t bytes_per_pixel{pixel::bytes_per_pixel};
+  bool bottom_up{false};
+};
+
+///
+/// Implementation used to convert the rows.
+///
+enum class bgr_kernel
+{
+  scalar,
+  sse2,
+  avx2,
+};
+
+///
+/// Check if a kernel can be used on this build and CPU.
+/// \param kernel Kernel to check
+/// \return true if the kernel is available, false otherwise
+///
+auto is_available(bgr_kernel kernel) -> bool;
+
+///
+/// Get the fastest kernel available on this build and CPU.
+/// \return kernel
+///
+auto best_bgr_kernel() -> bgr_kernel;
+
+///
+/// Convert BGR rows to pixels. Rows of a bottom up source are flipped, so the first row of the plane is the top row.
+/// Throws std::invalid_argument if the source layout is invalid or the kernel is not available.
+/// \param source Rows that are converted
+/// \param pixels Plane receiving the pixels, it is resized to the size of the source
+/// \param kernel Implementation used for the conversion
+///
+auto convert_bgr_rows(const bgr_rows& source, plane<pixel>& pixels, bgr_kernel kernel = best_bgr_kernel()) -> void;
+
+///
+/// Convert BGR rows directly to luma without creating a full pixel plane \see convert_to_luma.
+/// \param source Rows that are converted
+/// \param luma Plane receiving the luma values, it is resized to the size of the source
+/// \param kernel Implementation used for the conversion
+///
+auto convert_bgr_rows(const bgr_rows& source, luma_plane& luma, bgr_kernel kernel = best_bgr_kernel()) -> void;
+
+} // namespace bibstd::data
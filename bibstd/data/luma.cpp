@@ -0,0 +1,208 @@
+#include "data/luma.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace bibstd::data
+{
+namespace detail
+{
+
+// Constants
+constexpr auto luma_red_weight = std::uint32_t{77};
+constexpr auto luma_green_weight = std::uint32_t{150};
+constexpr auto luma_blue_weight = std::uint32_t{29};
+static_assert(luma_red_weight + luma_green_weight + luma_blue_weight == 256);
+static_assert(sizeof(pixel) == 4);
+
+} // namespace detail
+
+///
+///
+auto convert_row_to_luma(const pixel* pixels, std::uint8_t* luma, const std::uint32_t width) -> void
+{
+  using detail::luma_blue_weight, detail::luma_green_weight, detail::luma_red_weight;
+  auto x = std::uint32_t{0};
+#if defined(__SSE2__)
+  // Eight pixels per iteration. The pixel bytes are widened to 16 bit and multiplied with the weights, where madd sums the
+  // red and green as well as the blue and alpha products to 32 bit. Adding the neighbouring 32 bit lanes gives the luma sum.
+  const auto zero = _mm_setzero_si128();
+  const auto weights = _mm_setr_epi16(
+    luma_red_weight, luma_green_weight, luma_blue_weight, 0, luma_red_weight, luma_green_weight, luma_blue_weight, 0
+  );
+  const auto luma_of_four = [&](const __m128i block)
+  {
+    const auto low = _mm_madd_epi16(_mm_unpacklo_epi8(block, zero), weights);
+    const auto high = _mm_madd_epi16(_mm_unpackhi_epi8(block, zero), weights);
+    const auto low_sums = _mm_shuffle_epi32(_mm_add_epi32(low, _mm_srli_epi64(low, 32)), _MM_SHUFFLE(3, 3, 2, 0));
+    const auto high_sums = _mm_shuffle_epi32(_mm_add_epi32(high, _mm_srli_epi64(high, 32)), _MM_SHUFFLE(3, 3, 2, 0));
+    return _mm_srli_epi32(_mm_unpacklo_epi64(low_sums, high_sums), 8);
+  };
+  for(; x + 8 <= width; x += 8)
+  {
+    const auto first = luma_of_four(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + x)));
+    const auto second = luma_of_four(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + x + 4)));
+    const auto packed = _mm_packus_epi16(_mm_packs_epi32(first, second), zero);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(luma + x), packed);
+  }
+#endif
+  for(; x < width; ++x)
+  {
+    const auto& p = pixels[x];
+    const auto sum = luma_red_weight * p.red + luma_green_weight * p.green + luma_blue_weight * p.blue;
+    luma[x] = static_cast<std::uint8_t>(sum >> 8);
+  }
+}
+
+///
+///
+auto convert_to_luma(const plane_view<pixel>& pixels, luma_plane& luma) -> void
+{
+  luma.width = pixels.width;
+  luma.height = pixels.height;
+  luma.data.resize(static_cast<std::size_t>(pixels.width) * pixels.height);
+  for(std::uint32_t y = 0; y < pixels.height; ++y)
+  {
+    convert_row_to_luma(pixels.row(y), luma.data.data() + static_cast<std::size_t>(y) * luma.width, pixels.width);
+  }
+}
+
+///
+///
+auto create_luma_histogram(const luma_plane& luma) -> luma_histogram
+{
+  // Four partial histograms, so runs of equal values do not wait for the increment of the same counter.
+  auto partial = std::array<luma_histogram, 4>{};
+  const auto size = luma.data.size();
+  auto i = std::size_t{0};
+  for(; i + 4 <= size; i += 4)
+  {
+    ++partial[0][luma.data[i]];
+    ++partial[1][luma.data[i + 1]];
+    ++partial[2][luma.data[i + 2]];
+    ++partial[3][luma.data[i + 3]];
+  }
+  for(; i < size; ++i)
+  {
+    ++partial[0][luma.data[i]];
+  }
+  auto result = luma_histogram{};
+  for(std::size_t value = 0; value < result.size(); ++value)
+  {
+    result[value] = partial[0][value] + partial[1][value] + partial[2][value] + partial[3][value];
+  }
+  return result;
+}
+
+///
+///
+auto has_dark_background(const luma_histogram& histogram) -> bool
+{
+  const auto dark = std::accumulate(histogram.cbegin(), histogram.cbegin() + 128, std::uint64_t{0});
+  const auto light = std::accumulate(histogram.cbegin() + 128, histogram.cend(), std::uint64_t{0});
+  return dark > light;
+}
+
+///
+///
+auto invert(luma_plane& luma) -> void
+{
+  std::ranges::for_each(luma.data, [](auto& value) { value = static_cast<std::uint8_t>(255 - value); });
+}
+
+///
+///
+auto otsu_threshold(const luma_histogram& histogram) -> std::uint8_t
+{
+  auto total_count = std::uint64_t{0};
+  auto total_sum = std::uint64_t{0};
+  for(std::size_t i = 0; i < histogram.size(); ++i)
+  {
+    total_count += histogram[i];
+    total_sum += i * histogram[i];
+  }
+  auto result = std::uint8_t{0};
+  auto max_variance = -1.0;
+  auto dark_count = std::uint64_t{0};
+  auto dark_sum = std::uint64_t{0};
+  for(std::size_t i = 0; i < histogram.size(); ++i)
+  {
+    dark_count += histogram[i];
+    dark_sum += i * histogram[i];
+    const auto light_count = total_count - dark_count;
+    if(dark_count == 0 || light_count == 0)
+    {
+      continue;
+    }
+    const auto dark_mean = static_cast<double>(dark_sum) / static_cast<double>(dark_count);
+    const auto light_mean = static_cast<double>(total_sum - dark_sum) / static_cast<double>(light_count);
+    const auto variance =
+      static_cast<double>(dark_count) * static_cast<double>(light_count) * (dark_mean - light_mean) * (dark_mean - light_mean);
+    if(variance > max_variance)
+    {
+      max_variance = variance;
+      result = static_cast<std::uint8_t>(i);
+    }
+  }
+  return result;
+}
+
+///
+///
+auto binarize(luma_plane& luma, const std::uint8_t threshold) -> void
+{
+  std::ranges::for_each(luma.data, [threshold](auto& value) { value = value <= threshold ? 0 : 255; });
+}
+
+///
+///
+auto binarize_sauvola(luma_plane& luma, const std::uint32_t window_radius, const double k) -> void
+{
+  // Integral images with an additional leading row and column of zeros, so the window sums need no bounds checks.
+  const auto width = static_cast<std::size_t>(luma.width);
+  const auto height = static_cast<std::size_t>(luma.height);
+  const auto stride = width + 1;
+  auto sums = std::vector<std::uint64_t>(stride * (height + 1), 0);
+  auto squared_sums = std::vector<std::uint64_t>(stride * (height + 1), 0);
+  for(std::size_t y = 0; y < height; ++y)
+  {
+    auto row_sum = std::uint64_t{0};
+    auto row_squared_sum = std::uint64_t{0};
+    for(std::size_t x = 0; x < width; ++x)
+    {
+      const auto value = std::uint64_t{luma.data[y * width + x]};
+      row_sum += value;
+      row_squared_sum += value * value;
+      sums[(y + 1) * stride + x + 1] = sums[y * stride + x + 1] + row_sum;
+      squared_sums[(y + 1) * stride + x + 1] = squared_sums[y * stride + x + 1] + row_squared_sum;
+    }
+  }
+  const auto window_sum = [&](const auto& integral, const auto x0, const auto y0, const auto x1, const auto y1)
+  { return integral[y1 * stride + x1] - integral[y0 * stride + x1] - integral[y1 * stride + x0] + integral[y0 * stride + x0]; };
+  for(std::size_t y = 0; y < height; ++y)
+  {
+    const auto y0 = y > window_radius ? y - window_radius : 0;
+    const auto y1 = std::min(height, y + window_radius + 1);
+    for(std::size_t x = 0; x < width; ++x)
+    {
+      const auto x0 = x > window_radius ? x - window_radius : 0;
+      const auto x1 = std::min(width, x + window_radius + 1);
+      const auto count = static_cast<double>((x1 - x0) * (y1 - y0));
+      const auto mean = static_cast<double>(window_sum(sums, x0, y0, x1, y1)) / count;
+      const auto variance = static_cast<double>(window_sum(squared_sums, x0, y0, x1, y1)) / count - mean * mean;
+      const auto deviation = std::sqrt(std::max(variance, 0.0));
+      const auto threshold = mean * (1.0 + k * (deviation / 128.0 - 1.0));
+      auto& value = luma.data[y * width + x];
+      value = static_cast<double>(value) <= threshold ? 0 : 255;
+    }
+  }
+}
+
+} // namespace bibstd::data
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "data/pixel.hpp"
+#include "data/plane.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace bibstd::data
+{
+
+///
+/// Luma plane with one 8 bit brightness value per pixel.
+///
+using luma_plane = plane<std::uint8_t>;
+
+///
+/// Histogram of luma values.
+///
+using luma_histogram = std::array<std::uint32_t, 256>;
+
+///
+/// Convert pixels to luma using the integer BT.601 weights `(77 * red + 150 * green + 29 * blue) / 256`.
+/// \param pixels Pixels that are converted
+/// \param luma Luma plane receiving the result, it is resized to the size of the pixels
+///
+auto convert_to_luma(const plane_view<pixel>& pixels, luma_plane& luma) -> void;
+
+///
+/// Convert a row of pixels to luma \see convert_to_luma.
+/// \param pixels First pixel of the row
+/// \param luma First luma value of the row
+/// \param width Number of pixels in the row
+///
+auto convert_row_to_luma(const pixel* pixels, std::uint8_t* luma, std::uint32_t width) -> void;
+
+///
+/// Count the luma values.
+/// \param luma Luma plane
+/// \return histogram of the luma values
+///
+auto create_luma_histogram(const luma_plane& luma) -> luma_histogram;
+
+///
+/// Detect light text on a dark background. The background is assumed to cover most of the image.
+/// \param histogram Luma histogram of the image
+/// \return true if most pixels are dark, false otherwise
+///
+auto has_dark_background(const luma_histogram& histogram) -> bool;
+
+///
+/// Invert all luma values.
+/// \param luma Luma plane that is inverted
+///
+auto invert(luma_plane& luma) -> void;
+
+///
+/// Get the global threshold separating the luma values into two classes with maximal between class variance (Otsu).
+/// \param histogram Luma histogram of the image
+/// \return threshold, values less or equal to the threshold belong to the dark class
+///
+auto otsu_threshold(const luma_histogram& histogram) -> std::uint8_t;
+
+///
+/// Binarize luma values with a global threshold. Values less or equal to the threshold become 0, others 255.
+/// \param luma Luma plane that is binarized
+/// \param threshold Global threshold
+///
+auto binarize(luma_plane& luma, std::uint8_t threshold) -> void;
+
+///
+/// Binarize luma values with the local Sauvola threshold `mean * (1 + k * (deviation / 128 - 1))` of the window around each
+/// pixel. Mean and deviation are calculated in constant time per pixel from integral images.
+/// \param luma Luma plane that is binarized
+/// \param window_radius Window radius, the window size is `2 * window_radius + 1`
+/// \param k Sauvola sensitivity factor
+///
+auto binarize_sauvola(luma_plane& luma, std::uint32_t window_radius, double k) -> void;
+
+} // namespace bibstd::data
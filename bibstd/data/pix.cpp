@@ -3,8 +3,11 @@
 #include <leptonica/imageio.h>
 
 #include <algorithm>
+#include <bit>
+#include <cstring>
 #include <ranges>
 #include <string_view>
+#include <utility>
 
 namespace bibstd::data
 {
@@ -14,10 +17,15 @@ namespace detail
 ///
 /// Forward the pixels struct as a leptonica PIX struct.
 /// The pixels object is not copied and must live longer than the PIX object.
+/// The rows of the view must be contiguous, because leptonica copies `wpl * height` words from the data pointer.
 /// \param pix Pixels, that shall be referenced to a leptonica PIX struct
 ///
-auto forward_as_pix(plane<pixel>& data) -> Pix
+auto forward_as_pix(const plane_view<pixel>& data) -> Pix
 {
+  if(data.pitch != data.width)
+  {
+    THROW_EXCEPTION(std::runtime_error("pix rows are not contiguous"));
+  }
   return Pix{
     /*l_uint32          */ data.width,                                   // width in pixels
     /*l_uint32          */ data.height,                                  // height in pixels
@@ -31,7 +39,43 @@ auto forward_as_pix(plane<pixel>& data) -> Pix
     /*l_int32           */ 0,                                            // special instructions for I/O, etc
     /*char              */ nullptr,                                      // text string associated with pix
     /*struct PixColormap*/ nullptr,                                      // colormap (may be null)
-    /*l_uint32          */ reinterpret_cast<l_uint32*>(data.data.data()) // the image data
+    /*l_uint32          */ reinterpret_cast<l_uint32*>(data.data)        // the image data
+  };
+}
+
+///
+/// Forward a luma plane as an 8-bpp leptonica PIX struct. Leptonica stores the bytes of each 32 bit word from the most to the
+/// least significant byte, so on little endian machines the luma bytes of each word are swapped while copying.
+/// \param luma Luma plane that is copied
+/// \param words Word buffer receiving the pix lines, it must live longer than the PIX object
+///
+auto forward_as_pix(const plane<std::uint8_t>& luma, std::vector<std::uint32_t>& words) -> Pix
+{
+  const auto words_per_line = (luma.width + 3) / 4;
+  words.assign(static_cast<std::size_t>(words_per_line) * luma.height, 0);
+  for(std::uint32_t y = 0; y < luma.height; ++y)
+  {
+    const auto line = words.data() + static_cast<std::size_t>(y) * words_per_line;
+    std::memcpy(line, luma.data.data() + static_cast<std::size_t>(y) * luma.width, luma.width);
+    if constexpr(std::endian::native == std::endian::little)
+    {
+      std::for_each(line, line + words_per_line, [](auto& word) { word = std::byteswap(word); });
+    }
+  }
+  return Pix{
+    /*l_uint32          */ luma.width,                                   // width in pixels
+    /*l_uint32          */ luma.height,                                  // height in pixels
+    /*l_uint32          */ 8u,                                           // depth in bits
+    /*l_uint32          */ 1u,                                           // number of samples per pixel
+    /*l_uint32          */ words_per_line,                               // 32-bit words/line
+    /*l_uint32          */ 1u,                                           // reference count (1 if no clones)
+    /*l_int32           */ 0,                                            // image res (ppi) in x direction (use 0 if unknown)
+    /*l_int32           */ 0,                                            // image res (ppi) in y direction (use 0 if unknown)
+    /*l_int32           */ IFF_UNKNOWN,                                  // input file format, IFF_*
+    /*l_int32           */ 0,                                            // special instructions for I/O, etc
+    /*char              */ nullptr,                                      // text string associated with pix
+    /*struct PixColormap*/ nullptr,                                      // colormap (may be null)
+    /*l_uint32          */ reinterpret_cast<l_uint32*>(words.data())     // the image data
   };
 }
 
@@ -40,8 +84,9 @@ auto forward_as_pix(plane<pixel>& data) -> Pix
 ///
 ///
 pix::pix(std::uint32_t width, std::uint32_t height)
-  : data_{width, height}
-  , pix_{detail::forward_as_pix(data_)}
+  : data_{std::make_shared<plane<pixel>>(width, height)}
+  , view_{*data_}
+  , pix_{detail::forward_as_pix(view_)}
 {
 }
 
@@ -49,7 +94,9 @@ pix::pix(std::uint32_t width, std::uint32_t height)
 ///
 pix::pix(pix&& other) noexcept
   : data_{std::move(other.data_)}
-  , pix_{std::move(other.pix_)}
+  , view_{std::exchange(other.view_, {})}
+  , luma_words_{std::move(other.luma_words_)}
+  , pix_{std::exchange(other.pix_, {})}
 {
 }
 
@@ -58,7 +105,9 @@ pix::pix(pix&& other) noexcept
 auto pix::operator=(pix&& other) & noexcept -> pix&
 {
   data_ = std::move(other.data_);
-  pix_ = std::move(other.pix_);
+  view_ = std::exchange(other.view_, {});
+  luma_words_ = std::move(other.luma_words_);
+  pix_ = std::exchange(other.pix_, {});
   return *this;
 }
 
@@ -66,21 +115,21 @@ auto pix::operator=(pix&& other) & noexcept -> pix&
 ///
 auto pix::width() const -> std::uint32_t
 {
-  return data_.width;
+  return pix_.w;
 }
 
 ///
 ///
 auto pix::height() const -> std::uint32_t
 {
-  return data_.height;
+  return pix_.h;
 }
 
 ///
 ///
-auto pix::pixels() const -> const plane<pixel>::data_type&
+auto pix::empty() const -> bool
 {
-  return data_.data;
+  return pix_.w == 0 || pix_.h == 0;
 }
 
 ///
@@ -94,12 +143,61 @@ auto pix::get() -> Pix*
 ///
 auto pix::update(plane<pixel>&& pixel_plane) -> void
 {
-  data_ = std::move(pixel_plane);
-  if(data_.data.size() < static_cast<std::size_t>(data_.width) * static_cast<std::size_t>(data_.height))
+  if(pixel_plane.data.size() < static_cast<std::size_t>(pixel_plane.width) * static_cast<std::size_t>(pixel_plane.height))
+  {
+    THROW_EXCEPTION(std::runtime_error("invalid data update"));
+  }
+  const auto width = pixel_plane.width;
+  const auto height = pixel_plane.height;
+  update(std::make_shared<plane<pixel>>(std::move(pixel_plane)), 0, 0, width, height);
+}
+
+///
+///
+auto pix::update(
+  std::shared_ptr<plane<pixel>> pixel_plane,
+  const std::uint32_t x,
+  const std::uint32_t y,
+  const std::uint32_t width,
+  const std::uint32_t height
+) -> void
+{
+  if(!pixel_plane)
+  {
+    THROW_EXCEPTION(std::runtime_error("invalid data update"));
+  }
+  const auto section = plane_view<pixel>(*pixel_plane, x, y, width, height);
+  if(section.pitch == section.width)
+  {
+    // The rows of the section are contiguous, so the shared plane is referenced in place.
+    view_ = section;
+    data_ = std::move(pixel_plane);
+  }
+  else
+  {
+    auto packed = std::make_shared<plane<pixel>>(width, height);
+    for(std::uint32_t row = 0; row < height; ++row)
+    {
+      std::copy_n(section.row(row), width, packed->data.data() + static_cast<std::size_t>(row) * width);
+    }
+    view_ = plane_view<pixel>(*packed);
+    data_ = std::move(packed);
+  }
+  luma_words_.clear();
+  pix_ = detail::forward_as_pix(view_);
+}
+
+///
+///
+auto pix::update(const plane<std::uint8_t>& luma) -> void
+{
+  if(luma.data.size() < static_cast<std::size_t>(luma.width) * static_cast<std::size_t>(luma.height))
   {
     THROW_EXCEPTION(std::runtime_error("invalid data update"));
   }
-  pix_ = detail::forward_as_pix(data_);
+  data_.reset();
+  view_ = {};
+  pix_ = detail::forward_as_pix(luma, luma_words_);
 }
 
 } // namespace bibstd::data
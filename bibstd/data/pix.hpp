@@ -6,6 +6,8 @@
 #include <leptonica/pix_internal.h>
 
 #include <functional>
+#include <memory>
+#include <vector>
 
 namespace bibstd::data
 {
@@ -40,10 +42,10 @@ public: // Accessors
   auto height() const -> std::uint32_t;
 
   ///
-  /// Get a reference to the pix data.
-  /// \return reference to the pix data
+  /// Check if the pix has no pixels.
+  /// \return true if width or height is zero, false otherwise
   ///
-  auto pixels() const -> const plane<pixel>::data_type&;
+  auto empty() const -> bool;
 
   ///
   /// Get the pointer to the leptonica Pix struct.
@@ -58,9 +60,31 @@ public: // Modifiers
   ///
   auto update(plane<pixel>&& pixel_plane) -> void;
 
+  ///
+  /// Update the pix data with a section of a shared pixel plane. If the rows of the section are contiguous, the pixels are
+  /// not copied and the pix shares the ownership of the pixel plane, which must not be modified while it is referenced.
+  /// Otherwise the rows of the section are packed into a pixel plane owned by the pix.
+  /// \param pixel_plane Pixel plane that is referenced by the pix
+  /// \param x Column of the first pixel of the section
+  /// \param y Row of the first pixel of the section
+  /// \param width Width of the section
+  /// \param height Height of the section
+  ///
+  auto update(
+    std::shared_ptr<plane<pixel>> pixel_plane, std::uint32_t x, std::uint32_t y, std::uint32_t width, std::uint32_t height
+  ) -> void;
+
+  ///
+  /// Update the pix data with an 8 bit luma plane. The luma values are copied into the 8-bpp leptonica line layout.
+  /// \param luma Luma plane that is used to update the data of pix
+  ///
+  auto update(const plane<std::uint8_t>& luma) -> void;
+
 private: // Members
-  plane<pixel> data_;
-  Pix pix_;
+  std::shared_ptr<plane<pixel>> data_;
+  plane_view<pixel> view_;
+  std::vector<std::uint32_t> luma_words_;
+  Pix pix_{};
 };
 
 } // namespace bibstd::data
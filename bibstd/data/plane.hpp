@@ -1,6 +1,9 @@
 #pragma once
 
+#include "util/exception.hpp"
+
 #include <cstdint>
+#include <stdexcept>
 #include <vector>
 
 namespace bibstd::data
@@ -27,6 +30,46 @@ struct plane final
   data_type data;
 };
 
+///
+/// Non-owning view of a rectangular section of a plane. Rows of the view are `pitch` objects apart,
+/// so a sub-rectangle of a plane is referenced without copying. The viewed plane must outlive the view.
+///
+template<typename T>
+struct plane_view final
+{
+  // Typedefs
+  using value_type = T;
+
+  // Structors
+  plane_view() = default;
+
+  ///
+  /// Create view of a section of a plane. Throws if the section is not within the plane.
+  /// \param source Plane that is viewed
+  /// \param x Column of the first object of the view in the plane
+  /// \param y Row of the first object of the view in the plane
+  /// \param width Width of the view
+  /// \param height Height of the view
+  ///
+  plane_view(plane<T>& source, std::uint32_t x, std::uint32_t y, std::uint32_t width, std::uint32_t height);
+
+  ///
+  /// Create view of a whole plane.
+  /// \param source Plane that is viewed
+  ///
+  explicit plane_view(plane<T>& source);
+
+  // Accessors
+  auto empty() const -> bool { return width == 0 || height == 0; }
+  auto row(std::uint32_t y) const -> T* { return data + static_cast<std::size_t>(y) * pitch; }
+
+  // Variables
+  T* data{nullptr};
+  std::uint32_t width{0};
+  std::uint32_t height{0};
+  std::uint32_t pitch{0};
+};
+
 ///
 ///
 template<typename T>
@@ -37,4 +80,30 @@ plane<T>::plane(std::uint32_t width_, std::uint32_t height_)
 {
 }
 
+///
+///
+template<typename T>
+plane_view<T>::plane_view(
+  plane<T>& source, const std::uint32_t x, const std::uint32_t y, const std::uint32_t width_, const std::uint32_t height_
+)
+  : width{width_}
+  , height{height_}
+  , pitch{source.width}
+{
+  if(std::uint64_t{x} + width_ > source.width || std::uint64_t{y} + height_ > source.height ||
+     source.data.size() < static_cast<std::size_t>(source.width) * source.height)
+  {
+    THROW_EXCEPTION(std::out_of_range("plane view outside of plane"));
+  }
+  data = source.data.data() + static_cast<std::size_t>(y) * pitch + x;
+}
+
+///
+///
+template<typename T>
+plane_view<T>::plane_view(plane<T>& source)
+  : plane_view(source, 0, 0, source.width, source.height)
+{
+}
+
 } // namespace bibstd::data
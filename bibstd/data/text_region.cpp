@@ -0,0 +1,246 @@
+#include "data/text_region.hpp"
+#include "util/exception.hpp"
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+namespace bibstd::data
+{
+namespace detail
+{
+
+///
+/// Rows or columns `[begin, end)` of a projection profile containing text.
+///
+struct profile_run final
+{
+  std::uint32_t begin;
+  std::uint32_t end;
+
+  auto size() const -> std::uint32_t { return end - begin; }
+};
+
+///
+/// Downsample a luma plane by averaging blocks of `factor * factor` values. Incomplete blocks at the right and bottom
+/// border are dropped.
+///
+auto downsample(const luma_plane& luma, const std::uint32_t factor, luma_plane& result) -> void
+{
+  result.width = luma.width / factor;
+  result.height = luma.height / factor;
+  result.data.resize(static_cast<std::size_t>(result.width) * result.height);
+  // The values of a block are summed with loops over whole rows, which are vectorized by the compiler. The sums are
+  // divided by a fixed point multiplication with the reciprocal block size, since a division per value is slow.
+  const auto reciprocal = static_cast<std::uint32_t>(((std::uint64_t{1} << 24) + factor * factor - 1) / (factor * factor));
+  auto sums = std::vector<std::uint32_t>(result.width);
+  for(std::uint32_t y = 0; y < result.height; ++y)
+  {
+    std::ranges::fill(sums, 0);
+    for(std::uint32_t row = y * factor; row < (y + 1) * factor; ++row)
+    {
+      const auto* values = luma.data.data() + static_cast<std::size_t>(row) * luma.width;
+      for(std::uint32_t offset = 0; offset < factor; ++offset)
+      {
+        for(std::uint32_t x = 0; x < result.width; ++x)
+        {
+          sums[x] += values[x * factor + offset];
+        }
+      }
+    }
+    auto* result_row = result.data.data() + static_cast<std::size_t>(y) * result.width;
+    for(std::uint32_t x = 0; x < result.width; ++x)
+    {
+      result_row[x] = static_cast<std::uint8_t>((sums[x] * reciprocal) >> 24);
+    }
+  }
+}
+
+///
+/// Find the runs of non-zero profile values. Runs separated by a gap of at most `max_gap` are merged, so e.g. the dots of
+/// the letter i do not form lines on their own.
+///
+auto find_runs(const std::vector<std::uint32_t>& profile, const std::uint32_t max_gap) -> std::vector<profile_run>
+{
+  auto result = std::vector<profile_run>{};
+  for(std::uint32_t i = 0; i < profile.size(); ++i)
+  {
+    if(profile[i] == 0)
+    {
+      continue;
+    }
+    if(!result.empty() && i - result.back().end <= max_gap)
+    {
+      result.back().end = i + 1;
+    }
+    else
+    {
+      result.push_back(profile_run{i, i + 1});
+    }
+  }
+  return result;
+}
+
+///
+/// Find the run containing a position or, if there is none, the closest run within its own size.
+///
+auto find_run_at(const std::vector<profile_run>& runs, const std::uint32_t position) -> std::optional<std::size_t>
+{
+  auto result = std::optional<std::size_t>{};
+  auto min_distance = std::uint32_t{0};
+  for(std::size_t i = 0; i < runs.size(); ++i)
+  {
+    const auto& run = runs[i];
+    const auto distance = position < run.begin ? run.begin - position : (position >= run.end ? position + 1 - run.end : 0);
+    if(distance <= run.size() && (!result || distance < min_distance))
+    {
+      result = i;
+      min_distance = distance;
+    }
+  }
+  return result;
+}
+
+///
+/// Find the extent of the non-zero profile values around a position. The extent ends at gaps larger than `max_gap`.
+///
+auto find_extent(const std::vector<std::uint32_t>& profile, const std::uint32_t position, const std::uint32_t max_gap)
+  -> std::optional<profile_run>
+{
+  auto begin = std::optional<std::uint32_t>{};
+  for(std::uint32_t i = position + 1, gap = 0; i > 0 && gap <= max_gap; --i)
+  {
+    gap = profile[i - 1] != 0 ? 0 : gap + 1;
+    begin = gap == 0 ? std::make_optional(i - 1) : begin;
+  }
+  auto end = std::optional<std::uint32_t>{};
+  for(std::uint32_t i = position, gap = 0; i < profile.size() && gap <= max_gap; ++i)
+  {
+    gap = profile[i] != 0 ? 0 : gap + 1;
+    end = gap == 0 ? std::make_optional(i + 1) : end;
+  }
+  if(!begin && !end)
+  {
+    return std::nullopt;
+  }
+  return profile_run{begin.value_or(position), end.value_or(position + 1)};
+}
+
+} // namespace detail
+
+///
+///
+auto find_text_region(
+  const luma_plane& luma,
+  const std::int32_t x,
+  const std::int32_t y,
+  const std::uint32_t line_band_half_width,
+  const std::uint32_t downsample
+) -> std::optional<text_region>
+{
+  if(downsample == 0)
+  {
+    THROW_EXCEPTION(std::invalid_argument("text region downsample factor must not be zero"));
+  }
+  auto small = luma_plane{};
+  detail::downsample(luma, downsample, small);
+  if(x < 0 || y < 0 || static_cast<std::uint32_t>(x) / downsample >= small.width ||
+     static_cast<std::uint32_t>(y) / downsample >= small.height)
+  {
+    return std::nullopt;
+  }
+  const auto small_x = static_cast<std::uint32_t>(x) / downsample;
+  const auto small_y = static_cast<std::uint32_t>(y) / downsample;
+
+  // The text is the smaller of the two Otsu classes, so dark text on light background and light text on dark background
+  // are both found. An image with a single luma value contains no text.
+  const auto histogram = create_luma_histogram(small);
+  if(std::ranges::count_if(histogram, [](const auto count) { return count != 0; }) < 2)
+  {
+    return std::nullopt;
+  }
+  const auto threshold = otsu_threshold(histogram);
+  const auto dark_count = std::accumulate(histogram.cbegin(), histogram.cbegin() + threshold + 1, std::uint64_t{0});
+  const auto dark_text = 2 * dark_count <= small.data.size();
+  auto is_text = std::array<std::uint8_t, 256>{};
+  for(std::size_t value = 0; value < is_text.size(); ++value)
+  {
+    is_text[value] = (value <= threshold) == dark_text ? 1 : 0;
+  }
+  const auto row_values = [&](const std::uint32_t row)
+  { return small.data.data() + static_cast<std::size_t>(row) * small.width; };
+
+  // Text lines are found in the row profile of a band around the position, so text of neighbouring columns is ignored.
+  const auto band_half_width = std::max(std::uint32_t{1}, line_band_half_width / downsample);
+  const auto band_begin = small_x - std::min(small_x, band_half_width);
+  const auto band_end = std::min(small.width, small_x + band_half_width + 1);
+  auto rows = std::vector<std::uint32_t>(small.height);
+  for(std::uint32_t row = 0; row < small.height; ++row)
+  {
+    const auto* values = row_values(row);
+    for(auto column = band_begin; column < band_end; ++column)
+    {
+      rows[row] += is_text[values[column]];
+    }
+  }
+  const auto lines = detail::find_runs(rows, 1);
+  const auto cursor_line = detail::find_run_at(lines, small_y);
+  if(!cursor_line)
+  {
+    return std::nullopt;
+  }
+
+  // Neighbouring lines belong to the paragraph if their height is similar and the gap is smaller than the line height.
+  const auto line_height = lines[*cursor_line].size();
+  const auto same_paragraph = [&](const detail::profile_run& line, const std::uint32_t gap)
+  { return gap < line_height && 2 * line.size() >= line_height && line.size() <= 2 * line_height; };
+  auto first_line = *cursor_line;
+  while(first_line > 0 && same_paragraph(lines[first_line - 1], lines[first_line].begin - lines[first_line - 1].end))
+  {
+    --first_line;
+  }
+  auto last_line = *cursor_line;
+  while(last_line + 1 < lines.size() && same_paragraph(lines[last_line + 1], lines[last_line + 1].begin - lines[last_line].end))
+  {
+    ++last_line;
+  }
+  const auto line_count = static_cast<std::uint32_t>(last_line - first_line + 1);
+  const auto line_pitch =
+    line_count > 1 ? (lines[last_line].begin - lines[first_line].begin) / (line_count - 1) : line_height;
+
+  // Gaps between words are smaller than the line height, gaps between columns of text are larger.
+  const auto paragraph_rows = detail::profile_run{lines[first_line].begin, lines[last_line].end};
+  auto columns = std::vector<std::uint32_t>(small.width);
+  for(auto row = paragraph_rows.begin; row < paragraph_rows.end; ++row)
+  {
+    const auto* values = row_values(row);
+    for(std::uint32_t column = 0; column < small.width; ++column)
+    {
+      columns[column] += is_text[values[column]];
+    }
+  }
+  const auto paragraph_columns = detail::find_extent(columns, small_x, line_height + line_height / 2);
+  if(!paragraph_columns)
+  {
+    return std::nullopt;
+  }
+
+  const auto scale = [&](const std::uint32_t small_value) { return static_cast<std::int32_t>(small_value * downsample); };
+  const auto rect = [&](const detail::profile_run& horizontal, const detail::profile_run& vertical)
+  {
+    return text_region::rect_type(
+      {scale(horizontal.begin), scale(vertical.begin)}, scale(horizontal.size()), scale(vertical.size())
+    );
+  };
+  return text_region{
+    .paragraph = rect(*paragraph_columns, paragraph_rows),
+    .line = rect(*paragraph_columns, lines[*cursor_line]),
+    .char_height = line_height * downsample,
+    .line_pitch = line_pitch * downsample,
+    .line_count = line_count,
+  };
+}
+
+} // namespace bibstd::data
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "data/luma.hpp"
+#include "math/rect.hpp"
+
+#include <cstdint>
+#include <optional>
+
+namespace bibstd::data
+{
+
+///
+/// Text region around a position, estimated without OCR.
+/// \param paragraph Bounding box of the text block containing the position
+/// \param line Bounding box of the text line closest to the position, it spans the width of the paragraph
+/// \param char_height Estimated character height, which is the height of the line
+/// \param line_pitch Estimated distance between the tops of two consecutive lines, the line height for a single line
+/// \param line_count Number of lines of the paragraph
+///
+struct text_region final
+{
+  // Typedefs
+  using rect_type = math::rect<std::int32_t>;
+
+  // Variables
+  rect_type paragraph;
+  rect_type line;
+  std::uint32_t char_height;
+  std::uint32_t line_pitch;
+  std::uint32_t line_count;
+};
+
+///
+/// Estimate the text region around a position from projection profiles of the downsampled and binarized luma plane.
+/// The row profile of a band around the position finds the text lines, neighbouring lines of similar height with small
+/// gaps form the paragraph. The column profile of the paragraph rows finds the horizontal paragraph extents.
+/// Throws std::invalid_argument if the downsample factor is zero.
+/// \param luma Luma plane
+/// \param x Column of the position
+/// \param y Row of the position
+/// \param line_band_half_width Half width of the column band around the position used for the row profile
+/// \param downsample Factor by which the plane is downsampled in both directions before the profiles are calculated
+/// \return text region, std::nullopt if there is no text line close to the position
+///
+auto find_text_region(
+  const luma_plane& luma, std::int32_t x, std::int32_t y, std::uint32_t line_band_half_width, std::uint32_t downsample = 2
+) -> std::optional<text_region>;
+
+} // namespace bibstd::data
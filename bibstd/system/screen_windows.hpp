@@ -1,18 +1,20 @@
 #pragma once
 
+#include "data/convert_bgr_rows.hpp"
 #include "system/windows.hpp"
 #include "util/boost_numeric_cast.hpp"
 #include "util/exception.hpp"
 #include "util/log.hpp"
 #include "util/screen_types.hpp"
 
-#include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstddef>
 #include <expected>
 #include <mutex>
 #include <optional>
-#include <ranges>
+#include <string>
+#include <string_view>
 
 namespace bibstd::system
 {
@@ -49,6 +51,14 @@ public: // Static accessors
   ///
   [[nodiscard]] static inline auto window_at(screen_coordinates_type coordinates) -> std::optional<screen_rect_type>;
 
+  ///
+  /// Get the name of the application owning the top level window at a given position. The name is the executable file
+  /// name, or the window class name if the process cannot be queried. If no window is found, std::nullopt is returned.
+  /// \param coordinates Screen coordinates
+  /// \return application name
+  ///
+  [[nodiscard]] static inline auto application_at(screen_coordinates_type coordinates) -> std::optional<std::string>;
+
   ///
   /// Capture screen in region defined by a rectangle. The rectangle shall be in the
   /// screen coordinate system, where the origin is on the top left corner.
@@ -108,6 +118,39 @@ inline auto screen::window_at(const screen_coordinates_type coordinates) -> std:
   return std::nullopt;
 }
 
+///
+/// Processes of other users or elevated processes cannot be queried, their windows are identified by the class name.
+inline auto screen::application_at(const screen_coordinates_type coordinates) -> std::optional<std::string>
+{
+  // This should be set with a application manifest. This did not work
+  // We set the Dpi awareness explicitly for this process.
+  SetThreadDpiAwarenessContext(DPI_AWARENESS_CONTEXT_PER_MONITOR_AWARE_V2);
+  const auto hwnd = WindowFromPoint(POINT{coordinates.x(), coordinates.y()});
+  if(hwnd == nullptr)
+  {
+    return std::nullopt;
+  }
+  const auto root = GetAncestor(hwnd, GA_ROOT);
+  const auto window = root != nullptr ? root : hwnd;
+  DWORD process_id = 0;
+  GetWindowThreadProcessId(window, &process_id);
+  if(const auto process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, process_id); process != nullptr)
+  {
+    auto path = std::array<char, MAX_PATH>{};
+    auto size = static_cast<DWORD>(path.size());
+    const auto queried = QueryFullProcessImageNameA(process, 0, path.data(), &size);
+    CloseHandle(process);
+    if(queried)
+    {
+      const auto image_path = std::string_view(path.data(), size);
+      return std::string{image_path.substr(image_path.find_last_of("\\/") + 1)};
+    }
+  }
+  auto class_name = std::array<char, 256>{};
+  const auto length = GetClassNameA(window, class_name.data(), static_cast<int>(class_name.size()));
+  return length > 0 ? std::make_optional(std::string(class_name.data(), static_cast<std::size_t>(length))) : std::nullopt;
+}
+
 ///
 ///
 inline auto screen::capture(const screen_rect_type rect, pixel_plane_type& pix) -> bool
@@ -152,37 +195,20 @@ inline auto screen::capture(const screen_rect_type rect, pixel_plane_type& pix)
   ReleaseDC(nullptr, hdc);
   assert(info.bmiHeader.biBitCount >= 24);
 
-  // The loaded pixel bytes are saved to a list of pixels in a row reversed order.
-  // This order makes the bitmap data directly compatible with tesseract.
-  // Since the Windows screen coordinate system origin is on top left,
-  // the highest row is the lowest row in the coordinate system of tesseract,
-  // where the origin is on the bottom left.
-  const auto byte_count = info.bmiHeader.biBitCount / 8;
+  // The device independent bitmap rows are stored bottom up and padded to 4 bytes.
+  // The rows are flipped, so the first row of the plane is the top row of the captured area.
+  const auto bit_count = info.bmiHeader.biBitCount;
   const auto height = boost::numeric_cast<std::uint32_t>(info.bmiHeader.biHeight);
   const auto width = boost::numeric_cast<std::uint32_t>(info.bmiHeader.biWidth);
-  pix.width = width;
-  pix.height = height;
-  if(pix.data.size() < height * width)
-  {
-    pix.data.resize(height * width);
-  }
-  std::ranges::for_each(
-    std::views::iota(std::size_t{0}, height) | std::views::reverse,
-    [&, counter = 0u](const auto row_idx) mutable
-    {
-      std::ranges::for_each(
-        std::views::iota(width * row_idx, width * (row_idx + 1)),
-        [&](const auto index)
-        {
-          const auto i = counter++ * byte_count;
-          auto& p = pix.data.at(index);
-          p.blue = static_cast<std::uint8_t>(pixels_bytes[i + 0]);
-          p.green = static_cast<std::uint8_t>(pixels_bytes[i + 1]);
-          p.red = static_cast<std::uint8_t>(pixels_bytes[i + 2]);
-        }
-      );
-    }
-  );
+  const auto source = data::bgr_rows{
+    .data = pixels_bytes.data(),
+    .width = width,
+    .height = height,
+    .pitch = ((static_cast<std::size_t>(width) * bit_count + 31) / 32) * 4,
+    .bytes_per_pixel = static_cast<std::uint16_t>(bit_count / 8),
+    .bottom_up = true,
+  };
+  data::convert_bgr_rows(source, pix);
   return true;
 }
 
@@ -25,9 +25,10 @@ struct tray_base
     std::span<const std::byte> buffer;
   };
 
+  // A label with an id can change its text later \see tray::set_label_text
   // clang-format off
   struct button final { std::string text; std::function<void()> callback; };
-  struct label final { std::string text; };
+  struct label final { std::string text; std::string id{}; };
   struct separator final {};
   struct toggle final { std::string text; bool state; std::function<std::function<void()>(bool)> callback; };
   // clang-format on
@@ -12,9 +12,12 @@
 #include <algorithm>
 #include <cassert>
 #include <future>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <ranges>
 #include <source_location>
+#include <string>
 
 namespace bibstd::system
 {
@@ -27,13 +30,23 @@ class tray final : public tray_base
 public: // Static modifiers
   static inline auto init(icon_buffer icon, std::vector<entry_type>&& entries) -> util::scoped_guard;
 
+  ///
+  /// Change the text of a label. Labels without id and unknown ids are ignored.
+  /// \param id Id of the label
+  /// \param text New text of the label
+  ///
+  static inline auto set_label_text(std::string id, std::string text) -> void;
+
 private: // Static helpers
   static auto get_message() -> void;
 
 private:
+  inline static std::mutex mutex_{};
   inline static std::unique_ptr<app_framework::active_worker> worker_{};
   inline static std::unique_ptr<Tray::Tray> tray_{nullptr};
   inline static std::map<int, std::function<void()>> callback_map_{};
+  inline static std::map<std::string, std::shared_ptr<Tray::TrayEntry>> labels_{};
+  inline static DWORD thread_id_{0};
 };
 
 ///
@@ -62,7 +75,16 @@ inline auto tray::init(const icon_buffer icon, std::vector<entry_type>&& entries
           app_framework::thread_pool::queue_task(std::move(f));
         };
       };
+      thread_id_ = GetCurrentThreadId();
       tray_ = std::make_unique<Tray::Tray>("system_tray_identifier", Tray::Icon(icon.buffer));
+      const auto add_label = [&](auto& parent, const label& v)
+      {
+        const auto entry = parent.addEntry(Tray::Label(v.text));
+        if(!v.id.empty())
+        {
+          labels_[v.id] = entry;
+        }
+      };
       std::ranges::for_each(
         entries,
         [&](const auto& entry)
@@ -70,7 +92,7 @@ inline auto tray::init(const icon_buffer icon, std::vector<entry_type>&& entries
           util::visit_lambdas(
             entry,
             [&](const button& v) { tray_->addEntry(Tray::Button(v.text, void_callback_wrapper(v.callback))); },
-            [&](const label& v) { tray_->addEntry(Tray::Label(v.text)); },
+            [&](const label& v) { add_label(*tray_, v); },
             [&](const separator& v) { tray_->addEntry(Tray::Separator()); },
             [&](const toggle& v) { tray_->addEntry(Tray::Toggle(v.text, v.state, toggle_callback_wrapper(v.callback))); },
             [&](const submenu& submenu)
@@ -83,7 +105,7 @@ inline auto tray::init(const icon_buffer icon, std::vector<entry_type>&& entries
                   util::visit_lambdas(
                     submenu_entry,
                     [&](const button& v) { submenu_sptr->addEntry(Tray::Button(v.text, void_callback_wrapper(v.callback))); },
-                    [&](const label& v) { submenu_sptr->addEntry(Tray::Label(v.text)); },
+                    [&](const label& v) { add_label(*submenu_sptr, v); },
                     [&](const separator& v) { submenu_sptr->addEntry(Tray::Separator()); },
                     [&](const toggle& v)
                     { submenu_sptr->addEntry(Tray::Toggle(v.text, v.state, toggle_callback_wrapper(v.callback))); }
@@ -102,11 +124,36 @@ inline auto tray::init(const icon_buffer icon, std::vector<entry_type>&& entries
   return util::scoped_guard(
     []()
     {
+      // Labels may be changed from other threads until the worker is gone, so the worker is reset under the lock first.
+      const auto lock = std::scoped_lock(mutex_);
       tray_->exit();
-      tray_.reset();
       worker_.reset();
+      labels_.clear();
+      tray_.reset();
+    }
+  );
+}
+
+///
+///
+inline auto tray::set_label_text(std::string id, std::string text) -> void
+{
+  const auto lock = std::scoped_lock(mutex_);
+  if(!worker_)
+  {
+    return;
+  }
+  // The menu is owned by the tray thread. The task runs after the message loop wakes up, so a message is posted.
+  worker_->queue_task(
+    [id = std::move(id), text = std::move(text)]() mutable
+    {
+      if(const auto iter = labels_.find(id); iter != labels_.cend())
+      {
+        iter->second->setText(std::move(text));
+      }
     }
   );
+  PostThreadMessage(thread_id_, WM_NULL, 0, 0);
 }
 
 ///
@@ -0,0 +1,358 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+namespace bibstd::txt
+{
+
+///
+/// Get the number of states an Aho-Corasick automaton needs at most for the given patterns.
+/// \param patterns List of patterns
+/// \return sum of all pattern sizes plus one for the root state
+///
+template<std::size_t N>
+constexpr auto aho_corasick_state_capacity(const std::array<std::string_view, N>& patterns) -> std::size_t
+{
+  auto result = std::size_t{1};
+  std::ranges::for_each(patterns, [&](const auto pattern) { result += pattern.size(); });
+  return result;
+}
+
+///
+/// Aho-Corasick multi pattern automaton. The automaton is built at compile time from a list of patterns
+/// and finds all occurrences of all patterns in a text in one linear pass.
+/// The automaton works on bytes, so UTF-8 encoded patterns are matched byte by byte.
+/// \tparam PatternCount Number of patterns
+/// \tparam StateCapacity Maximum number of states \see aho_corasick_state_capacity
+///
+template<std::size_t PatternCount, std::size_t StateCapacity>
+class aho_corasick final
+{
+public: // Typedefs
+  using patterns_type = std::array<std::string_view, PatternCount>;
+  using state_index_type = std::uint32_t;
+
+  ///
+  /// Pattern occurrence in a text.
+  /// \param pattern_index Index of the pattern in the pattern list
+  /// \param begin Index of the first char of the occurrence in the text
+  /// \param end Index after the last char of the occurrence in the text
+  ///
+  struct match final
+  {
+    std::size_t pattern_index;
+    std::size_t begin;
+    std::size_t end;
+    constexpr auto operator<=>(const match&) const = default;
+  };
+
+public: // Constants
+  static constexpr auto root = state_index_type{0};
+  static constexpr auto no_state = std::numeric_limits<state_index_type>::max();
+  static constexpr auto no_pattern = std::numeric_limits<std::size_t>::max();
+
+public: // Structors
+  ///
+  /// Build automaton from patterns. If a pattern appears more than once, the one with the highest index is reported.
+  /// \param patterns List of patterns, empty patterns are ignored
+  ///
+  constexpr explicit aho_corasick(const patterns_type& patterns);
+
+public: // Accessors
+  ///
+  /// Get the number of states used by the automaton.
+  /// \return number of states including the root state
+  ///
+  constexpr auto size() const -> std::size_t;
+
+  ///
+  /// Get the pattern at the given index.
+  /// \param index Index of the pattern
+  /// \return pattern
+  ///
+  constexpr auto pattern(std::size_t index) const -> std::string_view;
+
+  ///
+  /// Calls function for each occurrence of any pattern in text. The occurrences are reported ordered by their end index.
+  /// Occurrences with the same end index are reported from the longest to the shortest pattern.
+  /// \param text Text to search for patterns
+  /// \param function Function that is called for each match
+  ///
+  template<typename Function>
+    requires(std::is_invocable_v<Function, const match&>)
+  constexpr auto for_each_match(std::string_view text, Function&& function) const -> void;
+
+  ///
+  /// Calls function for each pattern that is a prefix of text. The prefixes are reported from the shortest to the longest.
+  /// \param text Text to check for prefixes
+  /// \param function Function that is called for each match
+  ///
+  template<typename Function>
+    requires(std::is_invocable_v<Function, const match&>)
+  constexpr auto for_each_prefix_match(std::string_view text, Function&& function) const -> void;
+
+  ///
+  /// Check if text starts with any of the patterns.
+  /// \param text Text to check
+  /// \return true if any pattern is a prefix of text, false otherwise
+  ///
+  constexpr auto starts_with_any(std::string_view text) const -> bool;
+
+  ///
+  /// Follow the trie edges of the chars from a state without failure links. This walks the patterns char by char, e.g. to
+  /// match the patterns against alternative spellings of a text.
+  /// \param state State to start from, root for the beginning of the patterns
+  /// \param chars Chars to follow
+  /// \return reached state, no_state if no pattern continues with the chars
+  ///
+  constexpr auto trie_transition(state_index_type state, std::string_view chars) const -> state_index_type;
+
+  ///
+  /// Get the index of the pattern ending in a state.
+  /// \param state State of the automaton
+  /// \return pattern index, no_pattern if no pattern ends in the state
+  ///
+  constexpr auto state_pattern(state_index_type state) const -> std::size_t;
+
+  ///
+  /// Check if a pattern continues after a state.
+  /// \param state State of the automaton
+  /// \return true if the state has trie children, false otherwise
+  ///
+  constexpr auto has_trie_children(state_index_type state) const -> bool;
+
+private: // Typedefs
+  ///
+  /// Trie node with failure and output links. Children are stored as a singly linked sibling list.
+  ///
+  struct state final
+  {
+    state_index_type first_child{no_state};
+    state_index_type next_sibling{no_state};
+    state_index_type fail{root};
+    state_index_type output{no_state};
+    std::size_t pattern{no_pattern};
+    char character{'\0'};
+  };
+
+private: // Implementation
+  constexpr auto child(state_index_type parent, char character) const -> state_index_type;
+  constexpr auto transition(state_index_type current, char character) const -> state_index_type;
+  constexpr auto insert(std::string_view pattern, std::size_t pattern_index) -> void;
+  constexpr auto link() -> void;
+
+private: // Variables
+  patterns_type patterns_;
+  std::array<state, StateCapacity> states_{};
+  std::size_t state_count_{1};
+};
+
+///
+///
+template<std::size_t PatternCount, std::size_t StateCapacity>
+constexpr aho_corasick<PatternCount, StateCapacity>::aho_corasick(const patterns_type& patterns)
+  : patterns_{patterns}
+{
+  for(std::size_t i = 0; i < patterns_.size(); ++i)
+  {
+    insert(patterns_[i], i);
+  }
+  link();
+}
+
+///
+///
+template<std::size_t PatternCount, std::size_t StateCapacity>
+constexpr auto aho_corasick<PatternCount, StateCapacity>::size() const -> std::size_t
+{
+  return state_count_;
+}
+
+///
+///
+template<std::size_t PatternCount, std::size_t StateCapacity>
+constexpr auto aho_corasick<PatternCount, StateCapacity>::pattern(const std::size_t index) const -> std::string_view
+{
+  return patterns_.at(index);
+}
+
+///
+///
+template<std::size_t PatternCount, std::size_t StateCapacity>
+template<typename Function>
+  requires(std::is_invocable_v<Function, const typename aho_corasick<PatternCount, StateCapacity>::match&>)
+constexpr auto aho_corasick<PatternCount, StateCapacity>::for_each_match(const std::string_view text, Function&& function) const
+  -> void
+{
+  auto current = root;
+  for(std::size_t i = 0; i < text.size(); ++i)
+  {
+    current = transition(current, text[i]);
+    auto reported = states_[current].pattern != no_pattern ? current : states_[current].output;
+    while(reported != no_state)
+    {
+      const auto pattern_index = states_[reported].pattern;
+      const auto end = i + 1;
+      function(match{.pattern_index = pattern_index, .begin = end - patterns_[pattern_index].size(), .end = end});
+      reported = states_[reported].output;
+    }
+  }
+}
+
+///
+///
+template<std::size_t PatternCount, std::size_t StateCapacity>
+template<typename Function>
+  requires(std::is_invocable_v<Function, const typename aho_corasick<PatternCount, StateCapacity>::match&>)
+constexpr auto aho_corasick<PatternCount, StateCapacity>::for_each_prefix_match(
+  const std::string_view text, Function&& function
+) const -> void
+{
+  auto current = root;
+  for(std::size_t i = 0; i < text.size(); ++i)
+  {
+    current = child(current, text[i]);
+    if(current == no_state)
+    {
+      return;
+    }
+    if(const auto pattern_index = states_[current].pattern; pattern_index != no_pattern)
+    {
+      function(match{.pattern_index = pattern_index, .begin = 0, .end = i + 1});
+    }
+  }
+}
+
+///
+///
+template<std::size_t PatternCount, std::size_t StateCapacity>
+constexpr auto aho_corasick<PatternCount, StateCapacity>::starts_with_any(const std::string_view text) const -> bool
+{
+  auto result = false;
+  for_each_prefix_match(text, [&](const auto&) { result = true; });
+  return result;
+}
+
+///
+///
+template<std::size_t PatternCount, std::size_t StateCapacity>
+constexpr auto aho_corasick<PatternCount, StateCapacity>::trie_transition(
+  state_index_type state, const std::string_view chars
+) const -> state_index_type
+{
+  for(std::size_t i = 0; i < chars.size() && state != no_state; ++i)
+  {
+    state = child(state, chars[i]);
+  }
+  return state;
+}
+
+///
+///
+template<std::size_t PatternCount, std::size_t StateCapacity>
+constexpr auto aho_corasick<PatternCount, StateCapacity>::state_pattern(const state_index_type state) const -> std::size_t
+{
+  return states_[state].pattern;
+}
+
+///
+///
+template<std::size_t PatternCount, std::size_t StateCapacity>
+constexpr auto aho_corasick<PatternCount, StateCapacity>::has_trie_children(const state_index_type state) const -> bool
+{
+  return states_[state].first_child != no_state;
+}
+
+///
+///
+template<std::size_t PatternCount, std::size_t StateCapacity>
+constexpr auto aho_corasick<PatternCount, StateCapacity>::child(const state_index_type parent, const char character) const
+  -> state_index_type
+{
+  auto current = states_[parent].first_child;
+  while(current != no_state && states_[current].character != character)
+  {
+    current = states_[current].next_sibling;
+  }
+  return current;
+}
+
+///
+///
+template<std::size_t PatternCount, std::size_t StateCapacity>
+constexpr auto aho_corasick<PatternCount, StateCapacity>::transition(state_index_type current, const char character) const
+  -> state_index_type
+{
+  auto next = child(current, character);
+  while(next == no_state && current != root)
+  {
+    current = states_[current].fail;
+    next = child(current, character);
+  }
+  return next == no_state ? root : next;
+}
+
+///
+///
+template<std::size_t PatternCount, std::size_t StateCapacity>
+constexpr auto aho_corasick<PatternCount, StateCapacity>::insert(const std::string_view pattern, const std::size_t pattern_index)
+  -> void
+{
+  if(pattern.empty())
+  {
+    return;
+  }
+  auto current = root;
+  for(const auto character : pattern)
+  {
+    auto next = child(current, character);
+    if(next == no_state)
+    {
+      if(state_count_ >= StateCapacity)
+      {
+        throw std::length_error("aho_corasick state capacity exceeded");
+      }
+      next = static_cast<state_index_type>(state_count_++);
+      states_[next].character = character;
+      states_[next].next_sibling = states_[current].first_child;
+      states_[current].first_child = next;
+    }
+    current = next;
+  }
+  states_[current].pattern = pattern_index;
+}
+
+///
+///
+template<std::size_t PatternCount, std::size_t StateCapacity>
+constexpr auto aho_corasick<PatternCount, StateCapacity>::link() -> void
+{
+  // Breadth first traversal, so the failure link of a parent is always set before its children are visited.
+  auto queue = std::array<state_index_type, StateCapacity>{};
+  auto queue_begin = std::size_t{0};
+  auto queue_end = std::size_t{0};
+  for(auto c = states_[root].first_child; c != no_state; c = states_[c].next_sibling)
+  {
+    states_[c].fail = root;
+    queue[queue_end++] = c;
+  }
+  while(queue_begin < queue_end)
+  {
+    const auto parent = queue[queue_begin++];
+    for(auto c = states_[parent].first_child; c != no_state; c = states_[c].next_sibling)
+    {
+      const auto fail = transition(states_[parent].fail, states_[c].character);
+      states_[c].fail = fail;
+      states_[c].output = states_[fail].pattern != no_pattern ? fail : states_[fail].output;
+      queue[queue_end++] = c;
+    }
+  }
+}
+
+} // namespace bibstd::txt
@@ -5,16 +5,147 @@
 
 #include <algorithm>
 #include <array>
-#include <cctype>
+#include <bit>
 #include <concepts>
 #include <cstdint>
+#include <cstring>
 #include <optional>
 #include <ranges>
 #include <string_view>
 #include <type_traits>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace bibstd::txt
 {
+namespace detail
+{
+
+///
+/// Decoded UTF-8 character.
+/// \param code_point Unicode code point
+/// \param size Number of bytes of the encoded character
+///
+struct utf8_char final
+{
+  char32_t code_point{0};
+  std::size_t size{0};
+};
+
+///
+/// Decode the UTF-8 character at index. Only well-formed sequences are accepted, i.e. no overlong encodings,
+/// no surrogates and no code points above U+10FFFF (see Unicode table 3-7).
+/// \param string_view String view
+/// \param index Index of the first byte of the character
+/// \return decoded character or std::nullopt if the sequence is invalid or truncated
+///
+constexpr auto decode_utf8(const std::string_view string_view, const std::size_t index) -> std::optional<utf8_char>
+{
+  if(index >= string_view.size())
+  {
+    return std::nullopt;
+  }
+  const auto byte_at = [&](const std::size_t i) { return static_cast<std::uint8_t>(string_view[i]); };
+  const auto lead = byte_at(index);
+  if(lead < 0x80)
+  {
+    return utf8_char{.code_point = lead, .size = 1};
+  }
+
+  // Sequence size, lead byte payload and the valid range of the second byte depend on the lead byte only.
+  auto size = std::size_t{0};
+  auto code_point = char32_t{0};
+  auto second_min = std::uint8_t{0x80};
+  auto second_max = std::uint8_t{0xBF};
+  if(lead >= 0xC2 && lead <= 0xDF)
+  {
+    size = 2;
+    code_point = lead & 0x1Fu;
+  }
+  else if(lead >= 0xE0 && lead <= 0xEF)
+  {
+    size = 3;
+    code_point = lead & 0x0Fu;
+    second_min = lead == 0xE0 ? 0xA0 : 0x80;
+    second_max = lead == 0xED ? 0x9F : 0xBF;
+  }
+  else if(lead >= 0xF0 && lead <= 0xF4)
+  {
+    size = 4;
+    code_point = lead & 0x07u;
+    second_min = lead == 0xF0 ? 0x90 : 0x80;
+    second_max = lead == 0xF4 ? 0x8F : 0xBF;
+  }
+  else
+  {
+    return std::nullopt;
+  }
+  if(index + size > string_view.size())
+  {
+    return std::nullopt;
+  }
+  for(std::size_t i = 1; i < size; ++i)
+  {
+    const auto byte = byte_at(index + i);
+    const auto min = i == 1 ? second_min : std::uint8_t{0x80};
+    const auto max = i == 1 ? second_max : std::uint8_t{0xBF};
+    if(byte < min || byte > max)
+    {
+      return std::nullopt;
+    }
+    code_point = (code_point << 6) | (byte & 0x3Fu);
+  }
+  return utf8_char{.code_point = code_point, .size = size};
+}
+
+///
+/// Number of bytes that are classified at once when iterating chars, the size of an SSE2 register.
+///
+constexpr auto ascii_block_size = std::size_t{16};
+
+///
+/// Count the ASCII bytes at the beginning of the string view.
+/// \param string_view String view
+/// \return number of leading bytes below 0x80
+///
+constexpr auto ascii_prefix_size(const std::string_view string_view) -> std::size_t
+{
+  auto count = std::size_t{0};
+  const auto size = string_view.size();
+  if !consteval
+  {
+#if defined(__SSE2__)
+    for(; count + 16 <= size; count += 16)
+    {
+      const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(string_view.data() + count));
+      if(const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(block)); mask != 0)
+      {
+        return count + static_cast<std::size_t>(std::countr_zero(mask));
+      }
+    }
+#else
+    constexpr auto high_bits = std::uint64_t{0x8080808080808080};
+    for(; count + sizeof(std::uint64_t) <= size; count += sizeof(std::uint64_t))
+    {
+      auto block = std::uint64_t{0};
+      std::memcpy(&block, string_view.data() + count, sizeof(block));
+      if((block & high_bits) != 0)
+      {
+        break;
+      }
+    }
+#endif
+  }
+  while(count < size && static_cast<std::uint8_t>(string_view[count]) < 0x80)
+  {
+    ++count;
+  }
+  return count;
+}
+
+} // namespace detail
 
 ///
 /// Chars struct containing special char lists.
@@ -115,11 +246,81 @@ public: // Constants
     std::string_view("\xEF\xBC\x8D"), // fullwidth hyphen-minus
   };
 
+private: // Constants
+  ///
+  /// Code point with its category.
+  ///
+  struct code_point_category final
+  {
+    char32_t code_point;
+    category char_category;
+  };
+
+  ///
+  /// Category of every single byte character. Bytes above 0x7F start multibyte characters and are categorized as other.
+  ///
+  static constexpr auto ascii_categories = []()
+  {
+    auto result = std::array<category, 256>{};
+    result.fill(category::other);
+    const auto assign = [&](const auto& list, const category char_category)
+    {
+      std::ranges::for_each(
+        list | std::views::filter([](const auto c) { return c.size() == 1; }),
+        [&](const auto c) { result[static_cast<std::uint8_t>(c.front())] = char_category; }
+      );
+    };
+    // Assigned in reverse priority order, so the higher priority category wins for chars in multiple lists.
+    std::ranges::for_each(std::views::iota('0', static_cast<char>('9' + 1)), [&](const auto c) { result[c] = category::digit; });
+    result['.'] = category::fullstop;
+    assign(lines, category::line);
+    assign(whitespaces, category::whitespace);
+    assign(letters, category::letter);
+    return result;
+  }();
+
+  ///
+  /// Number of multibyte characters in all char lists.
+  ///
+  static constexpr auto multibyte_char_count = []()
+  {
+    const auto count = [](const auto& list) { return std::ranges::count_if(list, [](const auto c) { return c.size() > 1; }); };
+    return static_cast<std::size_t>(count(letters) + count(whitespaces) + count(lines));
+  }();
+
+  ///
+  /// Category of every multibyte character in the char lists, sorted by code point for binary search.
+  ///
+  static constexpr auto multibyte_categories = []()
+  {
+    auto result = std::array<code_point_category, multibyte_char_count>{};
+    auto size = std::size_t{0};
+    const auto append = [&](const auto& list, const category char_category)
+    {
+      std::ranges::for_each(
+        list | std::views::filter([](const auto c) { return c.size() > 1; }),
+        [&](const auto c) { result[size++] = code_point_category{detail::decode_utf8(c, 0)->code_point, char_category}; }
+      );
+    };
+    append(letters, category::letter);
+    append(whitespaces, category::whitespace);
+    append(lines, category::line);
+    std::ranges::sort(result, {}, &code_point_category::code_point);
+    return result;
+  }();
+  static_assert(
+    std::ranges::adjacent_find(multibyte_categories, {}, &code_point_category::code_point) ==
+      std::ranges::cend(multibyte_categories),
+    "multibyte chars must be unique over all char lists"
+  );
+
+public: // Accessors
+
   ///
   /// Checks if char in string at given index is of provided chars category.
   /// \param string_view String view
   /// \param index to check the character
-  /// \param char_category Category of char that shall be checked
+  /// \param char_category Category of char that shall be checked, category::other matches any char
   /// \return optional string view of the char or std::nullopt if category does not match
   ///
   static constexpr auto is_char(std::string_view string_view, std::size_t index, category char_category)
@@ -139,10 +340,11 @@ public: // Constants
     -> std::optional<std::string_view>;
 
   ///
-  /// Determines the category of the char in string at given index.
+  /// Determines the category of the char in string at given index. ASCII chars are looked up in a table, multibyte chars
+  /// are decoded and looked up by code point. Invalid UTF-8 sequences are categorized byte by byte as other.
   /// \param string_view String view
   /// \param index to check the character
-  /// \return category of the char
+  /// \return category and size of the char or std::nullopt if index is out of range
   ///
   static constexpr auto char_info(std::string_view string_view, std::size_t index) -> std::optional<char_data>;
 
@@ -165,9 +367,7 @@ public: // Constants
   static constexpr auto for_each_char_while(std::string_view string_view, Function&& function) -> void;
 
 private: // Implementation
-  static constexpr auto is_equal_impl(std::string_view string_view, std::size_t index, std::string_view character)
-    -> std::optional<std::string_view>;
-  static constexpr auto is_digit_impl(std::string_view string_view, std::size_t index) -> std::optional<std::string_view>;
+  static constexpr auto multibyte_category(char32_t code_point) -> category;
 };
 
 ///
@@ -175,23 +375,12 @@ private: // Implementation
 constexpr auto chars::is_char(const std::string_view string_view, const std::size_t index, const category char_category)
   -> std::optional<std::string_view>
 {
-  if(index < string_view.size())
-  {
-    switch(char_category)
-    {
-    case category::letter: return contains(letters, string_view, index);
-    case category::whitespace: return contains(whitespaces, string_view, index);
-    case category::line: return contains(lines, string_view, index);
-    case category::fullstop: return is_equal_impl(string_view, index, ".");
-    case category::digit: return is_digit_impl(string_view, index);
-    case category::other: return string_view.substr(index, 1);
-    default: return std::nullopt;
-    }
-  }
-  else
+  const auto data = char_info(string_view, index);
+  if(data && (char_category == category::other || data->char_category == char_category))
   {
-    return std::nullopt;
+    return string_view.substr(index, data->char_size);
   }
+  return std::nullopt;
 }
 
 ///
@@ -224,15 +413,21 @@ constexpr auto chars::contains(const T& chars, const std::string_view string_vie
 ///
 constexpr auto chars::char_info(std::string_view string_view, std::size_t index) -> std::optional<char_data>
 {
-  // clang-format off
-  if(const auto result = is_char(string_view, index, category::letter); result) { return char_data{category::letter, result->size()}; }
-  if(const auto result = is_char(string_view, index, category::whitespace); result) { return char_data{category::whitespace, result->size()}; }
-  if(const auto result = is_char(string_view, index, category::line); result) { return char_data{category::line, result->size()}; }
-  if(const auto result = is_char(string_view, index, category::fullstop); result) { return char_data{category::fullstop, result->size()}; }
-  if(const auto result = is_char(string_view, index, category::digit); result) { return char_data{category::digit, result->size()}; }
-  if(const auto result = is_char(string_view, index, category::other); result) { return char_data{category::other, result->size()}; }
-  // clang-format on
-  return std::nullopt;
+  if(index >= string_view.size())
+  {
+    return std::nullopt;
+  }
+  const auto byte = static_cast<std::uint8_t>(string_view[index]);
+  if(byte < 0x80)
+  {
+    return char_data{ascii_categories[byte], 1};
+  }
+  // Invalid or truncated UTF-8 sequences are categorized byte by byte as other.
+  if(const auto decoded = detail::decode_utf8(string_view, index); decoded)
+  {
+    return char_data{multibyte_category(decoded->code_point), decoded->size};
+  }
+  return char_data{category::other, 1};
 }
 
 ///
@@ -241,23 +436,12 @@ template<typename Function>
   requires(std::is_invocable_v<Function, const std::string_view, const std::size_t, const chars::category>)
 constexpr auto chars::for_each_char(const std::string_view string_view, Function&& function) -> void
 {
-  auto counter = std::size_t{0};
-  std::ranges::for_each(
-    std::views::iota(std::size_t{0}, string_view.size()) |
-      std::views::take_while([&](const auto i) { return counter < string_view.size(); }),
-    [&]([[maybe_unused]] const auto)
+  for_each_char_while(
+    string_view,
+    [&](const auto character, const auto pos, const category char_category)
     {
-      const auto data = char_info(string_view, counter);
-      if(data)
-      {
-        function(string_view.substr(counter, data->char_size), counter, data->char_category);
-        counter += data->char_size;
-      }
-      else
-      {
-        LOG_ERROR("error getting char info: char=\'{}\'", string_view.at(counter));
-        ++counter;
-      }
+      function(character, pos, char_category);
+      return true;
     }
   );
 }
@@ -269,52 +453,40 @@ template<typename Function>
 constexpr auto chars::for_each_char_while(const std::string_view string_view, Function&& function) -> void
 {
   auto counter = std::size_t{0};
-  std::ranges::for_each(
-    std::views::iota(std::size_t{0}, string_view.size()) |
-      std::views::take_while([&](const auto i) { return counter < string_view.size(); }),
-    [&]([[maybe_unused]] const auto)
+  while(counter < string_view.size())
+  {
+    // ASCII runs are categorized by table lookup only, multibyte characters are decoded one by one. Only one block is
+    // classified ahead of the function, so callers that stop early do not pay for scanning the rest of the text.
+    const auto block = string_view.substr(counter, detail::ascii_block_size);
+    const auto ascii_size = detail::ascii_prefix_size(block);
+    const auto ascii_end = counter + ascii_size;
+    for(; counter < ascii_end; ++counter)
     {
-      const auto data = char_info(string_view, counter);
-      if(data)
+      const auto char_category = ascii_categories[static_cast<std::uint8_t>(string_view[counter])];
+      if(!function(string_view.substr(counter, 1), counter, char_category))
       {
-        if(function(string_view.substr(counter, data->char_size), counter, data->char_category))
-        {
-          counter += data->char_size;
-        }
-        else
-        {
-          counter = string_view.size();
-        }
+        return;
       }
-      else
+    }
+    if(ascii_size < block.size())
+    {
+      const auto data = char_info(string_view, counter).value();
+      if(!function(string_view.substr(counter, data.char_size), counter, data.char_category))
       {
-        LOG_ERROR("error getting char info: char=\'{}\'", string_view.at(counter));
-        ++counter;
+        return;
       }
+      counter += data.char_size;
     }
-  );
-}
-
-///
-///
-constexpr auto chars::is_equal_impl(const std::string_view string_view, const std::size_t index, const std::string_view c)
-  -> std::optional<std::string_view>
-{
-  if(index + c.size() > string_view.size())
-  {
-    return std::nullopt;
   }
-  const auto substr = string_view.substr(index, c.size());
-  return substr == c ? std::make_optional(substr) : std::nullopt;
 }
 
 ///
 ///
-constexpr auto chars::is_digit_impl(const std::string_view string_view, const std::size_t index)
-  -> std::optional<std::string_view>
+constexpr auto chars::multibyte_category(const char32_t code_point) -> category
 {
-  return std::isdigit(static_cast<unsigned char>(string_view.at(index))) ? std::make_optional(string_view.substr(index, 1))
-                                                                         : std::nullopt;
+  const auto iter = std::ranges::lower_bound(multibyte_categories, code_point, {}, &code_point_category::code_point);
+  return iter != std::ranges::cend(multibyte_categories) && iter->code_point == code_point ? iter->char_category
+                                                                                           : category::other;
 }
 
 } // namespace bibstd::txt
@@ -1,62 +1,149 @@
 #include "txt/indexed_strings.hpp"
-#include "util/log.hpp"
+#include "util/exception.hpp"
 #include "util/string.hpp"
 
 #include <algorithm>
-#include <ranges>
+#include <stdexcept>
 
 namespace bibstd::txt
 {
 
 ///
 ///
-auto indexed_strings::size() const -> std::size_t
+indexed_strings::indexed_strings()
+  : base_{std::make_shared<base_strings>()}
 {
-  return data_.size();
 }
 
 ///
 ///
-auto indexed_strings::read_at(const std::size_t index) const -> std::string
+auto indexed_strings::operator==(const indexed_strings& rhs) const -> bool
 {
-  return data_.at(index).second;
+  if(size() != rhs.size())
+  {
+    return false;
+  }
+  for(std::size_t i = 0; i < size(); ++i)
+  {
+    if(read_at(i) != rhs.read_at(i))
+    {
+      return false;
+    }
+  }
+  return true;
 }
 
 ///
 ///
-auto indexed_strings::joined_string() const -> std::string
+auto indexed_strings::size() const -> std::size_t
 {
-  auto result = std::string{""};
-  std::ranges::for_each(data_, [&](const auto& p) { result.append(p.second); });
-  return result;
+  return base_->offsets.size() - 1;
 }
 
 ///
 ///
-auto indexed_strings::indexed_chars() const -> std::vector<std::pair<std::size_t, char>>
+auto indexed_strings::read_at(const std::size_t index) const -> std::string_view
+{
+  if(const auto it = find_overlay(index); it != overlay_.cend())
+  {
+    return it->second;
+  }
+  const auto begin = base_->offsets.at(index);
+  return std::string_view(base_->buffer).substr(begin, base_->offsets.at(index + 1) - begin);
+}
+
+///
+/// Only the size differences of the overwritten strings before the index are added to the base offset.
+auto indexed_strings::string_offset(const std::size_t index) const -> std::size_t
 {
-  auto result = std::vector<std::pair<std::size_t, char>>{};
-  result.reserve(data_.size());
-  std::ranges::for_each(
-    data_,
-    [&](const auto& p)
-    { std::ranges::for_each(p.second, [&](const auto character) { result.emplace_back(p.first, character); }); }
-  );
+  auto result = base_->offsets.at(index);
+  for(const auto& [overlay_index, string] : overlay_)
+  {
+    if(overlay_index >= index)
+    {
+      break;
+    }
+    result = result + string.size() - (base_->offsets[overlay_index + 1] - base_->offsets[overlay_index]);
+  }
   return result;
 }
 
 ///
+/// The base buffer is copied in slices between the overwritten strings.
+auto indexed_strings::joined_string() const -> std::string_view
+{
+  if(!joined_)
+  {
+    auto result = std::string{};
+    result.reserve(string_offset(size()));
+    auto begin = std::size_t{0};
+    for(const auto& [overlay_index, string] : overlay_)
+    {
+      result.append(base_->buffer, begin, base_->offsets[overlay_index] - begin);
+      result.append(string);
+      begin = base_->offsets[overlay_index + 1];
+    }
+    result.append(base_->buffer, begin);
+    joined_ = std::make_shared<const std::string>(std::move(result));
+  }
+  return *joined_;
+}
+
+///
+///
+auto indexed_strings::overlay() const -> const overlay_type&
+{
+  return overlay_;
+}
+
+///
+/// A string equal to the base string removes the overwrite, so the overlay only contains actual differences.
+auto indexed_strings::overwrite_at(const std::size_t index, const std::string_view string) -> void
+{
+  if(index >= size())
+  {
+    THROW_EXCEPTION(std::out_of_range("indexed strings index out of range"));
+  }
+  const auto it = std::ranges::lower_bound(overlay_, index, {}, [](const auto& e) { return e.first; });
+  const auto begin = base_->offsets[index];
+  const auto is_base = std::string_view(base_->buffer).substr(begin, base_->offsets[index + 1] - begin) == string;
+  if(it != overlay_.cend() && it->first == index)
+  {
+    if(is_base)
+    {
+      overlay_.erase(it);
+    }
+    else
+    {
+      it->second = util::to_string(string);
+    }
+  }
+  else if(!is_base)
+  {
+    overlay_.emplace(it, index, util::to_string(string));
+  }
+  joined_.reset();
+}
+
 ///
-auto indexed_strings::append_string(const std::string_view character) -> void
+/// The base is never modified while it is shared, so the copies keep their strings.
+auto indexed_strings::append_string(const std::string_view string) -> void
 {
-  data_.emplace_back(data_.size(), util::to_string(character));
+  if(base_.use_count() > 1)
+  {
+    base_ = std::make_shared<base_strings>(*base_);
+  }
+  base_->buffer.append(string);
+  base_->offsets.push_back(base_->buffer.size());
+  joined_.reset();
 }
 
 ///
 ///
-auto indexed_strings::overwrite_at(const std::size_t index, const std::string_view character) -> void
+auto indexed_strings::find_overlay(const std::size_t index) const -> overlay_type::const_iterator
 {
-  data_.at(index).second = util::to_string(character);
+  const auto it = std::ranges::lower_bound(overlay_, index, {}, [](const auto& e) { return e.first; });
+  return it != overlay_.cend() && it->first == index ? it : overlay_.cend();
 }
 
 } // namespace bibstd::txt
@@ -1,27 +1,30 @@
 #pragma once
 
-#include <functional>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 namespace bibstd::txt
 {
 
 ///
-/// Index string containing a string and indices for each character.
+/// Indexed strings, e.g. the symbols of a recognized text where some symbols are replaced by other choices.
+/// The appended strings form an immutable base, that is stored in one UTF-8 buffer and shared by all copies. Overwritten
+/// strings are kept in a small sparse overlay of each copy, so a copy costs the number of its overwritten strings instead
+/// of the number of all strings. The joined string is only materialized on request and shared by the copies as well.
 ///
 class indexed_strings final
 {
 public: // Typedefs
-  using data_type = std::vector<std::pair<std::size_t, std::string>>;
-  using const_iterator = data_type::const_iterator;
-  using const_reverse_iterator = data_type::const_reverse_iterator;
+  using overlay_type = std::vector<std::pair<std::size_t, std::string>>;
 
 public: // Constructor
-  indexed_strings() = default;
+  indexed_strings();
 
 public: // Operators
-  auto operator<=>(const indexed_strings&) const = default;
+  auto operator==(const indexed_strings& rhs) const -> bool;
 
 public: // Accessors
   ///
@@ -32,39 +35,62 @@ public: // Accessors
 
   ///
   /// Get the string at the given index.
-  /// \param index Index of the character
-  /// \return string having the given index
+  /// \param index Index of the string
+  /// \return string having the given index, valid until the object is modified
+  ///
+  auto read_at(std::size_t index) const -> std::string_view;
+
+  ///
+  /// Get the byte offset of a string in the joined string. The joined string is not materialized.
+  /// \param index Index of the string, `size()` for the end of the joined string
+  /// \return byte offset of the string
   ///
-  auto read_at(std::size_t index) const -> std::string;
+  auto string_offset(std::size_t index) const -> std::size_t;
 
   ///
-  /// Get the joined string of all stored strings.
-  /// \return joined string
+  /// Get the joined string of all stored strings. It is materialized on the first call after a modification.
+  /// \return joined string, valid until the object is modified
   ///
-  auto joined_string() const -> std::string;
+  auto joined_string() const -> std::string_view;
 
   ///
-  /// Get a list of all chars with their corresponding indexes within the index string object.
-  /// \return vector of pairs containing the index and the character
+  /// Get the overwritten strings, sorted by index.
+  /// \return overwritten strings with their index
   ///
-  auto indexed_chars() const -> std::vector<std::pair<std::size_t, char>>;
+  auto overlay() const -> const overlay_type&;
 
 public: // Modifiers
   ///
-  /// Set the string at the given index.
+  /// Set the string at the given index. Only this object is modified, the base shared with the copies is kept.
+  /// Throws std::out_of_range if the index is not valid.
   /// \param index Index of the string
   /// \param string String that shall be set
   ///
   auto overwrite_at(std::size_t index, std::string_view string) -> void;
 
   ///
-  /// Append a string to the container with the corresponding index.
+  /// Append a string to the container with the corresponding index. The base is copied first if it is shared.
   /// \param string String that shall be appended
   ///
   auto append_string(std::string_view string) -> void;
 
+private: // Typedefs
+  ///
+  /// Strings stored in one buffer, string `i` is the byte range [offsets[i], offsets[i + 1]) of the buffer.
+  ///
+  struct base_strings final
+  {
+    std::string buffer{};
+    std::vector<std::size_t> offsets{0};
+  };
+
+private: // Implementation
+  auto find_overlay(std::size_t index) const -> overlay_type::const_iterator;
+
 private: // Variables
-  std::vector<std::pair<std::size_t, std::string>> data_;
+  std::shared_ptr<base_strings> base_;
+  overlay_type overlay_{};
+  mutable std::shared_ptr<const std::string> joined_{};
 };
 
 } // namespace bibstd::txt
@@ -0,0 +1,473 @@
+#pragma once
+
+#include "util/exception.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace bibstd::util
+{
+
+///
+/// Thread safe pool of expensive objects, grouped by a key. Objects are created on demand by a factory, checked out to one
+/// user at a time and returned to the pool when the lease is destroyed. The number of objects per key grows up to the
+/// maximum count; idle objects above the minimum count are destroyed by trim. The limits apply to every key, unless a key
+/// has limits of its own.
+/// The pool must outlive all leases.
+/// \tparam Key Key type, e.g. a language, must be less than comparable
+/// \tparam T Object type
+///
+template<typename Key, typename T>
+class object_pool final
+{
+public: // Typedefs
+  using key_type = Key;
+  using value_type = T;
+  using factory_type = std::function<std::unique_ptr<T>(const Key&)>;
+
+  ///
+  /// Limits of the object count per key.
+  /// \param min_count Number of objects that are kept initialized, even if they are idle
+  /// \param max_count Maximum number of objects, checkout waits if all of them are checked out
+  ///
+  struct limits final
+  {
+    std::size_t min_count{1};
+    std::size_t max_count{1};
+  };
+
+  ///
+  /// Exclusive access to a checked out object. The object is returned to the pool on destruction.
+  ///
+  class lease final
+  {
+  public: // Structors
+    lease() = default;
+    lease(lease&& rhs) noexcept = default;
+    lease(const lease&) = delete;
+    ~lease() noexcept { release(); }
+
+  public: // Operators
+    auto operator=(lease&& rhs) & noexcept -> lease&;
+    auto operator=(const lease&) -> lease& = delete;
+    auto operator*() const -> T& { return *object_; }
+    auto operator->() const -> T* { return object_.get(); }
+    explicit operator bool() const { return object_ != nullptr; }
+
+  public: // Accessors
+    auto key() const -> const Key& { return key_; }
+
+  public: // Modifiers
+    ///
+    /// Return the object to the pool early. The lease is empty afterwards.
+    ///
+    auto release() noexcept -> void;
+
+  private: // Structors
+    friend class object_pool;
+    lease(object_pool* pool, const Key& key, std::unique_ptr<T> object);
+
+  private: // Variables
+    object_pool* pool_{nullptr};
+    Key key_{};
+    std::unique_ptr<T> object_;
+  };
+
+public: // Structors
+  ///
+  /// Create empty pool. No object is created until a checkout or reserve.
+  /// \param factory Function creating a new object for a key, it is called without holding the pool lock
+  /// \param limits Limits of the object count per key
+  ///
+  object_pool(factory_type factory, limits limits);
+  object_pool(const object_pool&) = delete;
+  auto operator=(const object_pool&) -> object_pool& = delete;
+
+public: // Accessors
+  ///
+  /// Get the number of objects for a key, including the checked out and currently created ones.
+  /// \param key Key of the objects
+  /// \return number of objects
+  ///
+  auto count(const Key& key) const -> std::size_t;
+
+  ///
+  /// Get the number of idle objects for a key.
+  /// \param key Key of the objects
+  /// \return number of objects that can be checked out without creating a new one
+  ///
+  auto idle_count(const Key& key) const -> std::size_t;
+
+  ///
+  /// Get the limits of the object count per key.
+  /// \return limits
+  ///
+  auto get_limits() const -> limits;
+
+  ///
+  /// Get the limits of the object count of a key.
+  /// \param key Key of the objects
+  /// \return limits of the key if it has limits of its own, otherwise the limits per key
+  ///
+  auto get_limits(const Key& key) const -> limits;
+
+public: // Modifiers
+  ///
+  /// Change the limits. Idle objects above the new maximum are destroyed immediately, checked out objects on return.
+  /// Throws std::invalid_argument if the maximum count is zero or less than the minimum count.
+  /// \param limits New limits
+  ///
+  auto set_limits(limits limits) -> void;
+
+  ///
+  /// Change the limits of a key, they replace the limits per key for this key. Idle objects above the new maximum are
+  /// destroyed immediately, checked out objects on return.
+  /// Throws std::invalid_argument if the maximum count is zero or less than the minimum count.
+  /// \param key Key of the objects
+  /// \param limits New limits of the key
+  ///
+  auto set_limits(const Key& key, limits limits) -> void;
+
+  ///
+  /// Check out an object. If no object is idle, a new one is created as long as the maximum count is not reached,
+  /// otherwise the call waits until another lease returns its object. Exceptions of the factory are propagated.
+  /// \param key Key of the object
+  /// \return lease of the object
+  ///
+  auto checkout(const Key& key) -> lease;
+
+  ///
+  /// Check out an object without waiting. A new object is created if no object is idle and the maximum count is not reached.
+  /// \param key Key of the object
+  /// \return lease of the object, std::nullopt if all objects are checked out and no object can be created
+  ///
+  auto try_checkout(const Key& key) -> std::optional<lease>;
+
+  ///
+  /// Create objects until the given number of objects exist for the key, bounded by the maximum count.
+  /// \param key Key of the objects
+  /// \param count Number of objects that shall exist
+  ///
+  auto reserve(const Key& key, std::size_t count) -> void;
+
+  ///
+  /// Destroy idle objects above the minimum count for all keys.
+  ///
+  auto trim() -> void;
+
+private: // Typedefs
+  struct entry final
+  {
+    std::vector<std::unique_ptr<T>> idle;
+    std::size_t count{0};
+    std::optional<limits> key_limits;
+  };
+
+private: // Implementation
+  auto entry_limits(const entry& entry) const -> const limits&;
+  auto shrink_to_limits(entry& entry, std::vector<std::unique_ptr<T>>& destroyed) const -> void;
+  auto create(const Key& key) -> lease;
+  auto checkin(const Key& key, std::unique_ptr<T> object) noexcept -> void;
+  static auto validate(const limits& limits) -> void;
+
+private: // Variables
+  const factory_type factory_;
+  mutable std::mutex mutex_;
+  std::condition_variable returned_;
+  limits limits_;
+  std::map<Key, entry> entries_;
+};
+
+///
+///
+template<typename Key, typename T>
+object_pool<Key, T>::lease::lease(object_pool* pool, const Key& key, std::unique_ptr<T> object)
+  : pool_{pool}
+  , key_{key}
+  , object_{std::move(object)}
+{
+}
+
+///
+///
+template<typename Key, typename T>
+auto object_pool<Key, T>::lease::operator=(lease&& rhs) & noexcept -> lease&
+{
+  if(this != &rhs)
+  {
+    release();
+    pool_ = std::exchange(rhs.pool_, nullptr);
+    key_ = std::move(rhs.key_);
+    object_ = std::move(rhs.object_);
+  }
+  return *this;
+}
+
+///
+///
+template<typename Key, typename T>
+auto object_pool<Key, T>::lease::release() noexcept -> void
+{
+  if(pool_ != nullptr && object_ != nullptr)
+  {
+    pool_->checkin(key_, std::move(object_));
+  }
+  pool_ = nullptr;
+  object_.reset();
+}
+
+///
+///
+template<typename Key, typename T>
+object_pool<Key, T>::object_pool(factory_type factory, const limits limits)
+  : factory_{std::move(factory)}
+  , limits_{limits}
+{
+  validate(limits_);
+}
+
+///
+///
+template<typename Key, typename T>
+auto object_pool<Key, T>::count(const Key& key) const -> std::size_t
+{
+  const auto lock = std::lock_guard(mutex_);
+  const auto iter = entries_.find(key);
+  return iter != entries_.cend() ? iter->second.count : 0;
+}
+
+///
+///
+template<typename Key, typename T>
+auto object_pool<Key, T>::idle_count(const Key& key) const -> std::size_t
+{
+  const auto lock = std::lock_guard(mutex_);
+  const auto iter = entries_.find(key);
+  return iter != entries_.cend() ? iter->second.idle.size() : 0;
+}
+
+///
+///
+template<typename Key, typename T>
+auto object_pool<Key, T>::get_limits() const -> limits
+{
+  const auto lock = std::lock_guard(mutex_);
+  return limits_;
+}
+
+///
+///
+template<typename Key, typename T>
+auto object_pool<Key, T>::get_limits(const Key& key) const -> limits
+{
+  const auto lock = std::lock_guard(mutex_);
+  const auto iter = entries_.find(key);
+  return iter != entries_.cend() ? entry_limits(iter->second) : limits_;
+}
+
+///
+///
+template<typename Key, typename T>
+auto object_pool<Key, T>::set_limits(const limits limits) -> void
+{
+  validate(limits);
+  auto destroyed = std::vector<std::unique_ptr<T>>{};
+  {
+    const auto lock = std::lock_guard(mutex_);
+    limits_ = limits;
+    for(auto& [key, entry] : entries_)
+    {
+      shrink_to_limits(entry, destroyed);
+    }
+  }
+  // A raised maximum may allow waiting checkouts to create objects.
+  returned_.notify_all();
+}
+
+///
+///
+template<typename Key, typename T>
+auto object_pool<Key, T>::set_limits(const Key& key, const limits limits) -> void
+{
+  validate(limits);
+  auto destroyed = std::vector<std::unique_ptr<T>>{};
+  {
+    const auto lock = std::lock_guard(mutex_);
+    auto& entry = entries_[key];
+    entry.key_limits = limits;
+    shrink_to_limits(entry, destroyed);
+  }
+  // A raised maximum may allow waiting checkouts to create objects.
+  returned_.notify_all();
+}
+
+///
+///
+template<typename Key, typename T>
+auto object_pool<Key, T>::checkout(const Key& key) -> lease
+{
+  auto lock = std::unique_lock(mutex_);
+  auto& entry = entries_[key];
+  returned_.wait(lock, [&] { return !entry.idle.empty() || entry.count < entry_limits(entry).max_count; });
+  if(!entry.idle.empty())
+  {
+    auto object = std::move(entry.idle.back());
+    entry.idle.pop_back();
+    return lease(this, key, std::move(object));
+  }
+  ++entry.count;
+  lock.unlock();
+  return create(key);
+}
+
+///
+///
+template<typename Key, typename T>
+auto object_pool<Key, T>::try_checkout(const Key& key) -> std::optional<lease>
+{
+  auto lock = std::unique_lock(mutex_);
+  auto& entry = entries_[key];
+  if(!entry.idle.empty())
+  {
+    auto object = std::move(entry.idle.back());
+    entry.idle.pop_back();
+    return lease(this, key, std::move(object));
+  }
+  if(entry.count >= entry_limits(entry).max_count)
+  {
+    return std::nullopt;
+  }
+  ++entry.count;
+  lock.unlock();
+  return create(key);
+}
+
+///
+///
+template<typename Key, typename T>
+auto object_pool<Key, T>::reserve(const Key& key, const std::size_t count) -> void
+{
+  auto leases = std::vector<lease>{};
+  for(;;)
+  {
+    {
+      const auto lock = std::lock_guard(mutex_);
+      auto& entry = entries_[key];
+      if(entry.count >= std::min(count, entry_limits(entry).max_count))
+      {
+        break;
+      }
+      ++entry.count;
+    }
+    leases.push_back(create(key));
+  }
+  // The leases return the created objects to the pool on destruction.
+}
+
+///
+///
+template<typename Key, typename T>
+auto object_pool<Key, T>::trim() -> void
+{
+  auto destroyed = std::vector<std::unique_ptr<T>>{};
+  const auto lock = std::lock_guard(mutex_);
+  for(auto& [key, entry] : entries_)
+  {
+    while(entry.count > entry_limits(entry).min_count && !entry.idle.empty())
+    {
+      destroyed.push_back(std::move(entry.idle.back()));
+      entry.idle.pop_back();
+      --entry.count;
+    }
+  }
+}
+
+///
+///
+template<typename Key, typename T>
+auto object_pool<Key, T>::entry_limits(const entry& entry) const -> const limits&
+{
+  return entry.key_limits ? *entry.key_limits : limits_;
+}
+
+///
+/// The destroyed objects are collected, so the caller destroys them after releasing the lock.
+template<typename Key, typename T>
+auto object_pool<Key, T>::shrink_to_limits(entry& entry, std::vector<std::unique_ptr<T>>& destroyed) const -> void
+{
+  while(entry.count > entry_limits(entry).max_count && !entry.idle.empty())
+  {
+    destroyed.push_back(std::move(entry.idle.back()));
+    entry.idle.pop_back();
+    --entry.count;
+  }
+}
+
+///
+/// The object count is already incremented, so it is reverted if the factory fails.
+template<typename Key, typename T>
+auto object_pool<Key, T>::create(const Key& key) -> lease
+{
+  auto object = std::unique_ptr<T>{};
+  try
+  {
+    object = factory_(key);
+    if(!object)
+    {
+      THROW_EXCEPTION(std::runtime_error("object pool factory returned no object"));
+    }
+  }
+  catch(...)
+  {
+    {
+      const auto lock = std::lock_guard(mutex_);
+      --entries_[key].count;
+    }
+    returned_.notify_all();
+    throw;
+  }
+  return lease(this, key, std::move(object));
+}
+
+///
+///
+template<typename Key, typename T>
+auto object_pool<Key, T>::checkin(const Key& key, std::unique_ptr<T> object) noexcept -> void
+{
+  {
+    const auto lock = std::lock_guard(mutex_);
+    auto& entry = entries_[key];
+    if(entry.count > entry_limits(entry).max_count)
+    {
+      --entry.count;
+    }
+    else
+    {
+      entry.idle.push_back(std::move(object));
+    }
+  }
+  returned_.notify_all();
+  // An object that exceeds the limits is destroyed here, outside of the lock.
+}
+
+///
+///
+template<typename Key, typename T>
+auto object_pool<Key, T>::validate(const limits& limits) -> void
+{
+  if(limits.max_count == 0 || limits.max_count < limits.min_count)
+  {
+    THROW_EXCEPTION(std::invalid_argument("invalid object pool limits"));
+  }
+}
+
+} // namespace bibstd::util
@@ -0,0 +1,41 @@
+#include "util/scoped_timer.hpp"
+#include "util/log.hpp"
+
+namespace bibstd::util
+{
+
+///
+///
+scoped_timer::scoped_timer(const std::string_view name)
+  : name_{name}
+  , start_{clock_type::now()}
+{
+}
+
+///
+///
+scoped_timer::~scoped_timer() noexcept
+{
+  stop();
+}
+
+///
+///
+auto scoped_timer::elapsed() const -> clock_type::duration
+{
+  return clock_type::now() - start_;
+}
+
+///
+///
+auto scoped_timer::stop() -> void
+{
+  if(!stopped_)
+  {
+    stopped_ = true;
+    const auto milliseconds = std::chrono::duration<double, std::milli>(elapsed()).count();
+    LOG_INFO("timer stopped: name={}, elapsed_ms={:.1f}", name_, milliseconds);
+  }
+}
+
+} // namespace bibstd::util
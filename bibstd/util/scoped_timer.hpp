@@ -0,0 +1,45 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <string_view>
+
+namespace bibstd::util
+{
+
+///
+/// Timer measuring a named span, e.g. a startup step. The elapsed time is logged when the timer is stopped or destroyed.
+///
+class scoped_timer final
+{
+public: // Typedefs
+  using clock_type = std::chrono::steady_clock;
+
+public: // Structors
+  explicit scoped_timer(std::string_view name);
+  ~scoped_timer() noexcept;
+  scoped_timer(const scoped_timer&) = delete;
+
+public: // Operators
+  auto operator=(const scoped_timer&) -> scoped_timer& = delete;
+
+public: // Accessors
+  ///
+  /// Get the time since the timer was started.
+  /// \return elapsed time
+  ///
+  auto elapsed() const -> clock_type::duration;
+
+public: // Modifiers
+  ///
+  /// Log the elapsed time. Nothing is logged on destruction afterwards.
+  ///
+  auto stop() -> void;
+
+private: // Variables
+  std::string name_;
+  clock_type::time_point start_;
+  bool stopped_{false};
+};
+
+} // namespace bibstd::util
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+
+namespace bibstd::util
+{
+
+///
+/// Vector with a fixed capacity. The elements are stored inline, so the container never allocates.
+/// \tparam T Value type, must be default constructible
+/// \tparam Capacity Maximum number of elements
+///
+template<typename T, std::size_t Capacity>
+class static_vector final
+{
+public: // Typedefs
+  using value_type = T;
+  using size_type = std::size_t;
+  using iterator = typename std::array<T, Capacity>::iterator;
+  using const_iterator = typename std::array<T, Capacity>::const_iterator;
+
+public: // Structors
+  constexpr static_vector() = default;
+
+public: // Operators
+  constexpr auto operator[](size_type index) -> T& { return data_[index]; }
+  constexpr auto operator[](size_type index) const -> const T& { return data_[index]; }
+  constexpr auto operator==(const static_vector& rhs) const -> bool { return std::ranges::equal(*this, rhs); }
+
+public: // Accessors
+  constexpr auto begin() -> iterator { return data_.begin(); }
+  constexpr auto begin() const -> const_iterator { return data_.begin(); }
+  constexpr auto end() -> iterator { return data_.begin() + size_; }
+  constexpr auto end() const -> const_iterator { return data_.begin() + size_; }
+  constexpr auto data() -> T* { return data_.data(); }
+  constexpr auto data() const -> const T* { return data_.data(); }
+  constexpr auto front() const -> const T& { return data_[0]; }
+  constexpr auto back() const -> const T& { return data_[size_ - 1]; }
+  constexpr auto size() const -> size_type { return size_; }
+  constexpr auto empty() const -> bool { return size_ == 0; }
+  constexpr auto full() const -> bool { return size_ == Capacity; }
+  static constexpr auto capacity() -> size_type { return Capacity; }
+
+  ///
+  /// Get element at index with bounds checking.
+  /// \param index Index of the element
+  /// \return element at index
+  ///
+  constexpr auto at(size_type index) const -> const T&;
+
+public: // Modifiers
+  ///
+  /// Append element. Throws std::length_error if the capacity is exhausted.
+  /// \param value Element to append
+  ///
+  constexpr auto push_back(const T& value) -> void;
+
+  ///
+  /// Remove all elements.
+  ///
+  constexpr auto clear() -> void { size_ = 0; }
+
+private: // Variables
+  std::array<T, Capacity> data_{};
+  size_type size_{0};
+};
+
+///
+///
+template<typename T, std::size_t Capacity>
+constexpr auto static_vector<T, Capacity>::at(const size_type index) const -> const T&
+{
+  if(index >= size_)
+  {
+    throw std::out_of_range("static_vector index out of range");
+  }
+  return data_[index];
+}
+
+///
+///
+template<typename T, std::size_t Capacity>
+constexpr auto static_vector<T, Capacity>::push_back(const T& value) -> void
+{
+  if(size_ >= Capacity)
+  {
+    throw std::length_error("static_vector capacity exceeded");
+  }
+  data_[size_++] = value;
+}
+
+} // namespace bibstd::util
@@ -2,6 +2,7 @@
 
 #include <atomic>
 #include <format>
+#include <functional>
 #include <type_traits>
 
 namespace bibstd::util
@@ -15,6 +16,7 @@ class uid final
 {
   // Friends
   friend struct std::formatter<uid<Tag>>;
+  friend struct std::hash<uid<Tag>>;
 
 public: // Typedefs
   using tag_type = Tag;
@@ -78,3 +80,11 @@ struct std::formatter<bibstd::util::uid<T>> : std::formatter<std::uint64_t>
     return formatter<std::uint64_t>::format(std::format("{}", id.value_), ctx);
   }
 };
+
+///
+///
+template<typename T>
+struct std::hash<bibstd::util::uid<T>>
+{
+  auto operator()(const bibstd::util::uid<T> id) const noexcept -> std::size_t { return std::hash<std::uint64_t>{}(id.value_); }
+};
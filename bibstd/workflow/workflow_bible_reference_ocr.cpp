@@ -7,14 +7,37 @@
 #include "data/pixel.hpp"
 #include "data/plane.hpp"
 #include "system/screen.hpp"
+#include "util/enum.hpp"
 #include "util/format.hpp"
+#include "util/scoped_guard.hpp"
 
 #include <array>
+#include <atomic>
+#include <exception>
+#include <latch>
+#include <limits>
 #include <numeric>
+#include <ranges>
 #include <thread>
 
 namespace bibstd::workflow
 {
+namespace detail
+{
+
+///
+/// Move a capture area to the front of the capture areas, so it is recognized first. Areas within this area are removed.
+///
+auto prioritize_capture_area(
+  std::vector<util::screen_types::screen_rect_type>& capture_areas, const util::screen_types::screen_rect_type& area
+) -> void
+{
+  using screen_rect_type = util::screen_types::screen_rect_type;
+  std::erase_if(capture_areas, [&](const auto& capture_area) { return screen_rect_type::contains(area, capture_area); });
+  capture_areas.insert(capture_areas.cbegin(), area);
+}
+
+} // namespace detail
 
 ///
 ///
@@ -23,6 +46,16 @@ workflow_bible_reference_ocr_settings::workflow_bible_reference_ocr_settings()
   : app_framework::settings_base{"OCR"}
   , translations{core_settings_->create_setting("ocr.translations", "Translations", std::vector<bible::translation>{bible::translation::ngu, bible::translation::elb})}
   , assumed_initial_char_height{core_settings_->create_setting("ocr.assumed_initial_char_height", "Assumed Initial Char Height", std::uint16_t{40})}
+  , parallel_capture_areas{core_settings_->create_setting("ocr.parallel_capture_areas", "Parallel Capture Areas", std::uint16_t{1})}
+  , image_preprocessing{core_settings_->create_setting("ocr.image_preprocessing", "Image Preprocessing", core::core_tesseract_common::image_preprocessing::none)}
+  , recognition_strategy{core_settings_->create_setting("ocr.recognition_strategy", "Recognition Strategy", core::core_tesseract_common::recognition_strategy::fast)}
+  , best_model_confidence_threshold{core_settings_->create_setting("ocr.best_model_confidence_threshold", "Best Model Confidence Threshold", 80.0)}
+  , decoded_reference_confidence_threshold{core_settings_->create_setting("ocr.decoded_reference_confidence_threshold", "Decoded Reference Confidence Threshold", 0.0)}
+  , cursor_line_recognition{core_settings_->create_setting("ocr.cursor_line_recognition", "Cursor Line Recognition", true)}
+  , cursor_context_lines{core_settings_->create_setting("ocr.cursor_context_lines", "Cursor Context Lines", std::uint16_t{1})}
+  , capture_area_estimation{core_settings_->create_setting("ocr.capture_area_estimation", "Capture Area Estimation", true)}
+  , capture_profile_learning{core_settings_->create_setting("ocr.capture_profile_learning", "Capture Profile Learning", true)}
+  , capture_profiles{core_settings_->create_setting("ocr.capture_profiles", "Capture Profiles", std::vector<std::string>{})}
 // clang-format on
 {
 }
@@ -30,9 +63,11 @@ workflow_bible_reference_ocr_settings::workflow_bible_reference_ocr_settings()
 ///
 ///
 workflow_bible_reference_ocr::workflow_bible_reference_ocr(language language)
-  : core_bible_reference_ocr_{std::make_unique<core::core_bible_reference_ocr>(language)}
+  : language_{language}
+  , core_tesseract_pool_{core::create_core_tesseract_pool({.min_count = 1, .max_count = 1})}
   , core_bible_reference_{std::make_unique<core::core_bible_reference>()}
   , core_bibleserver_lookup_{std::make_unique<core::core_bibleserver_lookup>()}
+  , engine_trimmer_{[this](const std::stop_token stop_token) { run_engine_trimmer(stop_token); }}
 {
 }
 
@@ -40,6 +75,32 @@ workflow_bible_reference_ocr::workflow_bible_reference_ocr(language language)
 ///
 workflow_bible_reference_ocr::~workflow_bible_reference_ocr() noexcept = default;
 
+///
+///
+auto workflow_bible_reference_ocr::warm_up(const settings_type& settings) -> std::shared_future<void>
+{
+  auto promise = std::promise<void>{};
+  warm_up_ = promise.get_future().share();
+  const auto traineddata =
+    core::core_tesseract_common::traineddata_id{.language = language_, .model = initial_model(settings)};
+  app_framework::thread_pool::queue_task(
+    [this, promise = std::move(promise), traineddata]() mutable
+    {
+      try
+      {
+        core_tesseract_pool_->reserve(traineddata, 1);
+        promise.set_value();
+      }
+      catch(const std::exception& e)
+      {
+        LOG_ERROR("OCR warm-up failed: {}", e.what());
+        promise.set_exception(std::current_exception());
+      }
+    }
+  );
+  return warm_up_;
+}
+
 ///
 ///
 auto workflow_bible_reference_ocr::find_references(const settings_type& settings) -> void
@@ -48,102 +109,547 @@ auto workflow_bible_reference_ocr::find_references(const settings_type& settings
   app_framework::thread_pool::queue_task(
     [this, settings, cursor_position]()
     {
+      // A failed warm-up is not fatal, the engine is initialized again on checkout.
+      if(warm_up_.valid())
+      {
+        warm_up_.wait();
+      }
       settings_ = settings;
-      const auto [is_verified_capture_area, references] = find_references_impl(cursor_position);
+      const auto result = find_references_impl(cursor_position);
       LOG_INFO(
-        "OCR reference search finished: references=[{}], valid_area={}",
-        util::format::join(references, ", "),
-        is_verified_capture_area
+        "OCR reference search finished: references=[{}], valid_area={}, model={}",
+        util::format::join(result.references, ", "),
+        result.verified_capture_area,
+        util::to_string_view(result.model)
       );
       std::ranges::for_each(
-        references,
+        result.references,
         [&](const auto& reference_range) { core_bibleserver_lookup_->open(reference_range, settings_->translations->value()); }
       );
+      schedule_engine_trim();
     },
     strand_id_
   );
 }
 
+///
+/// A following search postpones the trim, so engines created for a series of searches are kept until it ends.
+auto workflow_bible_reference_ocr::schedule_engine_trim() -> void
+{
+  {
+    const auto lock = std::lock_guard(engine_trim_mtx_);
+    engine_trim_deadline_ = std::chrono::steady_clock::now() + engine_idle_timeout;
+  }
+  engine_trim_cv_.notify_one();
+}
+
+///
+/// Trimming only destroys idle engines, so engines checked out by a running search are not affected.
+auto workflow_bible_reference_ocr::run_engine_trimmer(const std::stop_token stop_token) -> void
+{
+  auto lock = std::unique_lock(engine_trim_mtx_);
+  while(!stop_token.stop_requested())
+  {
+    if(!engine_trim_deadline_)
+    {
+      engine_trim_cv_.wait(lock, stop_token, [&] { return engine_trim_deadline_.has_value(); });
+      continue;
+    }
+    const auto deadline = *engine_trim_deadline_;
+    const auto rescheduled =
+      engine_trim_cv_.wait_until(lock, stop_token, deadline, [&] { return engine_trim_deadline_ != deadline; });
+    if(rescheduled || stop_token.stop_requested())
+    {
+      continue;
+    }
+    engine_trim_deadline_.reset();
+    lock.unlock();
+    core_tesseract_pool_->trim();
+    LOG_DEBUG("idle tesseract engines trimmed: idle_timeout={}", engine_idle_timeout);
+    lock.lock();
+  }
+}
+
 ///
 ///
 auto workflow_bible_reference_ocr::find_references_impl(const screen_coordinates_type& cursor_position) -> parse_result_type
 {
-  auto result = parse_result_type{false, {}};
-  const auto capture_areas =
-    core_bible_reference_ocr_->generate_capture_areas(cursor_position, settings_->assumed_initial_char_height->value());
+  const auto parallel_capture_areas = std::max(std::size_t{1}, std::size_t{settings_->parallel_capture_areas->value()});
+  const auto traineddata =
+    core::core_tesseract_common::traineddata_id{.language = language_, .model = initial_model(settings_)};
+  // The limits are set per model, since the model of the fallback recognition is only used for a single area. Its engine
+  // is not kept by the trim.
+  for(const auto engine_model : {model::fast, model::best})
+  {
+    core_tesseract_pool_->set_limits(
+      {.language = language_, .model = engine_model},
+      engine_model == traineddata.model ? core::core_tesseract_pool::limits{.min_count = 1, .max_count = parallel_capture_areas}
+                                        : core::core_tesseract_pool::limits{.min_count = 0, .max_count = 1}
+    );
+  }
+  auto ocrs = ocr_list_type{};
+  ocrs.emplace_back(std::make_unique<core::core_bible_reference_ocr>(core_tesseract_pool_->checkout(traineddata)));
+
+  // The profile of the application at the cursor replaces the assumed char height, so the generated areas start at a
+  // size close to the text size of the application.
+  const auto application =
+    settings_->capture_profile_learning->value() ? system::screen::application_at(cursor_position) : std::nullopt;
+  const auto profile = find_capture_profile(application);
+  const auto assumed_char_height = profile ? profile->char_height : settings_->assumed_initial_char_height->value();
+  auto capture_areas = ocrs.front()->generate_capture_areas(cursor_position, assumed_char_height);
   if(capture_areas.empty())
   {
     LOG_WARN("failed to define capture areas: cursor_position={}", cursor_position);
-    return result;
+    return parse_result_type{};
+  }
+  // The largest capture area contains all other areas, so the screen is captured once and the smaller areas are
+  // recognized on sections of this capture.
+  const auto capture = ocrs.front()->capture_screen_area(capture_areas.back());
+  if(!capture)
+  {
+    LOG_WARN("capture screen failed: capture_area={}", capture_areas.back());
+    return parse_result_type{};
+  }
+  // The capture area of the profile was verified for the application before, so the smaller generated areas are skipped.
+  auto profile_area = std::optional<screen_rect_type>{};
+  if(profile)
+  {
+    const auto half_size = screen_coordinates_type(profile->capture_width / 2, profile->capture_height / 2);
+    profile_area = screen_rect_type::overlap(
+      capture->area, screen_rect_type(cursor_position - half_size, profile->capture_width, profile->capture_height)
+    );
+  }
+  if(profile_area)
+  {
+    detail::prioritize_capture_area(capture_areas, *profile_area);
   }
-  std::ranges::any_of(
-    capture_areas,
-    [&](const auto& capture_area)
+  // The capture area estimated from the text layout is recognized first. The generated areas are the fallback, they are
+  // sized with the estimated char height and areas within the estimated area are skipped.
+  if(settings_->capture_area_estimation->value())
+  {
+    if(const auto estimate = ocrs.front()->estimate_capture_area(*capture, cursor_position, assumed_char_height))
     {
-      if(!core_bible_reference_ocr_->capture_and_set_ocr_area(capture_area))
+      capture_areas = ocrs.front()->generate_capture_areas(cursor_position, estimate->char_height);
+      if(profile_area)
       {
-        LOG_WARN("capture screen failed: capture_area={}", capture_area);
-        return false;
+        detail::prioritize_capture_area(capture_areas, *profile_area);
       }
-      const auto image_dimensions = screen_rect_type({0, 0}, capture_area.horizontal_range(), capture_area.vertical_range());
-      const auto relative_cursor_pos = cursor_position - capture_area.origin();
-      LOG_DEBUG(
-        "find references: capture_area={}, cursor_position={}, image_dimensions={}, relative_cursor_pos={}",
-        capture_area,
-        cursor_position,
-        image_dimensions,
-        relative_cursor_pos
-      );
-      auto area_result = parse_tesseract_recognition(image_dimensions, relative_cursor_pos);
-      if(!area_result.second.empty())
+      detail::prioritize_capture_area(capture_areas, estimate->capture_area);
+    }
+  }
+  // Further engines are only checked out if they are idle or can be created within the pool limits.
+  const auto engine_count = std::min(capture_areas.size(), parallel_capture_areas);
+  while(ocrs.size() < engine_count)
+  {
+    auto lease = core_tesseract_pool_->try_checkout(traineddata);
+    if(!lease)
+    {
+      break;
+    }
+    ocrs.emplace_back(std::make_unique<core::core_bible_reference_ocr>(std::move(*lease)));
+  }
+  const auto image_preprocessing = settings_->image_preprocessing->value();
+  std::ranges::for_each(ocrs, [&](auto& ocr) { ocr->set_image_preprocessing(image_preprocessing); });
+  auto result = ocrs.size() > 1 ? find_references_parallel(ocrs, capture_areas, *capture, cursor_position)
+                                : find_references_sequential(*ocrs.front(), capture_areas, *capture, cursor_position);
+  // The best model recognizes only the cursor paragraph found by the fast model once.
+  if(requires_best_model(result))
+  {
+    result = recognize_with_best_model(std::move(result), *capture, cursor_position);
+  }
+  if(application)
+  {
+    record_capture_profile(*application, result);
+  }
+  return result;
+}
+
+///
+/// A verified capture area without references does not end the search, the text at the cursor might be recognized
+/// correctly in a larger area.
+auto workflow_bible_reference_ocr::is_final_area_result(const parse_result_type& area_result) -> bool
+{
+  return area_result.verified_capture_area && !area_result.references.empty();
+}
+
+///
+/// The area results are ordered like the capture areas. The first final result is taken. Without a final result the
+/// result of the largest area with references is taken, in case the OCR of the larger areas failed. Without references
+/// only the paragraph of the largest area with a paragraph at the cursor is kept, so the best model can recognize it.
+auto workflow_bible_reference_ocr::select_area_result(std::vector<parse_result_type>&& area_results) -> parse_result_type
+{
+  if(const auto final_result = std::ranges::find_if(area_results, is_final_area_result); final_result != area_results.end())
+  {
+    return std::move(*final_result);
+  }
+  const auto has_references = [](const auto& area_result) { return !area_result.references.empty(); };
+  if(const auto found = std::ranges::find_if(area_results | std::views::reverse, has_references);
+     found != std::ranges::rend(area_results))
+  {
+    return std::move(*found);
+  }
+  const auto has_paragraph = [](const auto& area_result) { return area_result.paragraph_area.has_value(); };
+  const auto recognized = std::ranges::find_if(area_results | std::views::reverse, has_paragraph);
+  if(recognized == std::ranges::rend(area_results))
+  {
+    return parse_result_type{};
+  }
+  return parse_result_type{
+    .model = recognized->model,
+    .capture_area = recognized->capture_area,
+    .paragraph_area = recognized->paragraph_area,
+    .mean_confidence = recognized->mean_confidence,
+  };
+}
+
+///
+///
+auto workflow_bible_reference_ocr::find_references_sequential(
+  core::core_bible_reference_ocr& ocr,
+  const std::vector<screen_rect_type>& capture_areas,
+  const screen_capture_type& capture,
+  const screen_coordinates_type& cursor_position
+) -> parse_result_type
+{
+  auto area_results = std::vector<parse_result_type>{};
+  area_results.reserve(capture_areas.size());
+  for(const auto& capture_area : capture_areas)
+  {
+    area_results.push_back(recognize_capture_area(ocr, capture_area, capture, cursor_position, {}));
+    if(is_final_area_result(area_results.back()))
+    {
+      break;
+    }
+  }
+  return select_area_result(std::move(area_results));
+}
+
+///
+///
+auto workflow_bible_reference_ocr::find_references_parallel(
+  const ocr_list_type& ocrs,
+  const std::vector<screen_rect_type>& capture_areas,
+  const screen_capture_type& capture,
+  const screen_coordinates_type& cursor_position
+) -> parse_result_type
+{
+  static constexpr auto no_area = std::numeric_limits<std::size_t>::max();
+  // Each engine takes the next capture area that is not taken yet, so the areas are started from the smallest to the largest.
+  // A final result cancels the running recognitions of the larger areas and skips the remaining areas. The smaller areas
+  // are completed, so the same result as with the sequential search is selected.
+  auto area_results = std::vector<parse_result_type>(capture_areas.size());
+  auto stop_sources = std::vector<std::stop_source>(capture_areas.size());
+  auto next_area = std::atomic_size_t{0};
+  auto final_area = std::atomic_size_t{no_area};
+  const auto run_engine = [&](core::core_bible_reference_ocr& ocr)
+  {
+    for(auto i = next_area++; i < capture_areas.size() && i < final_area.load(); i = next_area++)
+    {
+      const auto stop_token = stop_sources[i].get_token();
+      area_results[i] = recognize_capture_area(ocr, capture_areas[i], capture, cursor_position, stop_token);
+      if(!is_final_area_result(area_results[i]))
       {
-        result = std::move(area_result);
+        continue;
       }
-      return result.first;
+      // The smallest final area is kept, a smaller area might finish after a larger one.
+      auto current = final_area.load();
+      while(i < current && !final_area.compare_exchange_weak(current, i))
+      {
+        continue;
+      }
+      if(i < current)
+      {
+        std::ranges::for_each(stop_sources | std::views::drop(i + 1), [](auto& e) { e.request_stop(); });
+      }
+    }
+  };
+  // An engine task is run by the thread that claims it first. The search runs the first engine itself and claims the engine
+  // tasks that were not started by other workers afterwards, so it never waits for tasks that are still queued behind it.
+  // The claims are shared with the tasks, since a claimed task might run after the search returned.
+  const auto claimed = std::make_shared<std::atomic_bool[]>(ocrs.size());
+  auto engines_done = std::latch{static_cast<std::ptrdiff_t>(ocrs.size() - 1)};
+  for(std::size_t e = 1; e < ocrs.size(); ++e)
+  {
+    app_framework::thread_pool::queue_task(
+      [&, claimed, e]
+      {
+        if(!claimed[e].exchange(true))
+        {
+          // The guard counts down even if the recognition throws.
+          const auto done_guard = util::scoped_guard([&engines_done] { engines_done.count_down(); });
+          run_engine(*ocrs[e]);
+        }
+      }
+    );
+  }
+  run_engine(*ocrs.front());
+  for(std::size_t e = 1; e < ocrs.size(); ++e)
+  {
+    if(!claimed[e].exchange(true))
+    {
+      engines_done.count_down();
     }
+  }
+  engines_done.wait();
+  return select_area_result(std::move(area_results));
+}
+
+///
+///
+auto workflow_bible_reference_ocr::recognize_capture_area(
+  core::core_bible_reference_ocr& ocr,
+  const screen_rect_type& capture_area,
+  const screen_capture_type& capture,
+  const screen_coordinates_type& cursor_position,
+  const std::stop_token stop_token
+) -> parse_result_type
+{
+  if(!ocr.set_ocr_area(capture, capture_area) && !ocr.capture_and_set_ocr_area(capture_area))
+  {
+    LOG_WARN("capture screen failed: capture_area={}", capture_area);
+    return parse_result_type{};
+  }
+  const auto image_dimensions = screen_rect_type({0, 0}, capture_area.horizontal_range(), capture_area.vertical_range());
+  const auto relative_cursor_pos = cursor_position - capture_area.origin();
+  LOG_DEBUG(
+    "find references: capture_area={}, model={}, cursor_position={}, image_dimensions={}, relative_cursor_pos={}",
+    capture_area,
+    util::to_string_view(ocr.model()),
+    cursor_position,
+    image_dimensions,
+    relative_cursor_pos
+  );
+  auto result = parse_tesseract_recognition(ocr, image_dimensions, relative_cursor_pos, stop_token);
+  result.capture_area = capture_area;
+  // The paragraph of the recognition is relative to the capture area.
+  if(result.paragraph_area)
+  {
+    const auto& paragraph = *result.paragraph_area;
+    result.mean_confidence = ocr.mean_symbol_confidence(paragraph);
+    result.paragraph_area = screen_rect_type(
+      paragraph.origin() + capture_area.origin(), paragraph.horizontal_range(), paragraph.vertical_range()
+    );
+  }
+  return result;
+}
+
+///
+/// The engine of the best model is only created when the fast model failed. Without a best model the fast result is kept,
+/// and the failed initialization is not repeated by the following searches. The image of the fast result is set again, so
+/// the capture area is verified as before, but only the cursor paragraph is recognized without a layout analysis.
+auto workflow_bible_reference_ocr::recognize_with_best_model(
+  parse_result_type&& fast_result, const screen_capture_type& capture, const screen_coordinates_type& cursor_position
+) -> parse_result_type
+{
+  if(best_model_unavailable_ || !fast_result.capture_area || !fast_result.paragraph_area)
+  {
+    return std::move(fast_result);
+  }
+  auto best_lease = core::core_tesseract_pool::lease{};
+  try
+  {
+    best_lease = core_tesseract_pool_->checkout({.language = language_, .model = model::best});
+  }
+  catch(const std::exception& e)
+  {
+    best_model_unavailable_ = true;
+    LOG_WARN("best model not available, fast model results are kept: {}", e.what());
+    return std::move(fast_result);
+  }
+  auto best_ocr = core::core_bible_reference_ocr(std::move(best_lease));
+  best_ocr.set_image_preprocessing(settings_->image_preprocessing->value());
+  const auto capture_area = *fast_result.capture_area;
+  const auto paragraph_area = *fast_result.paragraph_area;
+  if(!best_ocr.set_ocr_area(capture, capture_area) && !best_ocr.capture_and_set_ocr_area(capture_area))
+  {
+    LOG_WARN("capture screen failed: capture_area={}", capture_area);
+    return std::move(fast_result);
+  }
+  const auto image_dimensions = screen_rect_type({0, 0}, capture_area.horizontal_range(), capture_area.vertical_range());
+  const auto relative_cursor_pos = cursor_position - capture_area.origin();
+  const auto paragraph = screen_rect_type(
+    paragraph_area.origin() - capture_area.origin(), paragraph_area.horizontal_range(), paragraph_area.vertical_range()
+  );
+  if(!best_ocr.recognize_area(paragraph))
+  {
+    return std::move(fast_result);
+  }
+  auto best_result = parse_recognized_text(best_ocr, image_dimensions, paragraph, relative_cursor_pos, std::nullopt).first;
+  best_result.capture_area = capture_area;
+  best_result.paragraph_area = paragraph_area;
+  best_result.mean_confidence = best_ocr.mean_symbol_confidence(paragraph);
+  const auto use_best_result = !best_result.references.empty() || best_result.verified_capture_area;
+  LOG_DEBUG(
+    "best model fallback: paragraph_area={}, fast_references=[{}], best_references=[{}], used_model={}",
+    paragraph_area,
+    util::format::join(fast_result.references, ", "),
+    util::format::join(best_result.references, ", "),
+    util::to_string_view(use_best_result ? best_result.model : fast_result.model)
   );
+  return use_best_result ? std::move(best_result) : std::move(fast_result);
+}
+
+///
+/// The fast result is kept if it found references with a sufficient mean symbol confidence. A cancelled or failed
+/// recognition leaves an empty page, so the confidence is 0 in that case.
+auto workflow_bible_reference_ocr::requires_best_model(const parse_result_type& fast_result) const -> bool
+{
+  if(settings_->recognition_strategy->value() != core::core_tesseract_common::recognition_strategy::fast_then_best ||
+     fast_result.model != model::fast)
+  {
+    return false;
+  }
+  const auto confidence = fast_result.mean_confidence;
+  const auto threshold = settings_->best_model_confidence_threshold->value();
+  const auto result = fast_result.references.empty() || confidence < threshold;
+  if(result)
+  {
+    LOG_DEBUG(
+      "fast model result rejected: references=[{}], mean_confidence={:.1f}, threshold={:.1f}",
+      util::format::join(fast_result.references, ", "),
+      confidence,
+      threshold
+    );
+  }
+  return result;
+}
+
+///
+///
+auto workflow_bible_reference_ocr::initial_model(const settings_type& settings) -> model
+{
+  const auto strategy = settings->recognition_strategy->value();
+  return strategy == core::core_tesseract_common::recognition_strategy::best ? model::best : model::fast;
+}
+
+///
+///
+auto workflow_bible_reference_ocr::find_capture_profile(const std::optional<std::string>& application) const
+  -> std::optional<capture_profile_type>
+{
+  if(!application)
+  {
+    return std::nullopt;
+  }
+  const auto result = core::core_capture_profiles(settings_->capture_profiles->value()).find(*application);
+  if(result)
+  {
+    LOG_DEBUG(
+      "capture profile found: application={}, char_height={}, capture_width={}, capture_height={}",
+      *application,
+      result->char_height,
+      result->capture_width,
+      result->capture_height
+    );
+  }
   return result;
 }
 
+///
+/// Only verified capture areas are recorded, the areas of unverified results might be too small for the application.
+auto workflow_bible_reference_ocr::record_capture_profile(const std::string& application, const parse_result_type& result)
+  -> void
+{
+  if(!result.verified_capture_area || !result.capture_area || result.char_height == 0)
+  {
+    return;
+  }
+  const auto profile = capture_profile_type{
+    .char_height = result.char_height,
+    .capture_width = result.capture_area->horizontal_range(),
+    .capture_height = result.capture_area->vertical_range(),
+  };
+  auto profiles = core::core_capture_profiles(settings_->capture_profiles->value());
+  profiles.record(application, profile);
+  settings_->capture_profiles->value(profiles.entries());
+  LOG_DEBUG(
+    "capture profile recorded: application={}, char_height={}, capture_area={}",
+    application,
+    profile.char_height,
+    *result.capture_area
+  );
+}
+
 ///
 ///
 auto workflow_bible_reference_ocr::parse_tesseract_recognition(
-  const screen_rect_type& image_dimensions, const screen_coordinates_type& relative_cursor_pos
+  core::core_bible_reference_ocr& ocr,
+  const screen_rect_type& image_dimensions,
+  const screen_coordinates_type& relative_cursor_pos,
+  const std::stop_token stop_token
 ) -> parse_result_type
 {
-  const auto paragraph_bounding_box_opt = core_bible_reference_ocr_->recognize_paragraph_bounding_box(relative_cursor_pos);
+  // The verification of the capture area and the parser only look at the cursor line and its neighbours, so with the
+  // cursor line recognition the rest of the paragraph is only recognized if a reference continues in the skipped lines.
+  auto cursor_lines = std::optional<cursor_lines_recognition_type>{};
+  auto paragraph_bounding_box_opt = std::optional<screen_rect_type>{};
+  if(settings_->cursor_line_recognition->value())
+  {
+    cursor_lines = ocr.recognize_cursor_lines(relative_cursor_pos, settings_->cursor_context_lines->value(), stop_token);
+    paragraph_bounding_box_opt = cursor_lines ? std::make_optional(cursor_lines->paragraph_bounding_box) : std::nullopt;
+  }
+  else
+  {
+    paragraph_bounding_box_opt = ocr.recognize_paragraph_bounding_box(relative_cursor_pos, stop_token);
+  }
   if(!paragraph_bounding_box_opt)
   {
-    return std::pair{false, std::vector<bible::reference_range>{}};
+    return parse_result_type{.model = ocr.model()};
+  }
+  auto [result, is_cut_off] =
+    parse_recognized_text(ocr, image_dimensions, *paragraph_bounding_box_opt, relative_cursor_pos, cursor_lines);
+  if(is_cut_off)
+  {
+    LOG_DEBUG("reference continues in skipped lines, recognize paragraph: paragraph={}", *paragraph_bounding_box_opt);
+    if(!ocr.recognize_area(*paragraph_bounding_box_opt, stop_token))
+    {
+      return parse_result_type{.model = ocr.model()};
+    }
+    result = parse_recognized_text(ocr, image_dimensions, *paragraph_bounding_box_opt, relative_cursor_pos, std::nullopt)
+               .first;
   }
+  result.paragraph_area = *paragraph_bounding_box_opt;
+  return std::move(result);
+}
+
+///
+/// The second value of the result is true if the found reference might continue in lines of the paragraph that were
+/// skipped by the cursor lines recognition.
+auto workflow_bible_reference_ocr::parse_recognized_text(
+  core::core_bible_reference_ocr& ocr,
+  const screen_rect_type& image_dimensions,
+  const screen_rect_type& paragraph_bounding_box,
+  const screen_coordinates_type& relative_cursor_pos,
+  const std::optional<cursor_lines_recognition_type>& cursor_lines
+) -> std::pair<parse_result_type, bool>
+{
   auto is_verified_capture_area = false;
+  auto is_cut_off = false;
   auto references = std::vector<bible::reference_range>{};
-  const auto& paragraph_bounding_box = *paragraph_bounding_box_opt;
-  const auto position_data = core_bible_reference_ocr_->find_main_reference_position_data(relative_cursor_pos);
+  const auto position_data = ocr.find_main_reference_position_data(relative_cursor_pos);
+  const auto cut_off = [&](const auto& data, const auto& index_range)
+  { return cursor_lines && core::core_bible_reference_ocr::is_reference_cut_off(*cursor_lines, data, index_range); };
   if(position_data)
   {
     auto parse_result = core_bible_reference_->parse(position_data->text, position_data->cursor_character_index);
     // Parse result might be empty but the capture area is still valid.
     // This is the case when the text is not a valid reference but the characters found in the image are
     // within the capture area including a safety margin. In this case no larger area is captured.
-    is_verified_capture_area = core_bible_reference_ocr_->is_verified_capture_area(
+    is_verified_capture_area = ocr.is_verified_capture_area(
       relative_cursor_pos, image_dimensions, paragraph_bounding_box, *position_data, parse_result.index_range_origin
     );
-    // If the capture area is valid but no references are found, we parse other high confidence OCR choices.
-    // If a parse result is found and the area is valid we break out.
+    is_cut_off = !parse_result.ranges.empty() && cut_off(*position_data, parse_result.index_range_origin);
+    // If the capture area is valid but no references are found, the references are decoded from the OCR choices.
+    // The best decoded reference is taken if its confidence reaches the threshold.
     if(parse_result.ranges.empty())
     {
-      const auto position_data_choices =
-        core_bible_reference_ocr_->find_reference_position_data_from_choices(relative_cursor_pos);
-      std::ranges::any_of(
-        position_data_choices,
-        [&](const auto& position_data_choice)
-        {
-          parse_result = core_bible_reference_->parse(position_data_choice.text, position_data_choice.cursor_character_index);
-          return !parse_result.ranges.empty();
-        }
-      );
-      references = parse_result.ranges;
+      const auto decoded = ocr.decode_references_from_choices(relative_cursor_pos, 1);
+      if(!decoded.empty() && decoded.front().confidence >= settings_->decoded_reference_confidence_threshold->value())
+      {
+        parse_result.ranges = decoded.front().ranges;
+        parse_result.index_range_origin = decoded.front().index_range_origin;
+        is_cut_off = cut_off(decoded.front().position_data, decoded.front().index_range_origin);
+      }
     }
     // If some references are found but the valid capture area is not valid, we keep the reference,
     // in case the OCR with larger images fail.
@@ -151,13 +657,24 @@ auto workflow_bible_reference_ocr::parse_tesseract_recognition(
     references = parse_result.ranges;
   }
   LOG_DEBUG(
-    "parse recognition result: references=[{}], verified_capture_area={}, image_dimensions={}, relative_cursor_pos={}",
+    "parse recognition result: references=[{}], verified_capture_area={}, cut_off={}, image_dimensions={}, "
+    "relative_cursor_pos={}",
     util::format::join(references, ", "),
     is_verified_capture_area,
+    is_cut_off,
     image_dimensions,
     relative_cursor_pos
   );
-  return parse_result_type{is_verified_capture_area, references};
+  return std::pair{
+    parse_result_type{
+      .verified_capture_area = is_verified_capture_area,
+      .references = std::move(references),
+      .model = ocr.model(),
+      .capture_area = std::nullopt,
+      .char_height = is_verified_capture_area ? ocr.measure_char_height(relative_cursor_pos).value_or(0) : std::uint16_t{0},
+    },
+    is_cut_off
+  };
 }
 
 } // namespace bibstd::workflow
@@ -4,13 +4,24 @@
 #include "app_framework/thread_pool.hpp"
 #include "bible/reference_range.hpp"
 #include "core/core_bible_reference_ocr_common.hpp"
+#include "core/core_capture_profiles.hpp"
 #include "core/core_tesseract_common.hpp"
+#include "core/core_tesseract_pool.hpp"
 #include "math/value_range.hpp"
 #include "util/screen_types.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <functional>
+#include <future>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 namespace bibstd::core
@@ -39,6 +50,19 @@ public: // Structors
 public: // Variables
   const setting_type<std::vector<bible::translation>> translations;
   const setting_type<std::uint16_t> assumed_initial_char_height;
+  const setting_type<std::uint16_t> parallel_capture_areas;
+  const setting_type<core::core_tesseract_common::image_preprocessing> image_preprocessing;
+  // The best model of `fast_then_best` and `best` is not in the resources, tessdata-best/deu.traineddata must be added.
+  const setting_type<core::core_tesseract_common::recognition_strategy> recognition_strategy;
+  // Minimum mean symbol confidence of a fast model result in the range [0, 100], below it the best model is used.
+  const setting_type<double> best_model_confidence_threshold;
+  // Minimum confidence of a decoded reference in the range [0, 100] of the symbol choice confidences.
+  const setting_type<double> decoded_reference_confidence_threshold;
+  const setting_type<bool> cursor_line_recognition;
+  const setting_type<std::uint16_t> cursor_context_lines;
+  const setting_type<bool> capture_area_estimation;
+  const setting_type<bool> capture_profile_learning;
+  const setting_type<std::vector<std::string>> capture_profiles;
 };
 
 ///
@@ -55,25 +79,118 @@ public: // Structors
   ~workflow_bible_reference_ocr() noexcept;
 
 public: // Modifiers
+  ///
+  /// Initialize the OCR engine in the thread pool, so the model loading is not done on the first search.
+  /// Searches that are started before the warm-up finished wait for it in the thread pool.
+  /// \param settings Settings of the following searches, the engine of their initial model is initialized
+  /// \return future that is ready when the warm-up finished
+  ///
+  auto warm_up(const settings_type& settings) -> std::shared_future<void>;
+
   auto find_references(const settings_type& settings) -> void;
 
+private: // Constants
+  ///
+  /// Idle time after a search, after which the engines above the minimum count of the pool are destroyed.
+  ///
+  static constexpr auto engine_idle_timeout = std::chrono::minutes{1};
+
 private: // Typedefs
   using screen_rect_type = util::screen_types::screen_rect_type;
   using screen_coordinates_type = util::screen_types::screen_coordinates_type;
-  using parse_result_type = std::pair<bool, std::vector<bible::reference_range>>;
+  using model = core::core_tesseract_common::model;
+  using screen_capture_type = core::core_bible_reference_ocr_common::screen_capture;
+  using cursor_lines_recognition_type = core::core_bible_reference_ocr_common::cursor_lines_recognition;
+  using capture_profile_type = core::core_capture_profiles::profile;
+  using ocr_list_type = std::vector<std::unique_ptr<core::core_bible_reference_ocr>>;
+
+  ///
+  /// Result of the recognition of a capture area.
+  /// \param verified_capture_area True if the capture area is large enough, so no larger area must be recognized
+  /// \param references References found in the capture area
+  /// \param model Model of the engine that produced the result
+  /// \param capture_area Recognized capture area, std::nullopt if no area was recognized
+  /// \param paragraph_area Screen area of the paragraph at the cursor, std::nullopt if no paragraph was found
+  /// \param char_height Measured character height of the cursor line if the capture area is verified, 0 otherwise
+  /// \param mean_confidence Mean symbol confidence of the paragraph at the cursor in the range [0, 100]
+  ///
+  struct parse_result_type final
+  {
+    bool verified_capture_area{false};
+    std::vector<bible::reference_range> references;
+    core::core_tesseract_common::model model{core::core_tesseract_common::model::fast};
+    std::optional<screen_rect_type> capture_area;
+    std::optional<screen_rect_type> paragraph_area;
+    std::uint16_t char_height{0};
+    double mean_confidence{0.0};
+  };
 
 private: // Implementation
+  auto schedule_engine_trim() -> void;
+  auto run_engine_trimmer(std::stop_token stop_token) -> void;
   auto find_references_impl(const screen_coordinates_type& cursor_position) -> parse_result_type;
-  auto parse_tesseract_recognition(const screen_rect_type& image_dimensions, const screen_coordinates_type& relative_cursor_pos)
-    -> parse_result_type;
+  static auto is_final_area_result(const parse_result_type& area_result) -> bool;
+  static auto select_area_result(std::vector<parse_result_type>&& area_results) -> parse_result_type;
+  auto find_references_sequential(
+    core::core_bible_reference_ocr& ocr,
+    const std::vector<screen_rect_type>& capture_areas,
+    const screen_capture_type& capture,
+    const screen_coordinates_type& cursor_position
+  ) -> parse_result_type;
+  auto find_references_parallel(
+    const ocr_list_type& ocrs,
+    const std::vector<screen_rect_type>& capture_areas,
+    const screen_capture_type& capture,
+    const screen_coordinates_type& cursor_position
+  ) -> parse_result_type;
+  auto recognize_capture_area(
+    core::core_bible_reference_ocr& ocr,
+    const screen_rect_type& capture_area,
+    const screen_capture_type& capture,
+    const screen_coordinates_type& cursor_position,
+    std::stop_token stop_token
+  ) -> parse_result_type;
+  auto recognize_with_best_model(
+    parse_result_type&& fast_result,
+    const screen_capture_type& capture,
+    const screen_coordinates_type& cursor_position
+  ) -> parse_result_type;
+  auto requires_best_model(const parse_result_type& fast_result) const -> bool;
+  static auto initial_model(const settings_type& settings) -> model;
+  auto find_capture_profile(const std::optional<std::string>& application) const -> std::optional<capture_profile_type>;
+  auto record_capture_profile(const std::string& application, const parse_result_type& result) -> void;
+  auto parse_tesseract_recognition(
+    core::core_bible_reference_ocr& ocr,
+    const screen_rect_type& image_dimensions,
+    const screen_coordinates_type& relative_cursor_pos,
+    std::stop_token stop_token
+  ) -> parse_result_type;
+  auto parse_recognized_text(
+    core::core_bible_reference_ocr& ocr,
+    const screen_rect_type& image_dimensions,
+    const screen_rect_type& paragraph_bounding_box,
+    const screen_coordinates_type& relative_cursor_pos,
+    const std::optional<cursor_lines_recognition_type>& cursor_lines
+  ) -> std::pair<parse_result_type, bool>;
 
 private: // Variables
+  const language language_;
   const app_framework::thread_pool::strand_id_type strand_id_{app_framework::thread_pool::strand_id()};
-  const std::unique_ptr<core::core_bible_reference_ocr> core_bible_reference_ocr_;
+  // Engines are checked out per search, the pool keeps them initialized between searches.
+  const std::unique_ptr<core::core_tesseract_pool> core_tesseract_pool_;
+  std::shared_future<void> warm_up_;
+  // The language is fixed, so a best model that failed to initialize is missing for all following searches.
+  std::atomic_bool best_model_unavailable_{false};
   const std::unique_ptr<core::core_bible_reference> core_bible_reference_;
   const std::unique_ptr<core::core_bibleserver_lookup> core_bibleserver_lookup_;
 
   settings_type settings_{nullptr};
+
+  // The trimmer is declared last, so it is stopped before the pool is destroyed.
+  std::mutex engine_trim_mtx_;
+  std::condition_variable_any engine_trim_cv_;
+  std::optional<std::chrono::steady_clock::time_point> engine_trim_deadline_;
+  std::jthread engine_trimmer_;
 };
 
 } // namespace bibstd::workflow
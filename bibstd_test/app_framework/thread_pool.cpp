@@ -0,0 +1,253 @@
+#include <app_framework/thread_pool.hpp>
+
+#include <catch2/catch_all.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <latch>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace bibstd::app_framework
+{
+
+TEST_CASE("thread_pool", "[app_framework]")
+{
+  const auto pool_guard = thread_pool::init();
+
+  GIVEN("tasks of a strand")
+  {
+    constexpr int task_count = 1000;
+    const auto id = thread_pool::strand_id();
+    auto order = std::vector<int>{};
+    auto running = std::atomic_int{0};
+    auto overlapped = std::atomic_bool{false};
+    auto done = std::latch{task_count};
+    for(int i = 0; i < task_count; ++i)
+    {
+      thread_pool::queue_task(
+        [&, i]
+        {
+          overlapped = overlapped || ++running > 1;
+          order.push_back(i);
+          --running;
+          done.count_down();
+        },
+        id
+      );
+    }
+    done.wait();
+    CHECK(!overlapped);
+    REQUIRE(order.size() == task_count);
+    CHECK(std::ranges::is_sorted(order));
+  }
+
+  GIVEN("a strand queueing again after it ran empty")
+  {
+    // The strand is erased when it runs empty, the strand ID gets a new strand for the next task.
+    constexpr int round_count = 100;
+    const auto id = thread_pool::strand_id();
+    auto order = std::vector<int>{};
+    for(int i = 0; i < round_count; ++i)
+    {
+      auto done = std::latch{2};
+      for(int j = 0; j < 2; ++j)
+      {
+        thread_pool::queue_task(
+          [&, value = 2 * i + j]
+          {
+            order.push_back(value);
+            done.count_down();
+          },
+          id
+        );
+      }
+      done.wait();
+    }
+    REQUIRE(order.size() == 2 * round_count);
+    CHECK(std::ranges::is_sorted(order));
+  }
+
+  GIVEN("tasks waiting for each other")
+  {
+    // Each task waits for the task it queued, so the pool has to grow while all workers are busy.
+    constexpr std::size_t depth = 8;
+    auto finished = std::vector<std::unique_ptr<std::latch>>{};
+    for(std::size_t i = 0; i < depth; ++i)
+    {
+      finished.emplace_back(std::make_unique<std::latch>(1));
+    }
+    auto queue_level = std::function<void(std::size_t)>{};
+    queue_level = [&](const std::size_t level)
+    {
+      thread_pool::queue_task(
+        [&, level]
+        {
+          if(level + 1 < depth)
+          {
+            queue_level(level + 1);
+            finished[level + 1]->wait();
+          }
+          finished[level]->count_down();
+        }
+      );
+    };
+    queue_level(0);
+    finished.front()->wait();
+  }
+
+  GIVEN("tasks queued from tasks")
+  {
+    constexpr int task_count = 100;
+    auto sum = std::atomic_int{0};
+    auto done = std::latch{task_count * task_count};
+    for(int i = 0; i < task_count; ++i)
+    {
+      thread_pool::queue_task(
+        [&]
+        {
+          for(int j = 0; j < task_count; ++j)
+          {
+            thread_pool::queue_task(
+              [&, j]
+              {
+                sum += j;
+                done.count_down();
+              }
+            );
+          }
+        }
+      );
+    }
+    done.wait();
+    CHECK(sum == task_count * task_count * (task_count - 1) / 2);
+  }
+}
+
+TEST_CASE("thread_pool shutdown", "[app_framework]")
+{
+  auto pool_guard = thread_pool::init();
+  const auto id = thread_pool::strand_id();
+  auto started = std::latch{1};
+  auto dropped = std::latch{1};
+  auto queued_task_run = std::atomic_bool{false};
+  // The first task waits for the second one, which stays queued behind it in the strand until the shutdown drops it.
+  thread_pool::queue_task(
+    [&]
+    {
+      started.count_down();
+      dropped.wait();
+    },
+    id
+  );
+  started.wait();
+  thread_pool::queue_task(
+    [&, guard = util::scoped_guard([&] { dropped.count_down(); })] { queued_task_run = true; }, id
+  );
+  pool_guard = util::scoped_guard{};
+  CHECK(!queued_task_run);
+}
+
+TEST_CASE("thread_pool shutdown with queued tasks", "[app_framework]")
+{
+  auto pool_guard = thread_pool::init();
+  constexpr int task_count = 1000;
+  auto run_count = std::atomic_int{0};
+  auto destroyed_count = std::atomic_int{0};
+  for(int i = 0; i < task_count; ++i)
+  {
+    thread_pool::queue_task([&, guard = util::scoped_guard([&] { ++destroyed_count; })] { ++run_count; });
+  }
+  // Every task has either run or was dropped when the guard is destroyed, no task runs afterwards.
+  pool_guard = util::scoped_guard{};
+  CHECK(destroyed_count == task_count);
+  const auto final_run_count = run_count.load();
+  CHECK(final_run_count <= task_count);
+  thread_pool::queue_task([&] { ++run_count; });
+  CHECK(run_count == final_run_count);
+  CHECK(thread_pool::worker_count() == 0);
+}
+
+TEST_CASE("thread_pool idle workers", "[app_framework]")
+{
+  using namespace std::chrono_literals;
+  auto pool_guard = thread_pool::init(10ms);
+  constexpr std::size_t blocked_count = 4;
+  auto started = std::latch{blocked_count};
+  auto released = std::latch{1};
+  auto finished = std::latch{blocked_count};
+  // Blocked tasks keep all workers busy, so the pool grows.
+  for(std::size_t i = 0; i < blocked_count; ++i)
+  {
+    thread_pool::queue_task(
+      [&]
+      {
+        started.count_down();
+        released.wait();
+        finished.count_down();
+      }
+    );
+  }
+  started.wait();
+  CHECK(thread_pool::worker_count() >= blocked_count);
+  released.count_down();
+  finished.wait();
+
+  // Idle workers are retired while the pool is used, one after another.
+  const auto deadline = std::chrono::steady_clock::now() + 10s;
+  while(thread_pool::worker_count() > 1 && std::chrono::steady_clock::now() < deadline)
+  {
+    std::this_thread::sleep_for(20ms);
+    auto done = std::latch{1};
+    thread_pool::queue_task([&] { done.count_down(); });
+    done.wait();
+  }
+  CHECK(thread_pool::worker_count() == 1);
+
+  // A retired worker is started again.
+  auto restarted = std::latch{2};
+  auto restart_released = std::latch{1};
+  for(int i = 0; i < 2; ++i)
+  {
+    thread_pool::queue_task(
+      [&]
+      {
+        restarted.count_down();
+        restart_released.wait();
+      }
+    );
+  }
+  restarted.wait();
+  CHECK(thread_pool::worker_count() >= 2);
+  restart_released.count_down();
+  pool_guard = util::scoped_guard{};
+}
+
+TEST_CASE("thread_pool benchmark", "[.][benchmark]")
+{
+  const auto pool_guard = thread_pool::init();
+  constexpr int task_count = 10000;
+  const auto id = thread_pool::strand_id();
+  BENCHMARK("queue 10000 tasks")
+  {
+    auto done = std::latch{task_count};
+    for(int i = 0; i < task_count; ++i)
+    {
+      thread_pool::queue_task([&] { done.count_down(); });
+    }
+    done.wait();
+  };
+  BENCHMARK("queue 10000 strand tasks")
+  {
+    auto done = std::latch{task_count};
+    for(int i = 0; i < task_count; ++i)
+    {
+      thread_pool::queue_task([&] { done.count_down(); }, id);
+    }
+    done.wait();
+  };
+}
+
+} // namespace bibstd::app_framework
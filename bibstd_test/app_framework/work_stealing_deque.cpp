@@ -0,0 +1,85 @@
+#include <app_framework/work_stealing_deque.hpp>
+
+#include <catch2/catch_all.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace bibstd::app_framework
+{
+
+TEST_CASE("work_stealing_deque", "[app_framework]")
+{
+  GIVEN("items pushed by the owner")
+  {
+    auto deque = work_stealing_deque<int>(4);
+    CHECK(deque.empty());
+    for(int i = 0; i < 10; ++i)
+    {
+      deque.push(i);
+    }
+    CHECK(!deque.empty());
+    CHECK(deque.steal() == 0);
+    CHECK(deque.steal() == 1);
+    CHECK(deque.pop() == 9);
+    CHECK(deque.pop() == 8);
+    for(int i = 2; i < 8; ++i)
+    {
+      CHECK(deque.steal() == i);
+    }
+    CHECK(deque.empty());
+    CHECK(deque.pop() == std::nullopt);
+    CHECK(deque.steal() == std::nullopt);
+  }
+
+  GIVEN("concurrent owner and thieves")
+  {
+    constexpr int item_count = 100000;
+    auto deque = work_stealing_deque<int>();
+    auto taken = std::vector<std::atomic_int>(item_count);
+    auto done = std::atomic_bool{false};
+    auto thieves = std::vector<std::jthread>{};
+    for(int t = 0; t < 3; ++t)
+    {
+      thieves.emplace_back(
+        [&]
+        {
+          while(!done)
+          {
+            if(const auto item = deque.steal())
+            {
+              ++taken[*item];
+            }
+          }
+        }
+      );
+    }
+    for(int i = 0; i < item_count; ++i)
+    {
+      deque.push(i);
+      if(i % 3 == 0)
+      {
+        if(const auto item = deque.pop())
+        {
+          ++taken[*item];
+        }
+      }
+    }
+    while(const auto item = deque.pop())
+    {
+      ++taken[*item];
+    }
+    done = true;
+    thieves.clear();
+    CHECK(std::ranges::all_of(taken, [](const auto& count) { return count == 1; }));
+  }
+
+  GIVEN("capacity that is no power of two")
+  {
+    CHECK_THROWS_AS(work_stealing_deque<int>(12), std::invalid_argument);
+  }
+}
+
+} // namespace bibstd::app_framework
@@ -0,0 +1,78 @@
+#include <bible/reference_range.hpp>
+
+#include <catch2/catch_all.hpp>
+
+namespace bibstd::bible
+{
+
+TEST_CASE("reference_ordinal", "[bible]")
+{
+  const auto genesis_1_1 = reference::create(book_id::genesis, 1u, 1u).value();
+  const auto genesis_2_1 = reference::create(book_id::genesis, 2u, 1u).value();
+  const auto exodus_1_1 = reference::create(book_id::exodus, 1u, 1u).value();
+  const auto revelation_22_21 = reference::create(book_id::revelation, 22u, 21u).value();
+
+  // compile time versification
+  static_assert(chapter_count(book_id::psalms) == 150);
+  static_assert(verse_count(book_id::psalms, 119u) == 176u);
+  static_assert(!verse_count(book_id::john3, 2u));
+  static_assert(reference::create(book_id::john, 3u, 16u).has_value());
+  static_assert(!reference::create(book_id::genesis, 1u, 32u).has_value());
+  static_assert(reference::from_ordinal(total_verse_count - 1)->book() == book_id::revelation);
+
+  CHECK(genesis_1_1.ordinal() == 0);
+  CHECK(genesis_2_1.ordinal() == 31);
+  CHECK(exodus_1_1.ordinal() == 1533);
+  CHECK(revelation_22_21.ordinal() == total_verse_count - 1);
+  CHECK_FALSE(verse_ordinal(book_id::genesis, 1u, 32u));
+  CHECK_FALSE(verse_ordinal(book_id::genesis, 51u, 1u));
+  CHECK_FALSE(reference::from_ordinal(total_verse_count));
+
+  GIVEN("every verse of the bible")
+  {
+    auto ref = genesis_1_1;
+    auto matches = true;
+    for(std::uint32_t ordinal = 0; ordinal < total_verse_count; ++ordinal, ++ref)
+    {
+      matches = matches && ref.ordinal() == ordinal && reference::from_ordinal(ordinal) == ref;
+    }
+    CHECK(matches);
+  }
+
+  GIVEN("packed references")
+  {
+    static_assert(sizeof(reference) == 4);
+    CHECK(exodus_1_1.packed() == (1u << 16 | 1u << 8 | 1u));
+    CHECK(reference::from_packed(exodus_1_1.packed()) == exodus_1_1);
+    CHECK_FALSE(reference::from_packed(1u << 16 | 41u << 8 | 1u));
+    CHECK_FALSE(reference::from_packed(66u << 16 | 1u << 8 | 1u));
+    CHECK(genesis_1_1 < genesis_2_1);
+    CHECK(genesis_2_1 < exodus_1_1);
+    CHECK(std::hash<reference>{}(genesis_1_1) != std::hash<reference>{}(genesis_2_1));
+    auto ref = exodus_1_1;
+    CHECK(--ref == reference::create(book_id::genesis, 50u, 26u).value());
+    CHECK(++ref == exodus_1_1);
+    ref = genesis_2_1;
+    CHECK(--ref == reference::create(book_id::genesis, 1u, 31u).value());
+  }
+
+  GIVEN("reference ranges")
+  {
+    CHECK(reference_range(genesis_1_1).size() == 1);
+    CHECK(reference_range(genesis_1_1, genesis_2_1).size() == 32);
+    CHECK(reference_range(genesis_2_1, genesis_1_1).size() == 32);
+    CHECK(reference_range(genesis_1_1, revelation_22_21).size() == total_verse_count);
+  }
+
+  GIVEN("advance and distance")
+  {
+    CHECK(genesis_1_1.advance(31) == genesis_2_1);
+    CHECK(genesis_2_1.advance(-31) == genesis_1_1);
+    CHECK(genesis_1_1.advance(-1) == genesis_1_1);
+    CHECK(genesis_1_1.advance(total_verse_count) == revelation_22_21);
+    CHECK(distance(genesis_1_1, exodus_1_1) == 1533);
+    CHECK(distance(exodus_1_1, genesis_1_1) == -1533);
+  }
+}
+
+} // namespace bibstd::bible
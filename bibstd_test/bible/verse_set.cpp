@@ -0,0 +1,70 @@
+#include <bible/verse_set.hpp>
+
+#include <catch2/catch_all.hpp>
+
+namespace bibstd::bible
+{
+
+TEST_CASE("verse_set", "[bible]")
+{
+  const auto ref = [](const book_id book, const std::uint32_t chapter, const std::uint32_t verse)
+  { return reference::create(book, chapter, verse).value(); };
+  const auto genesis_1_1 = ref(book_id::genesis, 1, 1);
+  const auto genesis_1_31 = ref(book_id::genesis, 1, 31);
+  const auto genesis_2_5 = ref(book_id::genesis, 2, 5);
+  const auto john_3_16 = ref(book_id::john, 3, 16);
+  const auto revelation_22_21 = ref(book_id::revelation, 22, 21);
+
+  auto first = verse_set{};
+  CHECK(first.empty());
+  first.insert(reference_range(genesis_1_1, genesis_2_5));
+  first.insert(john_3_16);
+  CHECK(first.size() == 37);
+  CHECK(first.contains(genesis_1_31));
+  CHECK_FALSE(first.contains(ref(book_id::genesis, 2, 6)));
+
+  auto second = verse_set{};
+  second.insert(reference_range(genesis_1_31, revelation_22_21));
+  CHECK(second.size() == total_verse_count - 30);
+  CHECK(second.contains(revelation_22_21));
+
+  GIVEN("set operations")
+  {
+    const auto intersection = first & second;
+    CHECK(intersection.size() == 7);
+    CHECK(intersection.ranges().size() == 2);
+    CHECK((intersection.ranges().front() == reference_range(genesis_1_31, genesis_2_5)));
+
+    const auto difference = first - second;
+    CHECK((difference.ranges() == std::vector{reference_range(genesis_1_1, ref(book_id::genesis, 1, 30))}));
+
+    const auto all = first | second;
+    CHECK(all.size() == total_verse_count);
+    CHECK((all.ranges() == std::vector{reference_range(genesis_1_1, revelation_22_21)}));
+  }
+
+  GIVEN("ranges and iteration")
+  {
+    const auto ranges = first.ranges();
+    CHECK(verse_set(ranges) == first);
+    auto count = std::uint32_t{0};
+    auto previous = std::optional<reference>{};
+    first.for_each(
+      [&](const reference& verse)
+      {
+        CHECK((!previous || *previous < verse));
+        previous = verse;
+        ++count;
+      }
+    );
+    CHECK(count == first.size());
+    CHECK(previous == john_3_16);
+
+    first.erase(reference_range(genesis_1_1, genesis_2_5));
+    first.erase(john_3_16);
+    CHECK(first.empty());
+    CHECK(first.ranges().empty());
+  }
+}
+
+} // namespace bibstd::bible
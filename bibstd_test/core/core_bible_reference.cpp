@@ -49,6 +49,45 @@ TEST_CASE("reference_parser", "[bible]")
     CHECK(util::contains(result, exodus_4_5));
     CHECK(util::contains(result, exodus_5_6to7_8));
   }
+  {
+    const auto john_3_16 = bible::reference_range(bible::reference::create(bible::book_id::john, 3u, 16u).value());
+    const auto result = core.parse(std::string{"Johannes 3,16"}, 0).ranges;
+    CHECK(result.size() == 1);
+    CHECK(util::contains(result, john_3_16));
+  }
+  {
+    const auto john1_3_16 = bible::reference_range(bible::reference::create(bible::book_id::john1, 3u, 16u).value());
+    const auto result = core.parse(std::string{"1.Johannes 3,16"}, 0).ranges;
+    CHECK(result.size() == 1);
+    CHECK(util::contains(result, john1_3_16));
+  }
+}
+
+TEST_CASE("reference_scan", "[bible]")
+{
+  core_bible_reference core;
+  const auto genesis_1_1 = bible::reference_range(bible::reference::create(bible::book_id::genesis, 1u, 1u).value());
+  const auto john_3_16 = bible::reference_range(bible::reference::create(bible::book_id::john, 3u, 16u).value());
+  const auto john1_3_16 = bible::reference_range(bible::reference::create(bible::book_id::john1, 3u, 16u).value());
+
+  CHECK(core.scan("Lorem ipsum dolor sit").empty());
+  {
+    const auto text = std::string{"Siehe 1.Mose 1:1, Johannes 3,16 und 1.Johannes 3,16."};
+    const auto result = core.scan(text);
+    REQUIRE(result.size() == 3);
+    CHECK(result.at(0).ranges.size() == 1);
+    CHECK(util::contains(result.at(0).ranges, genesis_1_1));
+    CHECK(result.at(1).ranges.size() == 1);
+    CHECK(util::contains(result.at(1).ranges, john_3_16));
+    CHECK(result.at(2).ranges.size() == 1);
+    CHECK(util::contains(result.at(2).ranges, john1_3_16));
+    for(const auto& r : result)
+    {
+      const auto index = r.index_range_origin.begin;
+      CHECK(core.parse(text, index).index_range_origin == r.index_range_origin);
+    }
+    CHECK(text.substr(result.at(2).index_range_origin.begin, 12) == "1.Johannes 3");
+  }
 }
 
 } // namespace bibstd::core
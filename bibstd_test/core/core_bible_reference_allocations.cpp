@@ -0,0 +1,78 @@
+#include <core/core_bible_reference.hpp>
+
+#include <catch2/catch_all.hpp>
+
+#include <array>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+namespace
+{
+
+// Only the allocations of the test thread are counted while the flag is set, other threads may allocate meanwhile.
+thread_local bool count_allocations{false};
+thread_local std::size_t allocation_count{0};
+
+} // namespace
+
+auto operator new(const std::size_t size) -> void*
+{
+  if(count_allocations)
+  {
+    ++allocation_count;
+  }
+  if(auto* ptr = std::malloc(size == 0 ? 1 : size))
+  {
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+
+auto operator delete(void* ptr) noexcept -> void
+{
+  std::free(ptr);
+}
+
+auto operator delete(void* ptr, [[maybe_unused]] const std::size_t size) noexcept -> void
+{
+  std::free(ptr);
+}
+
+namespace bibstd::core
+{
+
+TEST_CASE("reference_parser_allocations", "[bible]")
+{
+  core_bible_reference core;
+  auto scratch = core_bible_reference::parse_scratch{};
+  const auto texts = std::array{
+    std::string{"Lorem ipsum dolor sit"},
+    std::string{"Siehe 1.Mose 1:1 und Johannes 3,16."},
+    std::string{"2.Mose 2,2-3.7;4,5;5,6-7,8"},
+    std::string{"1.Johannes 3,16 und Offenbarung 1"},
+  };
+  const auto parse_all = [&]()
+  {
+    auto count = std::size_t{0};
+    for(const auto& text : texts)
+    {
+      for(std::size_t index = 0; index < text.size(); ++index)
+      {
+        count += core.parse(text, index, scratch).ranges.size();
+      }
+    }
+    return count;
+  };
+
+  const auto warm_up_count = parse_all();
+  allocation_count = 0;
+  count_allocations = true;
+  const auto count = parse_all();
+  count_allocations = false;
+  CHECK(count == warm_up_count);
+  CHECK(count > 0);
+  CHECK(allocation_count == 0);
+}
+
+} // namespace bibstd::core
@@ -0,0 +1,179 @@
+#include <core/core_bible_reference_ocr.hpp>
+#include <core/core_ocr_page.hpp>
+
+#include <catch2/catch_all.hpp>
+
+#include <algorithm>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace bibstd::core
+{
+
+TEST_CASE("core_bible_reference_ocr is_reference_cut_off", "[core]")
+{
+  using screen_rect_type = core_bible_reference_ocr::screen_rect_type;
+  const auto area = screen_rect_type({0, 0}, 100, 20);
+  const auto recognition = [&](const bool lines_above_skipped, const bool lines_below_skipped)
+  { return core_bible_reference_ocr::cursor_lines_recognition{area, area, lines_above_skipped, lines_below_skipped}; };
+  const auto position_data = [](std::string text)
+  { return core_bible_reference_ocr::reference_position_data{std::move(text), {}, 0}; };
+  const auto is_cut_off = [&](const auto& recognition, const std::string& text, const std::size_t begin, const std::size_t end)
+  { return core_bible_reference_ocr::is_reference_cut_off(recognition, position_data(text), {begin, end}); };
+
+  GIVEN("no skipped lines")
+  {
+    CHECK_FALSE(is_cut_off(recognition(false, false), "Joh3,16", 0, 7));
+    CHECK_FALSE(is_cut_off(recognition(false, false), "Joh3,16-", 0, 7));
+  }
+
+  GIVEN("lines below skipped")
+  {
+    CHECK(is_cut_off(recognition(false, true), "siehJoh3,16", 4, 11));
+    CHECK_FALSE(is_cut_off(recognition(false, true), "Joh3,16und", 0, 7));
+    CHECK_FALSE(is_cut_off(recognition(true, false), "siehJoh3,16", 4, 11));
+  }
+
+  GIVEN("range followed by transition chars only")
+  {
+    CHECK(is_cut_off(recognition(false, true), "Joh3,16-", 0, 7));
+    CHECK(is_cut_off(recognition(false, true), "Joh3,", 0, 4));
+    CHECK(is_cut_off(recognition(false, true), "Joh3,16;.", 0, 7));
+    CHECK_FALSE(is_cut_off(recognition(false, true), "Joh3,16-a", 0, 7));
+    CHECK_FALSE(is_cut_off(recognition(true, false), "siehJoh3,16-", 4, 11));
+  }
+
+  GIVEN("lines above skipped")
+  {
+    CHECK(is_cut_off(recognition(true, false), "Joh3,16und", 0, 7));
+    CHECK_FALSE(is_cut_off(recognition(true, false), "siehJoh3,16", 4, 11));
+    CHECK_FALSE(is_cut_off(recognition(false, true), "Joh3,16und", 0, 7));
+  }
+
+  GIVEN("empty range")
+  {
+    CHECK_FALSE(is_cut_off(recognition(true, true), "Joh3,16", 0, 0));
+    CHECK_FALSE(is_cut_off(recognition(true, true), "Joh3,16", 7, 7));
+  }
+}
+
+TEST_CASE("core_bible_reference_ocr select_cursor_lines", "[core]")
+{
+  using screen_rect_type = core_bible_reference_ocr::screen_rect_type;
+  // Five lines of height 16 with a gap of 4 between them, the paragraph is wider than its lines.
+  auto paragraph = core_tesseract_common::layout_paragraph{screen_rect_type({0, 0}, 200, 100), {}};
+  for(std::int32_t y = 0; y < 100; y += 20)
+  {
+    paragraph.line_bounding_boxes.emplace_back(screen_rect_type({10, y}, 180, 16));
+  }
+  const auto select = [&](const std::int32_t y, const std::size_t context_lines)
+  { return core_bible_reference_ocr::select_cursor_lines(paragraph, {50, y}, context_lines); };
+
+  GIVEN("cursor line only")
+  {
+    const auto result = select(45, 0);
+    CHECK(result.paragraph_bounding_box == paragraph.bounding_box);
+    CHECK(result.recognized_area == screen_rect_type({0, 40}, 200, 16));
+    CHECK(result.lines_above_skipped);
+    CHECK(result.lines_below_skipped);
+  }
+
+  GIVEN("context lines")
+  {
+    const auto result = select(45, 1);
+    CHECK(result.recognized_area == screen_rect_type({0, 20}, 200, 56));
+    CHECK(result.lines_above_skipped);
+    CHECK(result.lines_below_skipped);
+  }
+
+  GIVEN("context lines beyond the paragraph")
+  {
+    const auto first = select(5, 1);
+    CHECK(first.recognized_area == screen_rect_type({0, 0}, 200, 36));
+    CHECK_FALSE(first.lines_above_skipped);
+    CHECK(first.lines_below_skipped);
+    const auto last = select(85, 2);
+    CHECK(last.recognized_area == screen_rect_type({0, 40}, 200, 56));
+    CHECK(last.lines_above_skipped);
+    CHECK_FALSE(last.lines_below_skipped);
+    const auto all = select(45, 5);
+    CHECK(all.recognized_area == screen_rect_type({0, 0}, 200, 96));
+    CHECK_FALSE(all.lines_above_skipped);
+    CHECK_FALSE(all.lines_below_skipped);
+  }
+
+  GIVEN("cursor between lines")
+  {
+    // The gap between the second and the third line is from 36 to 40, the closer line is taken.
+    CHECK(select(37, 0).recognized_area == screen_rect_type({0, 20}, 200, 16));
+    CHECK(select(39, 0).recognized_area == screen_rect_type({0, 40}, 200, 16));
+  }
+
+  GIVEN("cursor outside of the lines")
+  {
+    CHECK(select(150, 0).recognized_area == screen_rect_type({0, 80}, 200, 16));
+  }
+}
+
+TEST_CASE("core_bible_reference_ocr match_choices_to_bible_book", "[core]")
+{
+  // Every char of the text is a symbol with the confidence 90, alternative choices are added to some symbols.
+  const auto create_page = [](const std::string_view text, const std::vector<std::pair<std::size_t, std::string_view>>& choices)
+  {
+    const auto box = core_ocr_page::screen_rect_type({0, 0}, 10, 20);
+    auto page = core_ocr_page{};
+    page.begin_element(core_ocr_page::text_resolution::word, box, 90.0f);
+    for(std::size_t i = 0; i < text.size(); ++i)
+    {
+      page.add_symbol(text.substr(i, 1), box, 90.0f);
+      std::ranges::for_each(
+        choices | std::views::filter([&](const auto& e) { return e.first == i; }),
+        [&](const auto& e) { page.add_choice(e.second, 60.0f - static_cast<float>(i)); }
+      );
+    }
+    return page;
+  };
+  const auto match = [](const core_ocr_page& page, const std::size_t max_results)
+  { return core_bible_reference_ocr::match_choices_to_bible_book(page.choice_arena(), max_results); };
+
+  GIVEN("a book name in the choices")
+  {
+    const auto page = create_page("siehJeh3", {{5, "o"}});
+    const auto results = match(page, 5);
+    REQUIRE(results.size() == 1);
+    CHECK(results.front().joined_string() == "siehJoh3");
+    CHECK(results.front().size() == 8);
+    CHECK(results.front().overlay().size() == 1);
+  }
+
+  GIVEN("book names sorted by summed confidence")
+  {
+    // "Jos" is a prefix of "Josua" and reads the same text, so it is returned once.
+    const auto page = create_page("Jesua", {{1, "o"}, {3, "a"}});
+    const auto results = match(page, 5);
+    REQUIRE(results.size() == 2);
+    CHECK(results.at(0).joined_string() == "Josua");
+    CHECK(results.at(1).joined_string() == "Jesua");
+    CHECK(match(page, 1).size() == 1);
+  }
+
+  GIVEN("a full stop within the book name")
+  {
+    const auto page = create_page("1.Mo3", {});
+    const auto results = match(page, 5);
+    REQUIRE(results.size() == 1);
+    CHECK(results.front().joined_string() == "1.Mo3");
+    CHECK(results.front().overlay().empty());
+  }
+
+  GIVEN("no book name")
+  {
+    CHECK(match(create_page("abc", {{1, "x"}}), 5).empty());
+    CHECK(match(core_ocr_page{}, 5).empty());
+  }
+}
+
+} // namespace bibstd::core
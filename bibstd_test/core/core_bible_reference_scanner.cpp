@@ -0,0 +1,49 @@
+#include <core/core_bible_reference_scanner.hpp>
+
+#include <catch2/catch_all.hpp>
+
+#include <string>
+#include <vector>
+
+namespace bibstd::core
+{
+
+TEST_CASE("reference_scanner", "[bible]")
+{
+  using parse_result = core_bible_reference::parse_result;
+  const auto filler_text = std::string{"Lorem ipsum dolor sit amet, consetetur sadipscing elitr. Über Ähnliches wird "};
+  auto text = std::string{};
+  for(auto i = 0; i < 40; ++i)
+  {
+    text += filler_text;
+    text += (i % 2 == 0) ? "1.Johannes 3,16 " : "Johannes 3,16; ";
+  }
+  const auto expected = core_bible_reference{}.scan(text);
+  REQUIRE(expected.size() == 40);
+
+  const auto scan_chunked = [&](const std::size_t chunk_size)
+  {
+    auto results = std::vector<parse_result>{};
+    auto scanner = core_bible_reference_scanner([&](const parse_result& result) { results.push_back(result); }, 600);
+    for(std::size_t pos = 0; pos < text.size(); pos += chunk_size)
+    {
+      scanner.feed(std::string_view{text}.substr(pos, chunk_size));
+    }
+    scanner.finish();
+    return results;
+  };
+
+  for(const auto chunk_size : {std::size_t{1}, std::size_t{7}, std::size_t{599}, std::size_t{100'000}})
+  {
+    const auto results = scan_chunked(chunk_size);
+    REQUIRE(results.size() == expected.size());
+    for(std::size_t i = 0; i < results.size(); ++i)
+    {
+      CHECK(results.at(i).index_range_origin == expected.at(i).index_range_origin);
+      CHECK((results.at(i).ranges == expected.at(i).ranges));
+    }
+  }
+  CHECK_THROWS(core_bible_reference_scanner([](const parse_result&) {}, core_bible_reference_scanner::max_reference_size));
+}
+
+} // namespace bibstd::core
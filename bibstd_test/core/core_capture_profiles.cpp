@@ -0,0 +1,56 @@
+#include <core/core_capture_profiles.hpp>
+
+#include <catch2/catch_all.hpp>
+
+#include <stdexcept>
+
+namespace bibstd::core
+{
+
+TEST_CASE("core_capture_profiles", "[core]")
+{
+  using profile = core_capture_profiles::profile;
+
+  GIVEN("stored entries")
+  {
+    const auto profiles = core_capture_profiles(
+      {"AcroRd32.exe|24|900|200", "firefox.exe|16|576|128", "Class|Name|12|432|96", "invalid", "edge.exe|0|10|10",
+       "word.exe|x|10|10", "firefox.exe|40|720|160", "|12|10|10"},
+      3
+    );
+    CHECK(profiles.size() == 3);
+    CHECK(profiles.find("AcroRd32.exe") == profile{24, 900, 200});
+    CHECK(profiles.find("firefox.exe") == profile{16, 576, 128});
+    CHECK(profiles.find("Class|Name") == profile{12, 432, 96});
+    CHECK_FALSE(profiles.find("edge.exe"));
+    CHECK(
+      profiles.entries() ==
+      std::vector<std::string>{"AcroRd32.exe|24|900|200", "firefox.exe|16|576|128", "Class|Name|12|432|96"}
+    );
+  }
+
+  GIVEN("recorded profiles")
+  {
+    auto profiles = core_capture_profiles({}, 2);
+    CHECK_FALSE(profiles.find("a.exe"));
+    profiles.record("a.exe", {20, 720, 160});
+    profiles.record("b.exe", {30, 1080, 240});
+    CHECK(profiles.entries() == std::vector<std::string>{"b.exe|30|1080|240", "a.exe|20|720|160"});
+
+    // Updating a profile makes it the most recently used one, so the other profile is dropped first.
+    profiles.record("a.exe", {22, 800, 180});
+    CHECK(profiles.entries() == std::vector<std::string>{"a.exe|22|800|180", "b.exe|30|1080|240"});
+    profiles.record("c.exe", {14, 500, 100});
+    CHECK(profiles.size() == 2);
+    CHECK_FALSE(profiles.find("b.exe"));
+    CHECK(profiles.find("a.exe") == profile{22, 800, 180});
+    CHECK(core_capture_profiles(profiles.entries(), 2).entries() == profiles.entries());
+  }
+
+  GIVEN("zero capacity")
+  {
+    CHECK_THROWS_AS(core_capture_profiles({}, 0), std::invalid_argument);
+  }
+}
+
+} // namespace bibstd::core
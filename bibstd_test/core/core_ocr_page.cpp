@@ -0,0 +1,122 @@
+#include <core/core_ocr_page.hpp>
+
+#include <catch2/catch_all.hpp>
+
+namespace bibstd::core
+{
+
+TEST_CASE("core_ocr_page", "[core]")
+{
+  using text_resolution = core_ocr_page::text_resolution;
+  using screen_rect_type = core_ocr_page::screen_rect_type;
+  const auto box = [](const std::int32_t x) { return screen_rect_type({x, 0}, 10, 20); };
+
+  auto page = core_ocr_page{};
+  CHECK(page.empty());
+  page.begin_element(text_resolution::paragraph, box(0), 90.0f);
+  page.begin_element(text_resolution::line, box(0), 90.0f);
+  page.begin_element(text_resolution::word, box(0), 90.0f);
+  page.add_symbol("J", box(0), 95.0f);
+  page.add_choice("T", 0.2f);
+  page.add_symbol("o", box(10), 90.0f);
+  page.add_symbol("h", box(20), 90.0f);
+  page.add_symbol("n", box(30), 90.0f);
+  page.begin_element(text_resolution::word, box(50), 80.0f);
+  page.add_symbol("3", box(50), 80.0f);
+  page.begin_element(text_resolution::line, box(0), 70.0f);
+  page.begin_element(text_resolution::word, box(0), 70.0f);
+  page.add_symbol("ü", box(0), 70.0f);
+  page.add_choice("u", 0.5f);
+  page.add_choice("ö", 99.0f);
+
+  CHECK_FALSE(page.empty());
+  CHECK(page.text() == "John3ü");
+  CHECK(page.elements(text_resolution::character).size() == 6);
+  CHECK(page.elements(text_resolution::word).size() == 3);
+  CHECK(page.elements(text_resolution::line).size() == 2);
+  CHECK(page.elements(text_resolution::paragraph).size() == 1);
+
+  CHECK(page.text(text_resolution::word, 0) == "John");
+  CHECK(page.text(text_resolution::word, 1) == "3");
+  CHECK(page.text(text_resolution::line, 0) == "John3");
+  CHECK(page.text(text_resolution::line, 1) == "ü");
+  CHECK(page.text(text_resolution::paragraph, 0) == "John3ü");
+  CHECK(page.text(text_resolution::character, 5) == "ü");
+
+  CHECK(page.elements(text_resolution::character).parents[4] == 1);
+  CHECK(page.elements(text_resolution::character).parents[5] == 2);
+  CHECK(page.elements(text_resolution::word).parents[2] == 1);
+  CHECK(page.elements(text_resolution::line).parents[1] == 0);
+  CHECK(page.elements(text_resolution::paragraph).parents[0] == core_ocr_page::no_parent);
+
+  GIVEN("mean confidence")
+  {
+    CHECK(page.mean_confidence(text_resolution::paragraph) == Approx(90.0));
+    CHECK(page.mean_confidence(text_resolution::line) == Approx(80.0));
+    CHECK(page.mean_confidence(text_resolution::character) == Approx(515.0 / 6.0));
+    CHECK(page.mean_confidence(text_resolution::character, screen_rect_type({0, 0}, 45, 20)) == Approx(435.0 / 5.0));
+    CHECK(page.mean_confidence(text_resolution::character, screen_rect_type({45, 0}, 20, 20)) == Approx(80.0));
+    CHECK(page.mean_confidence(text_resolution::character, screen_rect_type({100, 0}, 20, 20)) == 0.0);
+    page.clear();
+    CHECK(page.mean_confidence(text_resolution::character) == 0.0);
+  }
+
+  GIVEN("symbol choices sorted by confidence")
+  {
+    const auto first = page.symbol_choices(0);
+    REQUIRE(core_ocr_page::index_range_type::size(first) == 2);
+    CHECK(page.choice_text(first.begin) == "J");
+    CHECK(page.choice_text(first.begin + 1) == "T");
+    const auto single = page.symbol_choices(1);
+    REQUIRE(core_ocr_page::index_range_type::size(single) == 1);
+    CHECK(page.choice_text(single.begin) == "o");
+    const auto last = page.symbol_choices(5);
+    REQUIRE(core_ocr_page::index_range_type::size(last) == 3);
+    CHECK(page.choice_text(last.begin) == "ö");
+    CHECK(page.choice_text(last.begin + 1) == "ü");
+    CHECK(page.choice_text(last.begin + 2) == "u");
+    CHECK(page.choices().confidences[last.begin] == 99.0f);
+  }
+
+  GIVEN("choice arena")
+  {
+    const auto& arena = page.choice_arena();
+    CHECK(arena.size() == 6);
+    CHECK(arena.choices.size() == 9);
+    const auto first = arena.symbol_choices(0);
+    REQUIRE(first.size() == 2);
+    CHECK(first[0].symbol == "J");
+    CHECK(first[1].symbol == "T");
+    CHECK(first[1].confidence == 0.2f);
+    CHECK(arena.symbol_choices(1).size() == 1);
+    const auto last = arena.symbol_choices(5);
+    REQUIRE(last.size() == 3);
+    CHECK(last[0].symbol == "ö");
+    CHECK(last[2].symbol == "u");
+    CHECK(&page.choice_arena() == &arena);
+    CHECK(page.choice_arena().choices.data() == arena.choices.data());
+  }
+
+  GIVEN("choice arena after modification")
+  {
+    CHECK(page.choice_arena().size() == 6);
+    page.add_symbol("5", box(60), 90.0f);
+    page.add_choice("S", 10.0f);
+    CHECK(page.choice_arena().size() == 7);
+    CHECK(page.choice_arena().symbol_choices(6).size() == 2);
+    page.clear();
+    CHECK(page.choice_arena().size() == 0);
+    CHECK(page.choice_arena().choices.empty());
+  }
+
+  GIVEN("clear")
+  {
+    page.clear();
+    CHECK(page.empty());
+    CHECK(page.text().empty());
+    CHECK(page.elements(text_resolution::line).size() == 0);
+    CHECK(page.choices().size() == 0);
+  }
+}
+
+} // namespace bibstd::core
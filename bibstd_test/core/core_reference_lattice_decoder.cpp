@@ -0,0 +1,161 @@
+#include <core/core_bible_reference.hpp>
+#include <core/core_ocr_page.hpp>
+#include <core/core_reference_lattice_decoder.hpp>
+
+#include <catch2/catch_all.hpp>
+
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+namespace bibstd::core
+{
+
+namespace
+{
+
+using decode_result = core_reference_lattice_decoder::decode_result;
+using alternatives_type = std::map<std::size_t, std::vector<std::pair<std::string_view, float>>>;
+
+///
+/// Create a page of a text where every char is a symbol, with alternative choices for some symbols.
+///
+auto create_page(const std::string& text, const alternatives_type& alternatives = {}) -> core_ocr_page
+{
+  using text_resolution = core_ocr_page::text_resolution;
+  const auto box = core_ocr_page::screen_rect_type({0, 0}, 10, 20);
+  auto page = core_ocr_page{};
+  page.begin_element(text_resolution::paragraph, box, 90.0f);
+  page.begin_element(text_resolution::line, box, 90.0f);
+  page.begin_element(text_resolution::word, box, 90.0f);
+  for(std::size_t i = 0; i < text.size(); ++i)
+  {
+    page.add_symbol(std::string_view(text).substr(i, 1), box, 90.0f);
+    if(const auto iter = alternatives.find(i); iter != alternatives.cend())
+    {
+      std::ranges::for_each(iter->second, [&](const auto& choice) { page.add_choice(choice.first, choice.second); });
+    }
+  }
+  return page;
+}
+
+///
+/// Check if the decoded reference has the reference ranges of the parsed text.
+///
+auto parses_as(const decode_result& result, const std::string_view text, const std::size_t index) -> bool
+{
+  const auto expected = core_bible_reference().parse(text, index).ranges;
+  return !expected.empty() && result.ranges == expected;
+}
+
+} // namespace
+
+TEST_CASE("core_reference_lattice_decoder", "[core]")
+{
+  using index_range_type = core_reference_lattice_decoder::index_range_type;
+  const auto decoder = core_reference_lattice_decoder();
+
+  GIVEN("reference in the main symbols")
+  {
+    const auto results = decoder.decode(create_page("sieheJoh3,16-18und").choice_arena(), 6, 3);
+    REQUIRE(results.size() == 1);
+    CHECK(parses_as(results.front(), "Joh3,16-18", 0));
+    CHECK(results.front().symbol_range == index_range_type{5, 15});
+    CHECK(std::ranges::all_of(results.front().choice_indices, [](const auto c) { return c == 0; }));
+    CHECK(results.front().confidence == Approx(90.0));
+  }
+
+  GIVEN("book name and transition char in alternative choices")
+  {
+    const auto page = create_page("sieheJch3716", {{6, {{"o", 40.0f}}}, {9, {{",", 40.0f}}}});
+    const auto results = decoder.decode(page.choice_arena(), 6, 3);
+    REQUIRE(results.size() == 1);
+    CHECK(parses_as(results.front(), "Joh3,16", 0));
+    CHECK(results.front().symbol_range == index_range_type{5, 12});
+    CHECK(results.front().choice_indices == std::vector<std::uint32_t>{0, 1, 0, 0, 1, 0, 0});
+  }
+
+  GIVEN("reference not containing the symbol")
+  {
+    const auto page = create_page("Joh3siehe");
+    const auto& choice_arena = page.choice_arena();
+    CHECK(decoder.decode(choice_arena, 2, 3).size() == 1);
+    CHECK(decoder.decode(choice_arena, 5, 3).empty());
+  }
+
+  GIVEN("empty alternative choices")
+  {
+    const auto page = create_page("Joh3,16", {{1, {{"", 40.0f}}}, {4, {{"", 40.0f}}}});
+    const auto results = decoder.decode(page.choice_arena(), 0, 3);
+    REQUIRE(results.size() == 1);
+    CHECK(parses_as(results.front(), "Joh3,16", 0));
+    CHECK(std::ranges::all_of(results.front().choice_indices, [](const auto c) { return c == 0; }));
+  }
+
+  GIVEN("passage rejected by the grammar")
+  {
+    CHECK(decoder.decode(create_page("Joh99").choice_arena(), 0, 3).empty());
+  }
+
+  GIVEN("number postfix")
+  {
+    const auto results = decoder.decode(create_page("Joh3,16ff.x").choice_arena(), 0, 3);
+    REQUIRE(results.size() == 1);
+    CHECK(parses_as(results.front(), "Joh3,16ff.", 0));
+    CHECK(results.front().symbol_range == index_range_type{0, 10});
+    CHECK(results.front().confidence == Approx(90.0 * core_reference_lattice_decoder::postfix_prior));
+  }
+
+  GIVEN("nested book names resolved like the parser")
+  {
+    const auto results = decoder.decode(create_page("1Joh3").choice_arena(), 2, 3);
+    REQUIRE(results.size() == 1);
+    CHECK(parses_as(results.front(), "1Joh3", 2));
+    CHECK(results.front().symbol_range == index_range_type{0, 5});
+  }
+
+  GIVEN("references ranked by confidence")
+  {
+    const auto page = create_page("Jes3", {{1, {{"o", 60.0f}}}});
+    const auto& choice_arena = page.choice_arena();
+    const auto results = decoder.decode(choice_arena, 0, 3);
+    REQUIRE(results.size() == 2);
+    CHECK(parses_as(results.at(0), "Jes3", 0));
+    CHECK(parses_as(results.at(1), "Jos3", 0));
+    CHECK(results.at(1).confidence == Approx((90.0 + 60.0 + 90.0 + 90.0) / 4.0));
+    CHECK(decoder.decode(choice_arena, 0, 1).size() == 1);
+    const auto narrow_results = core_reference_lattice_decoder(1).decode(choice_arena, 0, 3);
+    REQUIRE(narrow_results.size() == 1);
+    CHECK(parses_as(narrow_results.front(), "Jes3", 0));
+  }
+
+  GIVEN("zero beam width")
+  {
+    CHECK_THROWS_AS(core_reference_lattice_decoder(0), std::invalid_argument);
+  }
+}
+
+TEST_CASE("core_reference_lattice_decoder benchmark", "[.][benchmark]")
+{
+  // A paragraph of 2000 symbols with references and three alternatives for every symbol.
+  auto text = std::string{};
+  while(text.size() < 2000)
+  {
+    text += "undessiehtsoausalswaereesinJoh3,16geschrieben";
+  }
+  auto alternatives = alternatives_type{};
+  for(std::size_t i = 0; i < text.size(); ++i)
+  {
+    alternatives[i] = {{"o", 30.0f}, {"1", 20.0f}, {",", 10.0f}};
+  }
+  const auto page = create_page(text, alternatives);
+  const auto decoder = core_reference_lattice_decoder();
+  const auto symbol_index = text.find("Joh", text.size() / 2);
+  BENCHMARK("decode 2000 symbols")
+  {
+    return decoder.decode(page.choice_arena(), symbol_index, 3);
+  };
+}
+
+} // namespace bibstd::core
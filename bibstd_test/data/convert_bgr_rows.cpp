@@ -0,0 +1,143 @@
+#include <data/convert_bgr_rows.hpp>
+#include <util/enum.hpp>
+
+#include <catch2/catch_all.hpp>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace bibstd::data
+{
+
+namespace
+{
+
+///
+/// Create synthetic BGR rows with a pattern that differs in every channel.
+///
+auto create_rows(
+  const std::uint32_t width, const std::uint32_t height, const std::uint16_t bytes_per_pixel, const std::size_t padding
+) -> std::vector<std::byte>
+{
+  const auto pitch = static_cast<std::size_t>(width) * bytes_per_pixel + padding;
+  auto bytes = std::vector<std::byte>(pitch * height);
+  for(std::size_t i = 0; i < bytes.size(); ++i)
+  {
+    bytes[i] = static_cast<std::byte>((i * 37 + i / 7) & 0xff);
+  }
+  return bytes;
+}
+
+} // namespace
+
+TEST_CASE("convert_bgr_rows", "[data]")
+{
+  const auto bytes = std::vector<std::byte>{
+    std::byte{1}, std::byte{2}, std::byte{3}, std::byte{4}, std::byte{5}, std::byte{6}, std::byte{0}, std::byte{0},
+    std::byte{7}, std::byte{8}, std::byte{9}, std::byte{10}, std::byte{11}, std::byte{12}, std::byte{0}, std::byte{0},
+  };
+  auto pixels = plane<pixel>{};
+
+  convert_bgr_rows(bgr_rows{.data = bytes.data(), .width = 2, .height = 2, .pitch = 8, .bytes_per_pixel = 3}, pixels);
+  CHECK(pixels.width == 2);
+  CHECK(pixels.height == 2);
+  CHECK(pixels.data[0] == pixel{.red = 3, .green = 2, .blue = 1});
+  CHECK(pixels.data[1] == pixel{.red = 6, .green = 5, .blue = 4});
+  CHECK(pixels.data[2] == pixel{.red = 9, .green = 8, .blue = 7});
+
+  convert_bgr_rows(
+    bgr_rows{.data = bytes.data(), .width = 2, .height = 2, .pitch = 8, .bytes_per_pixel = 4, .bottom_up = true}, pixels
+  );
+  CHECK(pixels.data[0] == pixel{.red = 9, .green = 8, .blue = 7});
+  CHECK(pixels.data[1] == pixel{.red = 0, .green = 12, .blue = 11});
+  CHECK(pixels.data[3] == pixel{.red = 0, .green = 6, .blue = 5});
+
+  CHECK_THROWS_AS(
+    convert_bgr_rows(bgr_rows{.data = bytes.data(), .width = 3, .height = 2, .pitch = 8}, pixels), std::invalid_argument
+  );
+  CHECK_THROWS_AS(
+    convert_bgr_rows(bgr_rows{.data = bytes.data(), .width = 2, .height = 2, .pitch = 8, .bytes_per_pixel = 2}, pixels),
+    std::invalid_argument
+  );
+}
+
+TEST_CASE("convert_bgr_rows kernels", "[data]")
+{
+  const auto bytes_per_pixel = GENERATE(std::uint16_t{3}, std::uint16_t{4});
+  const auto width = GENERATE(1u, 9u, 10u, 37u, 300u);
+  const auto padding = GENERATE(std::size_t{0}, std::size_t{3});
+  const auto height = 5u;
+  const auto bytes = create_rows(width, height, bytes_per_pixel, padding);
+  const auto source = bgr_rows{
+    .data = bytes.data(),
+    .width = width,
+    .height = height,
+    .pitch = width * bytes_per_pixel + padding,
+    .bytes_per_pixel = bytes_per_pixel,
+    .bottom_up = true,
+  };
+
+  auto expected_pixels = plane<pixel>{};
+  auto expected_luma = luma_plane{};
+  convert_bgr_rows(source, expected_pixels, bgr_kernel::scalar);
+  convert_to_luma(plane_view<pixel>(expected_pixels), expected_luma);
+  CHECK(expected_pixels.data[0].blue == static_cast<std::uint8_t>(bytes[(height - 1) * source.pitch]));
+
+  for(const auto kernel : {bgr_kernel::scalar, bgr_kernel::sse2, bgr_kernel::avx2})
+  {
+    if(!is_available(kernel))
+    {
+      CHECK_THROWS_AS(convert_bgr_rows(source, expected_pixels, kernel), std::invalid_argument);
+      continue;
+    }
+    auto pixels = plane<pixel>{};
+    auto luma = luma_plane{};
+    convert_bgr_rows(source, pixels, kernel);
+    convert_bgr_rows(source, luma, kernel);
+    CHECK(pixels.data == expected_pixels.data);
+    CHECK(luma.width == width);
+    CHECK(luma.height == height);
+    CHECK(luma.data == expected_luma.data);
+  }
+}
+
+TEST_CASE("convert_bgr_rows benchmark", "[.][benchmark]")
+{
+  constexpr auto width = 3840u;
+  constexpr auto height = 2160u;
+  const auto bytes_per_pixel = GENERATE(std::uint16_t{3}, std::uint16_t{4});
+  const auto pitch = ((width * bytes_per_pixel * 8 + 31) / 32) * 4;
+  const auto bytes = create_rows(width, height, bytes_per_pixel, pitch - width * bytes_per_pixel);
+  const auto source = bgr_rows{
+    .data = bytes.data(),
+    .width = width,
+    .height = height,
+    .pitch = pitch,
+    .bytes_per_pixel = bytes_per_pixel,
+    .bottom_up = true,
+  };
+  auto pixels = plane<pixel>{};
+  auto luma = luma_plane{};
+
+  for(const auto kernel : {bgr_kernel::scalar, bgr_kernel::sse2, bgr_kernel::avx2})
+  {
+    if(!is_available(kernel))
+    {
+      continue;
+    }
+    const auto name = std::to_string(bytes_per_pixel * 8) + " bit " + std::string(util::to_string_view(kernel));
+    BENCHMARK("pixels " + name)
+    {
+      convert_bgr_rows(source, pixels, kernel);
+      return pixels.data.front();
+    };
+    BENCHMARK("luma " + name)
+    {
+      convert_bgr_rows(source, luma, kernel);
+      return luma.data.front();
+    };
+  }
+}
+
+} // namespace bibstd::data
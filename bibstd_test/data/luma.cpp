@@ -0,0 +1,89 @@
+#include <data/luma.hpp>
+
+#include <catch2/catch_all.hpp>
+
+namespace bibstd::data
+{
+
+TEST_CASE("luma", "[data]")
+{
+  // Width 11 covers the vectorized blocks of eight pixels and the remaining pixels.
+  auto pixels = plane<pixel>(11, 3);
+  for(std::size_t i = 0; i < pixels.data.size(); ++i)
+  {
+    pixels.data[i] = pixel{
+      .red = static_cast<std::uint8_t>(i * 37),
+      .green = static_cast<std::uint8_t>(i * 11 + 5),
+      .blue = static_cast<std::uint8_t>(255 - i * 3),
+      .alpha = static_cast<std::uint8_t>(i)
+    };
+  }
+  pixels.data[0] = pixel{.red = 255, .green = 255, .blue = 255, .alpha = 255};
+  pixels.data[1] = pixel{};
+
+  GIVEN("luma conversion")
+  {
+    auto luma = luma_plane{};
+    convert_to_luma(plane_view<pixel>(pixels), luma);
+    REQUIRE(luma.width == 11);
+    REQUIRE(luma.height == 3);
+    CHECK(luma.data[0] == 255);
+    CHECK(luma.data[1] == 0);
+    for(std::size_t i = 0; i < pixels.data.size(); ++i)
+    {
+      const auto& p = pixels.data[i];
+      CHECK(luma.data[i] == ((77 * p.red + 150 * p.green + 29 * p.blue) >> 8));
+    }
+
+    auto section = luma_plane{};
+    convert_to_luma(plane_view<pixel>(pixels, 2, 1, 9, 2), section);
+    REQUIRE(section.width == 9);
+    CHECK(section.data[0] == luma.data[11 + 2]);
+    CHECK(section.data[9 + 8] == luma.data[22 + 10]);
+  }
+
+  GIVEN("polarity and inversion")
+  {
+    auto luma = luma_plane(4, 2);
+    std::ranges::fill(luma.data, 20);
+    luma.data[3] = 230;
+    CHECK(has_dark_background(create_luma_histogram(luma)));
+    invert(luma);
+    CHECK(luma.data[0] == 235);
+    CHECK(luma.data[3] == 25);
+    CHECK_FALSE(has_dark_background(create_luma_histogram(luma)));
+  }
+
+  GIVEN("otsu binarization")
+  {
+    auto luma = luma_plane(10, 1);
+    luma.data = {10, 12, 15, 11, 200, 210, 205, 14, 199, 13};
+    const auto threshold = otsu_threshold(create_luma_histogram(luma));
+    CHECK(threshold >= 15);
+    CHECK(threshold < 199);
+    binarize(luma, threshold);
+    CHECK((luma.data == std::vector<std::uint8_t>{0, 0, 0, 0, 255, 255, 255, 0, 255, 0}));
+  }
+
+  GIVEN("sauvola binarization")
+  {
+    // Dark text stroke on a background with a brightness gradient.
+    auto luma = luma_plane(20, 5);
+    for(std::uint32_t y = 0; y < luma.height; ++y)
+    {
+      for(std::uint32_t x = 0; x < luma.width; ++x)
+      {
+        luma.data[y * luma.width + x] = static_cast<std::uint8_t>(x == 10 ? 30 : 150 + 5 * x);
+      }
+    }
+    binarize_sauvola(luma, 3, 0.34);
+    for(std::uint32_t y = 0; y < luma.height; ++y)
+    {
+      CHECK(luma.data[y * luma.width + 10] == 0);
+      CHECK(luma.data[y * luma.width + 2] == 255);
+      CHECK(luma.data[y * luma.width + 18] == 255);
+    }
+  }
+}
+
+} // namespace bibstd::data
@@ -0,0 +1,60 @@
+#include <data/pix.hpp>
+
+#include <catch2/catch_all.hpp>
+
+#include <memory>
+
+namespace bibstd::data
+{
+
+TEST_CASE("pix_section", "[data]")
+{
+  auto source = std::make_shared<plane<pixel>>(10, 5);
+  for(std::uint32_t y = 0; y < source->height; ++y)
+  {
+    for(std::uint32_t x = 0; x < source->width; ++x)
+    {
+      source->data[static_cast<std::size_t>(y) * source->width + x].red = static_cast<std::uint8_t>(10 * y + x);
+    }
+  }
+
+  SECTION("off-origin section is packed")
+  {
+    auto p = pix();
+    p.update(source, 3, 2, 4, 3);
+    const auto* const leptonica_pix = p.get();
+    CHECK(p.width() == 4);
+    CHECK(p.height() == 3);
+    CHECK(leptonica_pix->w == 4);
+    CHECK(leptonica_pix->h == 3);
+    CHECK(leptonica_pix->wpl == 4);
+    const auto* const pixels = reinterpret_cast<const pixel*>(leptonica_pix->data);
+    CHECK_FALSE((pixels >= source->data.data() && pixels < source->data.data() + source->data.size()));
+    for(std::uint32_t y = 0; y < 3; ++y)
+    {
+      for(std::uint32_t x = 0; x < 4; ++x)
+      {
+        CHECK(pixels[static_cast<std::size_t>(y) * 4 + x].red == 10 * (y + 2) + x + 3);
+      }
+    }
+  }
+
+  SECTION("full width section is referenced in place")
+  {
+    auto p = pix();
+    p.update(source, 0, 2, 10, 3);
+    const auto* const leptonica_pix = p.get();
+    CHECK(leptonica_pix->w == 10);
+    CHECK(leptonica_pix->h == 3);
+    CHECK(leptonica_pix->wpl == 10);
+    CHECK(reinterpret_cast<const pixel*>(leptonica_pix->data) == source->data.data() + 2 * 10);
+  }
+
+  SECTION("section outside of the plane")
+  {
+    auto p = pix();
+    CHECK_THROWS_AS(p.update(source, 7, 2, 4, 3), std::out_of_range);
+  }
+}
+
+} // namespace bibstd::data
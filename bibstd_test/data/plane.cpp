@@ -0,0 +1,33 @@
+#include <data/pixel.hpp>
+#include <data/plane.hpp>
+
+#include <catch2/catch_all.hpp>
+
+namespace bibstd::data
+{
+
+TEST_CASE("plane_view", "[data]")
+{
+  auto source = plane<pixel>(10, 5);
+  source.data[2 * 10 + 3].red = 7;
+  source.data[4 * 10 + 6].green = 9;
+
+  const auto full = plane_view<pixel>(source);
+  CHECK(full.width == 10);
+  CHECK(full.height == 5);
+  CHECK(full.pitch == 10);
+  CHECK(full.data == source.data.data());
+
+  const auto section = plane_view<pixel>(source, 3, 2, 4, 3);
+  CHECK_FALSE(section.empty());
+  CHECK(section.pitch == source.width);
+  CHECK(section.data->red == 7);
+  CHECK(section.row(2)[3].green == 9);
+
+  CHECK(plane_view<pixel>().empty());
+  CHECK(plane_view<pixel>(source, 10, 5, 0, 0).empty());
+  CHECK_THROWS_AS(plane_view<pixel>(source, 7, 2, 4, 3), std::out_of_range);
+  CHECK_THROWS_AS(plane_view<pixel>(source, 3, 3, 4, 3), std::out_of_range);
+}
+
+} // namespace bibstd::data
@@ -0,0 +1,114 @@
+#include <data/text_region.hpp>
+
+#include <catch2/catch_all.hpp>
+
+#include <stdexcept>
+
+namespace bibstd::data
+{
+
+namespace
+{
+
+///
+/// Draw a text line of character blocks with word gaps into a luma plane.
+///
+auto draw_line(
+  luma_plane& luma, const std::uint32_t x_begin, const std::uint32_t x_end, const std::uint32_t y, const std::uint32_t height
+) -> void
+{
+  for(auto row = y; row < y + height; ++row)
+  {
+    for(auto x = x_begin; x < x_end; ++x)
+    {
+      // Characters are 8 pixels wide with a gap of 2 pixels, every sixth character is a space.
+      const auto character = (x - x_begin) / 10;
+      if((x - x_begin) % 10 < 8 && character % 6 != 5)
+      {
+        luma.data[static_cast<std::size_t>(row) * luma.width + x] = 20;
+      }
+    }
+  }
+}
+
+///
+/// Create a page with a paragraph of three lines, a second paragraph below and a second column on the right.
+///
+auto create_page() -> luma_plane
+{
+  auto luma = luma_plane(800, 300);
+  std::ranges::fill(luma.data, 235);
+  for(std::uint32_t line = 0; line < 3; ++line)
+  {
+    draw_line(luma, 40, 400, 20 + line * 30, 16);
+  }
+  draw_line(luma, 40, 300, 170, 16);
+  draw_line(luma, 500, 760, 50, 16);
+  return luma;
+}
+
+} // namespace
+
+TEST_CASE("text_region", "[data]")
+{
+  auto luma = create_page();
+
+  GIVEN("cursor in the second line of the first paragraph")
+  {
+    const auto region = find_text_region(luma, 120, 58, 100);
+    REQUIRE(region);
+    CHECK(region->char_height == 16);
+    CHECK(region->line_pitch == 30);
+    CHECK(region->line_count == 3);
+    CHECK(region->paragraph == text_region::rect_type({40, 20}, 348, 76));
+    CHECK(region->line == text_region::rect_type({40, 50}, 348, 16));
+  }
+
+  GIVEN("light text on dark background")
+  {
+    std::ranges::for_each(luma.data, [](auto& value) { value = static_cast<std::uint8_t>(255 - value); });
+    const auto region = find_text_region(luma, 120, 58, 100, 1);
+    REQUIRE(region);
+    CHECK(region->char_height == 16);
+    CHECK(region->line_count == 3);
+    CHECK(region->paragraph == text_region::rect_type({40, 20}, 348, 76));
+  }
+
+  GIVEN("cursor in the second paragraph and in the second column")
+  {
+    const auto second_paragraph = find_text_region(luma, 100, 176, 100);
+    REQUIRE(second_paragraph);
+    CHECK(second_paragraph->line_count == 1);
+    CHECK(second_paragraph->line_pitch == 16);
+    CHECK(second_paragraph->paragraph.origin().y() == 170);
+    const auto second_column = find_text_region(luma, 600, 55, 100);
+    REQUIRE(second_column);
+    CHECK(second_column->line_count == 1);
+    CHECK(second_column->paragraph.origin().x() == 500);
+  }
+
+  GIVEN("cursor without text")
+  {
+    CHECK_FALSE(find_text_region(luma, 120, 250, 100));
+    CHECK_FALSE(find_text_region(luma, 900, 58, 100));
+    std::ranges::fill(luma.data, 235);
+    CHECK_FALSE(find_text_region(luma, 120, 58, 100));
+    CHECK_THROWS_AS(find_text_region(luma, 120, 58, 100, 0), std::invalid_argument);
+  }
+}
+
+TEST_CASE("text_region benchmark", "[.][benchmark]")
+{
+  auto luma = luma_plane(1920, 480);
+  std::ranges::fill(luma.data, 235);
+  for(std::uint32_t line = 0; line < 15; ++line)
+  {
+    draw_line(luma, 100, 1800, 10 + line * 30, 16);
+  }
+  BENCHMARK("find_text_region 1920x480")
+  {
+    return find_text_region(luma, 960, 240, 400);
+  };
+}
+
+} // namespace bibstd::data
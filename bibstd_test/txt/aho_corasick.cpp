@@ -0,0 +1,70 @@
+#include <txt/aho_corasick.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <vector>
+
+namespace bibstd::txt
+{
+
+TEST_CASE("aho_corasick", "[txt]")
+{
+  static constexpr auto patterns = std::array<std::string_view, 4>{"he", "she", "his", "hers"};
+  static constexpr auto automaton = aho_corasick<patterns.size(), aho_corasick_state_capacity(patterns)>(patterns);
+  using match = decltype(automaton)::match;
+
+  // states
+  static_assert(automaton.size() == 10);
+  static_assert(automaton.pattern(2) == "his");
+  // prefix
+  static_assert(automaton.starts_with_any("hers"));
+  static_assert(automaton.starts_with_any("she sells"));
+  static_assert(!automaton.starts_with_any("ushers"));
+  static_assert(!automaton.starts_with_any(""));
+  // trie
+  static_assert(automaton.state_pattern(automaton.trie_transition(automaton.root, "hers")) == 3);
+  static_assert(automaton.state_pattern(automaton.trie_transition(automaton.trie_transition(automaton.root, "h"), "e")) == 0);
+  static_assert(automaton.has_trie_children(automaton.trie_transition(automaton.root, "he")));
+  static_assert(!automaton.has_trie_children(automaton.trie_transition(automaton.root, "his")));
+  static_assert(automaton.state_pattern(automaton.trie_transition(automaton.root, "hi")) == automaton.no_pattern);
+  static_assert(automaton.trie_transition(automaton.root, "ers") == automaton.no_state);
+  static_assert(automaton.trie_transition(automaton.root, "") == automaton.root);
+
+  GIVEN("text with overlapping patterns")
+  {
+    auto matches = std::vector<match>{};
+    automaton.for_each_match("ushers", [&](const auto& m) { matches.push_back(m); });
+    CHECK(matches.size() == 3);
+    CHECK(matches.at(0) == match{.pattern_index = 1, .begin = 1, .end = 4});
+    CHECK(matches.at(1) == match{.pattern_index = 0, .begin = 2, .end = 4});
+    CHECK(matches.at(2) == match{.pattern_index = 3, .begin = 2, .end = 6});
+  }
+
+  GIVEN("text with nested prefixes")
+  {
+    auto matches = std::vector<match>{};
+    automaton.for_each_prefix_match("hersh", [&](const auto& m) { matches.push_back(m); });
+    CHECK(matches.size() == 2);
+    CHECK(matches.at(0) == match{.pattern_index = 0, .begin = 0, .end = 2});
+    CHECK(matches.at(1) == match{.pattern_index = 3, .begin = 0, .end = 4});
+  }
+
+  GIVEN("text without patterns")
+  {
+    auto count = std::size_t{0};
+    automaton.for_each_match("abcdefg", [&](const auto&) { ++count; });
+    CHECK(count == 0);
+  }
+
+  GIVEN("duplicate and empty patterns")
+  {
+    static constexpr auto duplicates = std::array<std::string_view, 3>{"ab", "", "ab"};
+    static constexpr auto duplicate_automaton =
+      aho_corasick<duplicates.size(), aho_corasick_state_capacity(duplicates)>(duplicates);
+    auto matches = std::vector<std::size_t>{};
+    duplicate_automaton.for_each_match("xab", [&](const auto& m) { matches.push_back(m.pattern_index); });
+    CHECK(matches == std::vector<std::size_t>{2});
+  }
+}
+
+} // namespace bibstd::txt
@@ -0,0 +1,101 @@
+#include <txt/chars.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+#include <vector>
+
+namespace bibstd::txt
+{
+
+TEST_CASE("chars", "[txt]")
+{
+  using category = chars::category;
+  constexpr auto info = [](const std::string_view text, const std::size_t index)
+  {
+    const auto data = chars::char_info(text, index).value();
+    return std::pair{data.char_category, data.char_size};
+  };
+
+  // ascii
+  static_assert(info("a", 0) == std::pair{category::letter, std::size_t{1}});
+  static_assert(info("Z", 0) == std::pair{category::letter, std::size_t{1}});
+  static_assert(info(" ", 0) == std::pair{category::whitespace, std::size_t{1}});
+  static_assert(info("\n", 0) == std::pair{category::whitespace, std::size_t{1}});
+  static_assert(info("-", 0) == std::pair{category::line, std::size_t{1}});
+  static_assert(info(".", 0) == std::pair{category::fullstop, std::size_t{1}});
+  static_assert(info("7", 0) == std::pair{category::digit, std::size_t{1}});
+  static_assert(info(",", 0) == std::pair{category::other, std::size_t{1}});
+  // multibyte
+  static_assert(info("Ä", 0) == std::pair{category::letter, std::size_t{2}});
+  static_assert(info("\xC2\xA0", 0) == std::pair{category::whitespace, std::size_t{2}});
+  static_assert(info("\xE2\x80\x93", 0) == std::pair{category::line, std::size_t{3}});
+  static_assert(info("\xE2\x80\x9E", 0) == std::pair{category::other, std::size_t{3}});
+  static_assert(info("\xF0\x9F\x98\x80", 0) == std::pair{category::other, std::size_t{4}});
+  // invalid and truncated sequences
+  static_assert(info("\xC3", 0) == std::pair{category::other, std::size_t{1}});
+  static_assert(info("\xC0\x80", 0) == std::pair{category::other, std::size_t{1}});
+  static_assert(info("\xED\xA0\x80", 0) == std::pair{category::other, std::size_t{1}});
+  static_assert(info("\x80", 0) == std::pair{category::other, std::size_t{1}});
+  static_assert(!chars::char_info("a", 1));
+  // is_char
+  static_assert(chars::is_char("aÜ", 1, category::letter) == "Ü");
+  static_assert(!chars::is_char("aÜ", 0, category::digit));
+
+  GIVEN("mixed text longer than a SIMD block")
+  {
+    const auto text = std::string{"Siehe 1.Johannes 3,16\xE2\x80\x93" "18 und Römer 12 \xE2\x80\x9E" "Zitat\xE2\x80\x9C ende"};
+    auto chars_found = std::vector<std::pair<std::string_view, category>>{};
+    auto size = std::size_t{0};
+    chars::for_each_char(
+      text,
+      [&](const auto character, const auto pos, const category char_category)
+      {
+        CHECK(pos == size);
+        size += character.size();
+        chars_found.emplace_back(character, char_category);
+      }
+    );
+    CHECK(size == text.size());
+    CHECK(chars_found.at(0) == std::pair{std::string_view{"S"}, category::letter});
+    CHECK(chars_found.at(21) == std::pair{std::string_view{"\xE2\x80\x93"}, category::line});
+    CHECK(chars_found.at(30) == std::pair{std::string_view{"ö"}, category::letter});
+    CHECK(chars_found.at(38) == std::pair{std::string_view{"\xE2\x80\x9E"}, category::other});
+
+    auto count = std::size_t{0};
+    chars::for_each_char_while(text, [&](const auto, const auto, const category c) { return ++count, c != category::digit; });
+    CHECK(count == 7);
+  }
+
+  GIVEN("callback that stops early in a long text")
+  {
+    const auto text = std::string(1000, 'a') + "Ä" + std::string(1000, 'b');
+    for(const auto stop : {std::size_t{1}, std::size_t{16}, std::size_t{17}, std::size_t{1000}, std::size_t{1001}})
+    {
+      auto visited = std::vector<std::size_t>{};
+      chars::for_each_char_while(
+        text,
+        [&](const auto, const auto pos, const category)
+        {
+          visited.push_back(pos);
+          return visited.size() < stop;
+        }
+      );
+      REQUIRE(visited.size() == stop);
+      CHECK(visited.back() == (stop <= 1000 ? stop - 1 : 1000));
+    }
+    auto visited = std::size_t{0};
+    for(std::size_t start = 0; start < text.size(); ++start)
+    {
+      auto call_visited = std::size_t{0};
+      chars::for_each_char_while(
+        std::string_view(text).substr(start), [&](const auto, const auto, const category) { return ++call_visited < 3; }
+      );
+      visited += call_visited;
+    }
+    // Three chars per call, except for the two calls at the end of the text.
+    CHECK(visited == 3 * text.size() - 3);
+  }
+}
+
+} // namespace bibstd::txt
@@ -0,0 +1,70 @@
+#include <txt/indexed_strings.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <stdexcept>
+
+namespace bibstd::txt
+{
+
+TEST_CASE("indexed_strings", "[txt]")
+{
+  auto strings = indexed_strings{};
+  for(const auto string : {"J", "o", "h", "n", "3", "ü"})
+  {
+    strings.append_string(string);
+  }
+  CHECK(strings.size() == 6);
+  CHECK(strings.read_at(5) == "ü");
+  CHECK(strings.joined_string() == "John3ü");
+  CHECK(strings.string_offset(5) == 5);
+  CHECK(strings.string_offset(6) == 7);
+  CHECK(strings.overlay().empty());
+
+  GIVEN("a copy with overwritten strings")
+  {
+    auto copy = strings;
+    copy.overwrite_at(0, "I");
+    copy.overwrite_at(5, "u");
+    copy.overwrite_at(3, "nn");
+    CHECK(copy.read_at(3) == "nn");
+    CHECK(copy.read_at(4) == "3");
+    CHECK(copy.joined_string() == "Iohnn3u");
+    CHECK(copy.string_offset(4) == 5);
+    CHECK(copy.string_offset(6) == 7);
+    REQUIRE(copy.overlay().size() == 3);
+    CHECK(copy.overlay().front().first == 0);
+    CHECK(copy.overlay().back().first == 5);
+    CHECK(copy != strings);
+    // The base is shared, the original strings are kept.
+    CHECK(strings.joined_string() == "John3ü");
+    CHECK(strings.overlay().empty());
+  }
+
+  GIVEN("a string overwritten with its base string")
+  {
+    auto copy = strings;
+    copy.overwrite_at(2, "x");
+    copy.overwrite_at(2, "h");
+    CHECK(copy.overlay().empty());
+    CHECK(copy == strings);
+  }
+
+  GIVEN("a string appended to a copy")
+  {
+    auto copy = strings;
+    copy.overwrite_at(1, "0");
+    copy.append_string("!");
+    CHECK(copy.joined_string() == "J0hn3ü!");
+    CHECK(strings.size() == 6);
+    CHECK(strings.joined_string() == "John3ü");
+  }
+
+  GIVEN("an invalid index")
+  {
+    CHECK_THROWS_AS(strings.overwrite_at(6, "x"), std::out_of_range);
+    CHECK_THROWS_AS(strings.read_at(6), std::out_of_range);
+  }
+}
+
+} // namespace bibstd::txt
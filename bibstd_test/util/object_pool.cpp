@@ -0,0 +1,137 @@
+#include <util/object_pool.hpp>
+
+#include <catch2/catch_all.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+namespace bibstd::util
+{
+
+TEST_CASE("object_pool", "[util]")
+{
+  auto created = 0;
+  auto pool = object_pool<int, int>(
+    [&](const int key)
+    {
+      ++created;
+      return std::make_unique<int>(key * 100 + created);
+    },
+    {.min_count = 1, .max_count = 2}
+  );
+  CHECK(pool.count(1) == 0);
+
+  SECTION("checkout and return")
+  {
+    {
+      const auto lease = pool.checkout(1);
+      REQUIRE(lease);
+      CHECK(*lease == 101);
+      CHECK(lease.key() == 1);
+      CHECK(pool.count(1) == 1);
+      CHECK(pool.idle_count(1) == 0);
+    }
+    CHECK(pool.idle_count(1) == 1);
+    CHECK(*pool.checkout(1) == 101);
+    CHECK(*pool.checkout(2) == 202);
+    CHECK(created == 2);
+  }
+
+  SECTION("grow up to maximum")
+  {
+    auto first = pool.checkout(1);
+    auto second = pool.try_checkout(1);
+    REQUIRE(second);
+    CHECK(**second == 102);
+    CHECK_FALSE(pool.try_checkout(1));
+    first.release();
+    CHECK_FALSE(first);
+    CHECK(pool.idle_count(1) == 1);
+    CHECK(pool.try_checkout(1));
+  }
+
+  SECTION("reserve and trim")
+  {
+    pool.reserve(1, 5);
+    CHECK(pool.count(1) == 2);
+    CHECK(pool.idle_count(1) == 2);
+    pool.trim();
+    CHECK(pool.count(1) == 1);
+    pool.set_limits({.min_count = 0, .max_count = 1});
+    pool.trim();
+    CHECK(pool.count(1) == 0);
+  }
+
+  SECTION("shrink limits")
+  {
+    auto first = pool.checkout(1);
+    auto second = pool.checkout(1);
+    pool.set_limits({.min_count = 1, .max_count = 1});
+    second.release();
+    CHECK(pool.count(1) == 1);
+    CHECK(pool.idle_count(1) == 0);
+    CHECK_THROWS_AS(pool.set_limits({.min_count = 2, .max_count = 1}), std::invalid_argument);
+  }
+
+  SECTION("limits per key")
+  {
+    pool.reserve(1, 2);
+    pool.reserve(2, 2);
+    pool.set_limits(2, {.min_count = 0, .max_count = 1});
+    CHECK(pool.count(2) == 1);
+    CHECK(pool.get_limits(2).max_count == 1);
+    CHECK(pool.get_limits(1).max_count == 2);
+    CHECK(pool.get_limits(3).max_count == 2);
+    const auto lease = pool.checkout(2);
+    CHECK_FALSE(pool.try_checkout(2));
+    pool.set_limits({.min_count = 1, .max_count = 3});
+    CHECK(pool.get_limits(2).max_count == 1);
+    CHECK(pool.try_checkout(1));
+    pool.trim();
+    CHECK(pool.count(1) == 1);
+    CHECK(pool.count(2) == 1);
+    CHECK_THROWS_AS(pool.set_limits(2, {.min_count = 1, .max_count = 0}), std::invalid_argument);
+  }
+
+  SECTION("trim key with minimum zero")
+  {
+    pool.reserve(1, 1);
+    pool.reserve(2, 1);
+    pool.set_limits(2, {.min_count = 0, .max_count = 1});
+    pool.trim();
+    CHECK(pool.count(1) == 1);
+    CHECK(pool.count(2) == 0);
+  }
+
+  SECTION("factory failure")
+  {
+    auto failing_pool = object_pool<int, int>([](const int) -> std::unique_ptr<int> { throw std::runtime_error("init"); }, {});
+    CHECK_THROWS_AS(failing_pool.checkout(1), std::runtime_error);
+    CHECK(failing_pool.count(1) == 0);
+  }
+}
+
+TEST_CASE("object_pool checkout waits for return", "[util]")
+{
+  auto pool = object_pool<int, int>([](const int key) { return std::make_unique<int>(key); }, {.min_count = 1, .max_count = 1});
+  auto lease = pool.checkout(0);
+  auto returned = std::atomic_bool{false};
+  auto returned_before_checkout = false;
+  auto waiting = std::jthread(
+    [&]
+    {
+      const auto second = pool.checkout(0);
+      returned_before_checkout = returned.load();
+    }
+  );
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  returned = true;
+  lease.release();
+  waiting.join();
+  CHECK(returned_before_checkout);
+  CHECK(pool.count(0) == 1);
+}
+
+} // namespace bibstd::util